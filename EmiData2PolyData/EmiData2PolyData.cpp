@@ -11,7 +11,9 @@
  *              http://www.opengeosys.org/LICENSE.txt
  */
 
-#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
 
 // TCLAP
 #include "tclap/CmdLine.h"
@@ -20,56 +22,127 @@
 #include "logog/include/logog.hpp"
 
 // BaseLib
+#include "BaseLib/FileTools.h"
 #include "BaseLib/LogogSimpleFormatter.h"
 
 // FileIO
-#include "FileIO/VtkIO/VtuInterface.h"
-#include "FileIO/CsvInterface.h"
-#include "FileIO/XmlIO/Qt/XmlGmlInterface.h"
+#include "GeoLib/IO/AsciiRasterInterface.h"
+#include "MeshLib/IO/VtkIO/VtuInterface.h"
 
 // GeoLib
-#include "GeoLib/GEOObjects.h"
+#include "GeoLib/Raster.h"
 
 // MeshLib
 #include "MeshLib/Mesh.h"
-#include "MeshLib/Node.h"
-#include "MeshLib/Properties.h"
-#include "MeshLib/PropertyVector.h"
-#include "MeshLib/Elements/Element.h"
 
-#include "MeshGeoToolsLib/GeoMapper.h"
+#include "ToolsLib/MeshSurface.h"
+#include "ToolsLib/ParallelFor.h"
+#include "ToolsLib/PhaseTimer.h"
+#include "ToolsLib/PointSamples.h"
+#include "ToolsLib/RasterSampling.h"
+#include "ToolsLib/VtpWriter.h"
 
-bool getPointsFromFile(std::vector<GeoLib::Point*> &points, std::string csv_base_name, char const& name_specifier, char const& region_specifier)
+/// Surface the EMI points are mapped onto, either a raster or a 2d mesh. The
+/// element locator of a mesh is built once and shared by all EMI data sets.
+struct Dem
 {
-	std::size_t const n_points (points.size());
-	std::string const file_name = csv_base_name + "_" + region_specifier + "_" + name_specifier + ".txt";
-	INFO ("Reading file %s.", file_name.c_str());
-	int e = FileIO::CsvInterface::readPoints(file_name, '\t', points,  1, 2);
+	std::unique_ptr<GeoLib::Raster> raster;
+	std::unique_ptr<MeshLib::Mesh> mesh;
+	std::unique_ptr<ToolsLib::MeshSurface> surface;
+};
 
-	if (e < 0 || points.size() == n_points)
+/// Reads a DEM from a raster file (*.asc, *.grd) or a 2d mesh (*.vtu).
+bool readDem(std::string const& file_name, Dem &dem)
+{
+	if (BaseLib::hasFileExtension("vtu", file_name))
+	{
+		dem.mesh.reset(MeshLib::IO::VtuInterface::readVTUFile(file_name));
+		if (dem.mesh == nullptr)
+		{
+			ERR ("Error reading mesh file.");
+			return false;
+		}
+		if (dem.mesh->getDimension() != 2)
+		{
+			ERR ("This utility can handle only 2d meshes at this point.");
+			return false;
+		}
+		INFO("Surface mesh read: %d nodes, %d elements.", dem.mesh->getNNodes(), dem.mesh->getNElements());
+		dem.surface.reset(new ToolsLib::MeshSurface(*dem.mesh));
+		return true;
+	}
+
+	dem.raster.reset(GeoLib::IO::AsciiRasterInterface::readRaster(file_name));
+	if (dem.raster == nullptr)
 	{
-		ERR ("Error reading CSV-file.");
+		ERR ("Error reading DEM file.");
 		return false;
 	}
 	return true;
 }
 
-void getMeasurements(std::vector<double> &emi, std::string csv_base_name, char const& name_specifier, char const& region_specifier)
+/// Reads the EMI points of all regions for the given specifier. Coordinates
+/// and measurements are taken from the same pass over each file.
+bool readEmiPoints(std::string const& csv_base_name, std::string const& name_specifier,
+                   std::vector<std::string> const& regions, ToolsLib::PointSamples &samples,
+                   ToolsLib::PhaseTimer &timer)
 {
-	std::size_t const n_points (emi.size());
-	std::string const file_name = csv_base_name + "_" + region_specifier + "_" + name_specifier + ".txt";
-	int const e = FileIO::CsvInterface::readColumn(file_name, '\t', emi, 3);
-	std::cout << "Read " << (emi.size()-n_points) << " values from " << file_name << std::endl;
+	for (std::string const& region : regions)
+	{
+		std::string const file_name = csv_base_name + "_" + region + "_" + name_specifier + ".txt";
+		INFO ("Reading file %s.", file_name.c_str());
+		std::size_t const n_points (samples.size());
+		int const e = ToolsLib::readPointSamples(file_name, '\t', 1, 2, {3}, samples);
+		if (e < 0 || samples.size() == n_points)
+		{
+			ERR ("Error reading CSV-file.");
+			return false;
+		}
+		INFO ("Read %d values from %s.", samples.size() - n_points, file_name.c_str());
+		timer.addBytesRead(ToolsLib::getFileSize(file_name));
+	}
+	return true;
 }
 
-void writeMeasurementsToFile(std::vector<double> const& emi, std::string const& base_name , char name_specifier)
+/// Returns the elevation of all points on the DEM. Points that cannot be
+/// mapped (outside of the DEM or no-data) are assigned an elevation of 0.
+/// The points are processed in parallel batches.
+std::vector<double> getElevations(Dem const& dem, ToolsLib::PointSamples const& samples,
+                                  ToolsLib::RasterInterpolation method, unsigned n_threads)
 {
-	std::string const file_name = base_name + "_" + name_specifier + ".txt";
-	std::ofstream out (file_name.c_str(), std::ios::out );
-	std::size_t const n_vals (emi.size());
-	for (std::size_t i=0; i<n_vals; ++i)
-		out << emi[i] << "\n";
-	out.close();
+	std::size_t const n_points (samples.size());
+	std::vector<double> z (n_points, 0.0);
+	std::size_t n_unmapped (0);
+	if (dem.raster != nullptr)
+	{
+		std::vector<double> xy;
+		xy.reserve(2 * n_points);
+		for (std::size_t i=0; i<n_points; ++i)
+		{
+			xy.push_back(samples.x[i]);
+			xy.push_back(samples.y[i]);
+		}
+		ToolsLib::RasterView const view (ToolsLib::makeRasterView(*dem.raster));
+		ToolsLib::parallelFor(n_points, n_threads,
+			[&](std::size_t begin, std::size_t end, unsigned)
+			{
+				ToolsLib::sampleRaster(view, xy.data() + 2*begin, end-begin, z.data() + begin, method);
+			});
+		for (double &value : z)
+		{
+			if (value == view.no_data)
+			{
+				value = 0;
+				n_unmapped++;
+			}
+		}
+	}
+	else if (dem.surface != nullptr)
+		n_unmapped = dem.surface->getElevations(n_points, samples.x.data(), samples.y.data(), z.data(), n_threads);
+
+	if (n_unmapped > 0)
+		WARN ("%d points could not be mapped onto the DEM, their elevation is set to 0.", n_unmapped);
+	return z;
 }
 
 int main (int argc, char* argv[])
@@ -78,12 +151,13 @@ int main (int argc, char* argv[])
 	logog::Cout* logog_cout (new logog::Cout);
 	BaseLib::LogogSimpleFormatter *custom_format (new BaseLib::LogogSimpleFormatter);
 	logog_cout->SetFormatter(*custom_format);
+	ToolsLib::PhaseTimer timer;
 
-	TCLAP::CmdLine cmd("Add EMI data as a scalar cell array to a 2d mesh.", ' ', "0.1");
+	TCLAP::CmdLine cmd("Converts EMI data to VTK PolyData files, one file <output>_<specifier>.vtp per EMI data set.", ' ', "0.1");
 
 	// I/O params
 	TCLAP::ValueArg<std::string> poly_out("o", "polydata-output-file",
-	                                      "the name of the file the data will be written to", true,
+	                                      "the base name of the files the data will be written to", true,
 	                                      "", "file name of polydata file");
 	cmd.add(poly_out);
 	TCLAP::ValueArg<std::string> csv_in("i", "csv-input-file",
@@ -91,76 +165,93 @@ int main (int argc, char* argv[])
 	                                    "", "name of the csv input file");
 	cmd.add(csv_in);
 	TCLAP::ValueArg<std::string> dem_in("s", "DEM-file",
-	                                    "Surface DEM for mapping ERT data", false,
+	                                    "Surface DEM for mapping EMI data, either a raster (*.asc, *.grd) or a 2d mesh (*.vtu)", false,
 	                                    "", "file name of the Surface DEM");
 	cmd.add(dem_in);
+	TCLAP::SwitchArg interpolate_arg("", "interpolate",
+	                                 "Interpolate raster DEM values bilinearly instead of using the value of the cell containing a point.");
+	cmd.add(interpolate_arg);
+	TCLAP::MultiArg<std::string> specifier_arg("", "specifier",
+	                                           "Name specifier of the EMI data set (i.e. the dipole), read from files called <csv>_<region>_<specifier>.txt. Can be given multiple times, default is \'H\' and \'V\'.",
+	                                           false, "specifier of EMI data set");
+	cmd.add(specifier_arg);
+	TCLAP::MultiArg<std::string> region_arg("r", "region",
+	                                        "Region of the survey, the data of all regions is combined. Can be given multiple times, default is \'A\', \'B\' and \'C\'.",
+	                                        false, "region specifier");
+	cmd.add(region_arg);
+	TCLAP::SwitchArg zlib_arg("z", "zlib",
+	                          "Compress the data written to the output files.");
+	cmd.add(zlib_arg);
+	TCLAP::ValueArg<unsigned> threads_arg("p", "threads",
+	                                      "Number of threads used for mapping the points onto the DEM and compressing the output, 0 uses all available cores.",
+	                                      false, 1, "number of threads");
+	cmd.add(threads_arg);
+	TCLAP::ValueArg<std::string> profile_arg("", "profile",
+	                                         "Write wall time, peak memory, I/O volume and throughput of the phases load_dem, parse, project and write to the given JSON file at the end of the run.",
+	                                         false, "", "file name of profile");
+	cmd.add(profile_arg);
 	cmd.parse(argc, argv);
+	unsigned const n_threads (ToolsLib::getNumberOfThreads(threads_arg.getValue()));
+	ToolsLib::VtkAppendedData::Encoding const encoding (zlib_arg.getValue() ?
+		ToolsLib::VtkAppendedData::Encoding::Zlib : ToolsLib::VtkAppendedData::Encoding::Raw);
+	ToolsLib::RasterInterpolation const method (interpolate_arg.getValue() ?
+		ToolsLib::RasterInterpolation::Bilinear : ToolsLib::RasterInterpolation::Nearest);
 
-	MeshLib::Mesh* mesh (nullptr);
+	Dem dem;
 	if (dem_in.isSet())
 	{
-		mesh = FileIO::VtuInterface::readVTUFile(dem_in.getValue());
-		if (mesh == nullptr)
-		{
-			ERR ("Error reading mesh file.");
+		timer.start("load_dem");
+		if (!readDem(dem_in.getValue(), dem))
 			return -2;
-		}
-
-		if (mesh->getDimension() != 2)
-		{
-			ERR ("This utility can handle only 2d meshes at this point.");
-			delete mesh;
-			return -3;
-		}
-		INFO("Surface mesh read: %d nodes, %d elements.", mesh->getNNodes(), mesh->getNElements());
+		timer.addBytesRead(ToolsLib::getFileSize(dem_in.getValue()));
+		timer.stop(dem.mesh ? dem.mesh->getNElements() : 0);
 	}
 
-	GeoLib::GEOObjects geo_objects;
-	FileIO::XmlGmlInterface xml(geo_objects);
-	//std::vector<GeoLib::Polyline*> *lines = new std::vector<GeoLib::Polyline*>;
-	std::array<char, 2> dipol = {{ 'H', 'V' }};
-	std::array<char,3> const regions = {{'A', 'B', 'C'}};
-	for (std::size_t j=0; j<dipol.size(); ++j)
+	std::vector<std::string> dipol (specifier_arg.getValue());
+	if (dipol.empty())
+		dipol = { "H", "V" };
+	std::vector<std::string> regions (region_arg.getValue());
+	if (regions.empty())
+		regions = { "A", "B", "C" };
+
+	int result (0);
+	for (std::string const& specifier : dipol)
 	{
-		std::vector<GeoLib::Point*> *points   = new std::vector<GeoLib::Point*>;
-		for (std::size_t i=0; i<regions.size(); ++i)
+		ToolsLib::PointSamples samples;
+		timer.start("parse");
+		if (!readEmiPoints(csv_in.getValue(), specifier, regions, samples, timer))
 		{
-			//std::size_t const start_idx (points->size());
-			getPointsFromFile(*points, csv_in.getValue(), dipol[j], regions[i]);
-			//std::size_t const end_idx (points->size());
-			//GeoLib::Polyline* line = new GeoLib::Polyline(*points);
-			//for (std::size_t j=start_idx; j<end_idx; ++j)
-			//	line->addPoint(j);
-			//lines->push_back(line);
+			timer.stop();
+			result = -3;
+			continue;
 		}
-		std::string geo_name (std::string("EMI Data ").append(1,dipol[j]));
-		geo_objects.addPointVec(points, geo_name);
-		//geo_objects.addPolylineVec(lines, geo_name);
+		timer.stop(samples.size());
+
+		timer.start("project");
+		std::vector<double> const z (getElevations(dem, samples, method, n_threads));
+		timer.stop(samples.size());
 
-		if (mesh != nullptr)
+		timer.start("write");
+		std::string const output_name = poly_out.getValue() + "_" + specifier + ".vtp";
+		if (!ToolsLib::writePointsVtp(output_name, samples.x, samples.y, z,
+		                              "TM_DD_" + specifier, samples.values, encoding, n_threads))
 		{
-			GeoMapper mapper(geo_objects, geo_name);
-			mapper.mapOnMesh(mesh);
+			timer.stop();
+			ERR ("Error writing file %s.", output_name.c_str());
+			result = -4;
+			continue;
 		}
-		
-		xml.setNameForExport(geo_name);
-		std::string const output_name = poly_out.getValue() + "_" + dipol[j] + ".gml";
-		xml.writeToFile(output_name);
-		
-		std::vector<double> emi;
-		for (std::size_t i=0; i<regions.size(); ++i)
-			getMeasurements(emi, csv_in.getValue(), dipol[j], regions[i]);
-		writeMeasurementsToFile(emi, poly_out.getValue(), dipol[j]);
-		std::for_each(points->begin(), points->end(), std::default_delete<GeoLib::Point>());
-		delete points;
+		timer.addBytesWritten(ToolsLib::getFileSize(output_name));
+		timer.stop(samples.size());
+		INFO ("%d points written to %s.", samples.size(), output_name.c_str());
 	}
-	
-	delete mesh;
+
+	if (profile_arg.isSet())
+		ToolsLib::writeProfile(profile_arg.getValue(), "EmiData2PolyData", timer);
+
 	delete custom_format;
 	delete logog_cout;
 	LOGOG_SHUTDOWN();
 
-	return 0;
+	return result;
 }
-
-
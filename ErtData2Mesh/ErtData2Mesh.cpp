@@ -11,8 +11,15 @@
  *              http://www.opengeosys.org/LICENSE.txt
  */
 
-#include <vector>
 #include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
 
 // TCLAP
 #include "tclap/CmdLine.h"
@@ -21,11 +28,11 @@
 #include "logog/include/logog.hpp"
 
 // BaseLib
+#include "BaseLib/FileTools.h"
 #include "BaseLib/LogogSimpleFormatter.h"
+#include "BaseLib/StringTools.h"
 
 // FileIO
-#include "MeshLib/IO/VtkIO/VtuInterface.h"
-#include "FileIO/CsvInterface.h"
 #include "GeoLib/IO/AsciiRasterInterface.h"
 
 // GeoLib
@@ -38,20 +45,36 @@
 #include "MeshLib/Properties.h"
 #include "MeshLib/PropertyVector.h"
 #include "MeshLib/Elements/Element.h"
-#include "MeshLib/Elements/Quad.h"
 #include "MeshLib/MeshEditing/MeshRevision.h"
 
+#include "ToolsLib/ColumnReader.h"
+#include "ToolsLib/ParallelFor.h"
+#include "ToolsLib/PhaseTimer.h"
+#include "ToolsLib/RasterSampling.h"
+#include "ToolsLib/StructuredGrid.h"
+#include "ToolsLib/TiledRasterCache.h"
+#include "ToolsLib/VtuWriter.h"
 
-std::vector<double> getElevationCorrectionValues(GeoLib::Raster const& dem, std::vector<MeshLib::Node*> &nodes)
+/// Moves the given surface points onto the DEM and returns the applied elevation corrections.
+std::vector<double> getElevationCorrectionValues(ToolsLib::RasterView const& dem, std::vector<std::array<double, 3>> &sfc_points,
+                                                 ToolsLib::RasterInterpolation method)
 {
-	std::size_t const n_sfc_nodes (nodes.size());
-	std::vector<double> elevation_correction;
+	std::size_t const n_sfc_nodes (sfc_points.size());
+	std::vector<double> xy;
+	xy.reserve(2 * n_sfc_nodes);
+	for (std::array<double, 3> const& pnt : sfc_points)
+	{
+		xy.push_back(pnt[0]);
+		xy.push_back(pnt[1]);
+	}
+	std::vector<double> dem_values(n_sfc_nodes);
+	ToolsLib::sampleRaster(dem, xy.data(), n_sfc_nodes, dem_values.data(), method);
+
+	std::vector<double> elevation_correction(n_sfc_nodes);
 	for (std::size_t i=0; i<n_sfc_nodes; ++i)
 	{
-		double a = (*nodes[i])[2];
-		double b = dem.getValueAtPoint(*nodes[i]);
-		elevation_correction.push_back((*nodes[i])[2] - dem.getValueAtPoint(*nodes[i]));
-		(*nodes[i])[2] -= elevation_correction[i];
+		elevation_correction[i] = sfc_points[i][2] - dem_values[i];
+		sfc_points[i][2] -= elevation_correction[i];
 	}
 	return elevation_correction;
 }
@@ -62,12 +85,13 @@ int main (int argc, char* argv[])
 	logog::Cout* logog_cout (new logog::Cout);
 	BaseLib::LogogSimpleFormatter *custom_format (new BaseLib::LogogSimpleFormatter);
 	logog_cout->SetFormatter(*custom_format);
+	ToolsLib::PhaseTimer timer;
 
 	TCLAP::CmdLine cmd("Converts a CSV file containing ERT data to a quad mesh.", ' ', "0.1");
 
 	// I/O params
 	TCLAP::ValueArg<std::string> mesh_out("o", "mesh-output-file",
-	                                      "The name of the new mesh file", true,
+	                                      "The name of the new mesh file (*.vtu or *.vts)", true,
 	                                      "", "file name of output mesh");
 	cmd.add(mesh_out);
 	TCLAP::ValueArg<std::string> csv_in("i", "csv-input-file",
@@ -78,108 +102,219 @@ int main (int argc, char* argv[])
 	                                    "Surface DEM for mapping ERT data", false,
 	                                    "", "file name of the Surface DEM");
 	cmd.add(dem_in);
+	TCLAP::SwitchArg interpolate_arg("", "interpolate",
+	                                 "Interpolate DEM values bilinearly instead of using the value of the cell containing a node.");
+	cmd.add(interpolate_arg);
+	TCLAP::SwitchArg dem_cache_arg("", "dem-cache",
+	                               "Read the DEM via a binary tiled cache (<DEM-file>.tiles) which is created on first use. Subsequent runs only read the part of the DEM covered by the profile. If the cache cannot be created (e.g. the directory of the DEM is not writable) the DEM is read into memory.");
+	cmd.add(dem_cache_arg);
+	std::vector<std::string> vtu_formats (ToolsLib::getVtuFormatNames());
+	TCLAP::ValuesConstraint<std::string> vtu_format_values(vtu_formats);
+	TCLAP::ValueArg<std::string> vtu_format_arg("", "vtu-format",
+	                                            "Format of the output file: 'binary' uses VTK's writer, 'raw' writes uncompressed and 'zlib' compressed appended binary data. For *.vts output 'binary' is written as 'raw'.",
+	                                            false, "binary", &vtu_format_values);
+	cmd.add(vtu_format_arg);
+	TCLAP::ValueArg<unsigned> threads_arg("p", "threads",
+	                                      "Number of threads used for compressing the output, 0 uses all available cores.",
+	                                      false, 1, "number of threads");
+	cmd.add(threads_arg);
+	TCLAP::SwitchArg float32_arg("", "float32",
+	                             "Store and write the data arrays as 32 bit floats.");
+	cmd.add(float32_arg);
+	TCLAP::SwitchArg compact_ids_arg("", "compact-material-ids",
+	                                 "Write MaterialIDs as 8 bit integers if there are at most 256 layers (except for \'binary\' output).");
+	cmd.add(compact_ids_arg);
+	TCLAP::ValueArg<std::string> profile_arg("", "profile",
+	                                         "Write wall time, peak memory, I/O volume and throughput of the phases parse, load_dem, project, build and write to the given JSON file at the end of a successful run.",
+	                                         false, "", "file name of profile");
+	cmd.add(profile_arg);
 	cmd.parse(argc, argv);
+	bool const float32 (float32_arg.getValue());
+	bool const compact_material_ids (compact_ids_arg.getValue());
+	unsigned const n_threads (ToolsLib::getNumberOfThreads(threads_arg.getValue()));
+	ToolsLib::VtuFormat const vtu_format (ToolsLib::getVtuFormat(vtu_format_arg.getValue()));
 
-	std::vector<std::size_t> ids;
-	int const e = FileIO::CsvInterface::readColumn<std::size_t>(csv_in.getValue(), '\t', ids, "x2/m");
-	std::size_t const n_nodes_per_layer (ids.back()+1);
-	std::vector<GeoLib::Point*> points1;
-	std::vector<GeoLib::Point*> points2;
-	int const r1 = FileIO::CsvInterface::readPoints(csv_in.getValue(), '\t', points1, "E1", "N1", "H1");
-	int const r2 = FileIO::CsvInterface::readPoints(csv_in.getValue(), '\t', points2, "E2", "N2", "H2");
-	std::vector<double> z1;
-	std::vector<double> z2;
-	int const c1 = FileIO::CsvInterface::readColumn<double>(csv_in.getValue(), '\t', z1, "z1/m");
-	int const c2 = FileIO::CsvInterface::readColumn<double>(csv_in.getValue(), '\t', z2, "z2/m");
-
-	if (e!= 0 || r1 != 0 || r2 != 0 || c1 != 0 || c2 != 0)
+	std::vector<double> x2, e1, n1, h1, e2, n2, h2, z1, z2;
+	std::vector<double> resistance_values, coverage_values;
+	std::vector<ToolsLib::CsvColumn> const columns {
+		{ "x2/m", &x2, true },
+		{ "E1", &e1, true }, { "N1", &n1, true }, { "H1", &h1, true },
+		{ "E2", &e2, true }, { "N2", &n2, true }, { "H2", &h2, true },
+		{ "z1/m", &z1, true }, { "z2/m", &z2, true },
+		{ "rho/Ohmm ", &resistance_values, false },
+		{ "coverage", &coverage_values, false }
+	};
+	timer.start("parse");
+	int const e = ToolsLib::readColumns(csv_in.getValue(), '\t', columns);
+	if (e != 0 || x2.empty())
 	{
 		ERR("Error reading data from file");
 		return 1;
 	}
-	std::size_t const n_quads (points1.size());
+	timer.addBytesRead(ToolsLib::getFileSize(csv_in.getValue()));
+	timer.stop(x2.size());
+	std::size_t const n_nodes_per_layer (static_cast<std::size_t>(x2.back())+1);
+
+	std::size_t const n_quads (e1.size());
 	for (std::size_t i=1; i<n_quads; ++i)
 	{
-		if ((*points1[i-1])[0] == (*points2[i])[0] ||
-		    (*points1[i-1])[1] == (*points2[i])[1] ||
-		    (*points1[i-1])[2] == (*points2[i])[2])
+		if (e1[i-1] == e2[i] || n1[i-1] == n2[i] || h1[i-1] == h2[i])
 		{
 			ERR ("Error in ERT file.");
 			return 1;
 		}
 	}
 
-	std::vector<MeshLib::Node*> nodes;
-	std::vector<MeshLib::Element*> quads;
-	quads.reserve(n_quads);
-	std::vector<int> materials;
-	materials.reserve(n_quads);
-
-	nodes.push_back(new MeshLib::Node((*points1[0])[0], (*points1[0])[1], (*points1[0])[2] - z1[0], nodes.size() ));
+	// surface nodes of the profile, optionally mapped onto the DEM
+	std::size_t const n_cols (n_nodes_per_layer + 1);
+	std::vector<std::array<double, 3>> sfc_points;
+	sfc_points.reserve(n_cols);
+	sfc_points.push_back({{ e1[0], n1[0], h1[0] - z1[0] }});
 	for (std::size_t i=0; i<n_nodes_per_layer; ++i)
-		nodes.push_back(new MeshLib::Node((*points2[i])[0], (*points2[i])[1], (*points2[i])[2] - z1[i], nodes.size() ));
+		sfc_points.push_back({{ e2[i], n2[i], h2[i] - z1[i] }});
 
-	std::vector<double> elevation_correction (nodes.size(), 0.0);
+	std::vector<double> elevation_correction (n_cols, 0.0);
 	if (dem_in.isSet())
 	{
-		GeoLib::Raster* dem = GeoLib::IO::AsciiRasterInterface::readRaster(dem_in.getValue());
-		elevation_correction = getElevationCorrectionValues(*dem, nodes);
-		delete dem;
+		ToolsLib::RasterInterpolation const method (interpolate_arg.getValue() ?
+			ToolsLib::RasterInterpolation::Bilinear : ToolsLib::RasterInterpolation::Nearest);
+		timer.start("load_dem");
+		std::unique_ptr<ToolsLib::TiledRasterCache> dem_cache;
+		if (dem_cache_arg.getValue())
+		{
+			dem_cache = ToolsLib::TiledRasterCache::open(dem_in.getValue());
+			if (dem_cache == nullptr)
+				WARN ("Could not use a raster cache for %s, reading the DEM into memory.", dem_in.getValue().c_str());
+		}
+		if (dem_cache != nullptr)
+		{
+			std::array<double, 4> bbox = {{ sfc_points[0][0], sfc_points[0][1], sfc_points[0][0], sfc_points[0][1] }};
+			for (std::array<double, 3> const& pnt : sfc_points)
+			{
+				bbox[0] = std::min(bbox[0], pnt[0]);
+				bbox[1] = std::min(bbox[1], pnt[1]);
+				bbox[2] = std::max(bbox[2], pnt[0]);
+				bbox[3] = std::max(bbox[3], pnt[1]);
+			}
+			std::vector<double> window;
+			ToolsLib::RasterView const view (dem_cache->getWindow(bbox[0], bbox[1], bbox[2], bbox[3], window));
+			// only the tiles covering the window are read from the cache
+			timer.addBytesRead(window.size() * sizeof(double));
+			timer.start("project");
+			elevation_correction = getElevationCorrectionValues(view, sfc_points, method);
+		}
+		else
+		{
+			GeoLib::Raster* dem = GeoLib::IO::AsciiRasterInterface::readRaster(dem_in.getValue());
+			if (dem == nullptr)
+			{
+				ERR ("Error reading DEM file.");
+				return 1;
+			}
+			timer.addBytesRead(ToolsLib::getFileSize(dem_in.getValue()));
+			timer.start("project");
+			elevation_correction = getElevationCorrectionValues(ToolsLib::makeRasterView(*dem), sfc_points, method);
+			delete dem;
+		}
+		timer.stop(sfc_points.size());
 	}
+	// row 0 contains the surface nodes, row r>0 the lower boundary of layer r-1
+	timer.start("build");
 	std::size_t const n_layers ((n_quads / n_nodes_per_layer));
-	for (std::size_t mat_id=0; mat_id<n_layers; ++mat_id)
+	auto const node_coords = [&](std::size_t r, std::size_t c) -> std::array<double, 3>
 	{
-		std::size_t const base_idx (mat_id * n_nodes_per_layer);
-		double z = (*points1[base_idx])[2] - elevation_correction[0] - z2[base_idx];
-		nodes.push_back(new MeshLib::Node((*points1[base_idx])[0], (*points1[base_idx])[1], z, nodes.size() ));
-		for (std::size_t i=0; i<n_nodes_per_layer; ++i)
+		if (r == 0)
+			return sfc_points[c];
+		std::size_t const base_idx ((r-1) * n_nodes_per_layer);
+		if (c == 0)
+			return {{ e1[base_idx], n1[base_idx], h1[base_idx] - elevation_correction[0] - z2[base_idx] }};
+		std::size_t const idx (base_idx + c - 1);
+		return {{ e2[idx], n2[idx], h2[idx] - elevation_correction[c] - z2[idx] }};
+	};
+	std::size_t const n_grid_nodes ((n_layers+1) * n_cols);
+	std::vector<double> x, y, z;
+	x.reserve(n_grid_nodes);
+	y.reserve(n_grid_nodes);
+	z.reserve(n_grid_nodes);
+	bool is_vertical (true);
+	for (std::size_t r=0; r<=n_layers; ++r)
+		for (std::size_t c=0; c<n_cols; ++c)
 		{
-			std::size_t const idx (base_idx + i);
-			std::array<MeshLib::Node*, 4> quad_nodes;
-			quad_nodes[0] = nodes[base_idx + mat_id + i];
-			quad_nodes[1] = nodes[nodes.size()-1];
-			z = (*points2[idx])[2] - elevation_correction[i+1] - z2[base_idx+i];
-			nodes.push_back(new MeshLib::Node((*points2[idx])[0], (*points2[idx])[1], z, nodes.size() ));
-			quad_nodes[2] = nodes.back();
-			quad_nodes[3] = nodes[base_idx + mat_id + i+1];
-			quads.push_back(new MeshLib::Quad(quad_nodes));
-			materials.push_back(mat_id);
+			std::array<double, 3> const pnt (node_coords(r, c));
+			x.push_back(pnt[0]);
+			y.push_back(pnt[1]);
+			z.push_back(pnt[2]);
+			is_vertical = is_vertical && pnt[0] == x[c] && pnt[1] == y[c];
 		}
+	// if all columns are vertical the surface coordinates suffice
+	if (is_vertical)
+	{
+		x.resize(n_cols);
+		y.resize(n_cols);
+	}
+	std::unique_ptr<ToolsLib::StructuredGrid> const grid (
+		ToolsLib::StructuredGrid::create(n_layers+1, n_cols, std::move(x), std::move(y), std::move(z)));
+	if (grid == nullptr)
+	{
+		ERR ("Error creating ERT mesh.");
+		return 1;
 	}
 
-	MeshLib::Mesh mesh("ERT Mesh", nodes, quads);
-	
-	boost::optional<std::vector<int>&> mat_prop (mesh.getProperties().createNewPropertyVector<int>("MaterialIDs", MeshLib::MeshItemType::Cell));
-	mat_prop->insert(mat_prop->end(), materials.begin(), materials.end());
-
-	boost::optional<std::vector<double>&> resistance (mesh.getProperties().createNewPropertyVector<double>("Resistance", MeshLib::MeshItemType::Cell));
-	int const errors_res = FileIO::CsvInterface::readColumn<double>(csv_in.getValue(), '\t', *resistance, "rho/Ohmm ");
-	if (errors_res != 0 || resistance->size() != n_quads)
+	if (!grid->addCellData("Resistance", resistance_values, 1, float32))
 		WARN ("Erros reading resistance values.");
-
-	boost::optional<std::vector<double>&> coverage (mesh.getProperties().createNewPropertyVector<double>("Coverage", MeshLib::MeshItemType::Cell));
-	int const errors_cov = FileIO::CsvInterface::readColumn<double>(csv_in.getValue(), '\t', *coverage, "coverage");
-	if (errors_cov != 0 || coverage->size() != n_quads)
+	if (!grid->addCellData("Coverage", coverage_values, 1, float32))
 		WARN ("Erros reading coverage values.");
-	
-	/* TODO writing arrays with tuple size > 1 needs fixing
-	double const max_cov = *std::max_element(coverage->cbegin(), coverage->cend());
-	boost::optional<std::vector<double>&> conduct (mesh.getProperties().createNewPropertyVector<double>("Conductivity", MeshLib::MeshItemType::Cell, 1));
-	if (errors_res == 0 && errors_cov == 0)
+
+	if (resistance_values.size() == n_quads && coverage_values.size() == n_quads)
 	{
+		// conductivity and relative coverage as interleaved tuples, cells
+		// without a valid (non-zero) resistance get NaN as conductivity
+		double const nan (std::numeric_limits<double>::quiet_NaN());
+		double max_cov (0);
+		for (double const cov : coverage_values)
+			if (cov > max_cov)
+				max_cov = cov;
+		if (max_cov <= 0)
+			WARN ("No positive coverage values, coverage is not normalised.");
+		double const cov_scale ((max_cov > 0) ? 1.0 / max_cov : 1.0);
+		std::vector<double> conduct;
+		conduct.reserve(2 * n_quads);
 		for (std::size_t i=0; i<n_quads; ++i)
 		{
-			conduct->push_back(1.0 / (*resistance)[i]);
-			conduct->push_back((*coverage)[i] / max_cov);
+			double const res (resistance_values[i]);
+			conduct.push_back((res != 0 && std::isfinite(res)) ? 1.0 / res : nan);
+			conduct.push_back(coverage_values[i] * cov_scale);
 		}
+		grid->addCellData("Conductivity", std::move(conduct), 2, float32);
 	}
-	*/
-	
+	timer.stop(grid->getNumberOfCells());
+
 	INFO ("Writing result...");
-	MeshLib::IO::VtuInterface vtu(&mesh);
-	vtu.writeToFile(mesh_out.getValue());
+	std::string const& file_name (mesh_out.getValue());
+	if (BaseLib::hasFileExtension("vts", file_name))
+	{
+		timer.start("write");
+		if (!grid->writeVts(file_name, ToolsLib::getEncoding(vtu_format), n_threads, compact_material_ids))
+			return 1;
+	}
+	else
+	{
+		// the unstructured mesh is part of building the grid
+		timer.start("build");
+		std::unique_ptr<MeshLib::Mesh> const mesh (grid->toMesh("ERT Mesh"));
+		timer.start("write");
+		if (!ToolsLib::writeVtu(*mesh, file_name, vtu_format, n_threads, compact_material_ids))
+		{
+			ERR ("Error writing file %s.", file_name.c_str());
+			return 1;
+		}
+	}
+	timer.addBytesWritten(ToolsLib::getFileSize(file_name));
+	timer.stop(grid->getNumberOfCells());
+
+	if (profile_arg.isSet())
+		ToolsLib::writeProfile(profile_arg.getValue(), "ErtData2Mesh", timer);
 
-	//delete mesh;
 	delete custom_format;
 	delete logog_cout;
 	LOGOG_SHUTDOWN();
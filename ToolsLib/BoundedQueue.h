@@ -0,0 +1,84 @@
+/**
+ * @file   BoundedQueue.h
+ * @author Karsten Rink
+ * @date   2026/10/14
+ * @brief  Blocking queue with limited capacity for producer/consumer pipelines
+ *
+ * @copyright
+ * Copyright (c) 2012-2026, OpenGeoSys Community (http://www.opengeosys.org)
+ *            Distributed under a Modified BSD License.
+ *              See accompanying file LICENSE.txt or
+ *              http://www.opengeosys.org/LICENSE.txt
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+
+namespace ToolsLib
+{
+
+/**
+ * A thread-safe FIFO queue holding at most a given number of items. Producers
+ * block while the queue is full, consumers block while it is empty. Closing
+ * the queue releases all waiting threads; items already queued can still be
+ * taken out afterwards.
+ */
+template <typename T>
+class BoundedQueue
+{
+public:
+	explicit BoundedQueue(std::size_t capacity)
+		: _capacity(std::max<std::size_t>(capacity, 1))
+	{}
+
+	/// Adds an item, blocks while the queue is full.
+	/// @return false if the queue has been closed, the item is dropped then.
+	bool push(T item)
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+		_not_full.wait(lock, [this]() { return _closed || _items.size() < _capacity; });
+		if (_closed)
+			return false;
+		_items.push_back(std::move(item));
+		_not_empty.notify_one();
+		return true;
+	}
+
+	/// Takes the oldest item, blocks while the queue is empty.
+	/// @return false if the queue has been closed and no item is left.
+	bool pop(T &item)
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+		_not_empty.wait(lock, [this]() { return _closed || !_items.empty(); });
+		if (_items.empty())
+			return false;
+		item = std::move(_items.front());
+		_items.pop_front();
+		_not_full.notify_one();
+		return true;
+	}
+
+	/// Signals that no more items will be added.
+	void close()
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_closed = true;
+		_not_full.notify_all();
+		_not_empty.notify_all();
+	}
+
+private:
+	std::size_t const _capacity;
+	bool _closed = false;
+	std::deque<T> _items;
+	std::mutex _mutex;
+	std::condition_variable _not_full;
+	std::condition_variable _not_empty;
+};
+
+} // end namespace ToolsLib
@@ -0,0 +1,248 @@
+/**
+ * @file   BuildingExtrusion.cpp
+ * @author Karsten Rink
+ * @date   2026/10/14
+ * @brief  Extrusion of building footprints read from geometry (*.gml) files
+ *
+ * @copyright
+ * Copyright (c) 2012-2026, OpenGeoSys Community (http://www.opengeosys.org)
+ *            Distributed under a Modified BSD License.
+ *              See accompanying file LICENSE.txt or
+ *              http://www.opengeosys.org/LICENSE.txt
+ */
+
+#include "BuildingExtrusion.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <utility>
+
+// ThirdParty/logog
+#include "logog/include/logog.hpp"
+
+#include "GmlStream.h"
+#include "PhaseTimer.h"
+
+namespace ToolsLib
+{
+
+void ExtrudedPoints::add(std::size_t id, double height)
+{
+	double &h (_heights[id]);
+	if (h == std::numeric_limits<double>::lowest())
+		h = height;
+	else if (h != height)
+	{
+		// candidates for additional copies, the first copy is removed in finalize()
+		_additional.emplace_back(id, h);
+		_additional.emplace_back(id, height);
+		h = std::max(h, height);
+	}
+}
+
+void ExtrudedPoints::finalize(double default_height)
+{
+	for (double &h : _heights)
+		if (h == std::numeric_limits<double>::lowest())
+			h = default_height;
+	std::sort(_additional.begin(), _additional.end());
+	_additional.erase(std::unique(_additional.begin(), _additional.end()), _additional.end());
+	_additional.erase(std::remove_if(_additional.begin(), _additional.end(),
+		[this](std::pair<std::size_t, double> const& copy) { return copy.second == _heights[copy.first]; }),
+		_additional.end());
+}
+
+std::size_t ExtrudedPoints::getIndex(std::size_t id, double height) const
+{
+	if (height == _heights[id])
+		return id;
+	auto const it (std::lower_bound(_additional.begin(), _additional.end(), std::make_pair(id, height)));
+	return _heights.size() + static_cast<std::size_t>(it - _additional.begin());
+}
+
+bool StreamedPoints::mapIds(std::vector<std::size_t> const& file_ids, std::vector<std::size_t> &ids) const
+{
+	ids.clear();
+	for (std::size_t id : file_ids)
+	{
+		if (id >= id_map.size() || id_map[id] == std::numeric_limits<std::size_t>::max())
+			return false;
+		ids.push_back(id_map[id]);
+	}
+	return true;
+}
+
+bool readStreamedPoints(GmlReader const& reader, std::map<std::string, double> const& heights,
+                        double default_height, StreamedPoints &pnts)
+{
+	bool valid_ids (true);
+	std::vector<std::size_t> ids;
+	auto const raise = [&](GmlObject const& object)
+	{
+		if (!pnts.mapIds(object.point_ids, ids))
+		{
+			valid_ids = false;
+			return;
+		}
+		auto const it (heights.find(object.name));
+		double const height ((it == heights.end()) ? default_height : it->second);
+		for (std::size_t id : ids)
+			pnts.extruded.add(id, height);
+	};
+
+	GmlHandler handler;
+	handler.name = [&](std::string const& name) { pnts.geo_name = name; };
+	handler.point = [&](std::size_t id, double x, double y, double z)
+	{
+		if (id >= pnts.id_map.size())
+			pnts.id_map.resize(id + 1, std::numeric_limits<std::size_t>::max());
+		pnts.id_map[id] = pnts.coords.size();
+		pnts.coords.push_back({{ x, y, z }});
+		pnts.extruded.addPoint();
+	};
+	handler.polyline = raise;
+	handler.surface = raise;
+	if (!reader.read(handler))
+		return false;
+	if (!valid_ids)
+	{
+		ERR ("Geometry %s references undefined points.", pnts.geo_name.c_str());
+		return false;
+	}
+	pnts.extruded.finalize(default_height);
+	return true;
+}
+
+bool makeCompactBuildings(std::string const& input_file,
+                          std::map<std::string, double> const& heights, double default_height,
+                          TriangleMesh &mesh, PhaseTimer &timer)
+{
+	timer.start("parse");
+	GmlReader const reader(input_file);
+	StreamedPoints pnts;
+	if (!readStreamedPoints(reader, heights, default_height, pnts))
+		return false;
+	std::size_t const n_pnts (pnts.coords.size());
+	std::size_t const file_size (getFileSize(input_file));
+	timer.addBytesRead(file_size);
+	timer.stop(n_pnts);
+
+	// local index of the bottom (i) and top (n_pnts+i) vertex of point i
+	// within the current building, reset when the building changes
+	std::uint32_t const unused (std::numeric_limits<std::uint32_t>::max());
+	std::vector<std::uint32_t> local (2 * n_pnts, unused);
+	std::vector<std::size_t> used;
+	// vertices of named buildings, restored if a roof follows later
+	std::map<std::uint32_t, std::vector<std::pair<std::size_t, std::uint32_t>>> named_vertices;
+	std::uint32_t current (unused);
+	bool is_current_named (false);
+	// top vertices are created at the height of the building they belong to
+	std::vector<double> building_heights;
+	double current_height (default_height);
+
+	mesh = TriangleMesh();
+	bool too_large (false);
+	auto const getVertex = [&](std::size_t id, bool top) -> std::uint32_t
+	{
+		std::size_t const key (top ? id + n_pnts : id);
+		if (local[key] == unused)
+		{
+			std::size_t const n_vertices (mesh.getNumberOfPoints());
+			if (n_vertices >= unused)
+				too_large = true;
+			local[key] = static_cast<std::uint32_t>(n_vertices);
+			used.push_back(key);
+			std::array<double, 3> const& pnt (pnts.coords[id]);
+			mesh.points.insert(mesh.points.end(), { pnt[0], pnt[1], pnt[2] + (top ? current_height : 0.0) });
+		}
+		return local[key];
+	};
+	auto const addTriangle = [&](std::uint32_t a, std::uint32_t b, std::uint32_t c, std::uint32_t building)
+	{
+		mesh.triangles.insert(mesh.triangles.end(), { a, b, c });
+		mesh.object_ids.push_back(building);
+	};
+	auto const selectBuilding = [&](std::uint32_t building, bool is_named)
+	{
+		if (building == current)
+			return;
+		if (is_current_named)
+		{
+			std::vector<std::pair<std::size_t, std::uint32_t>> &vertices (named_vertices[current]);
+			vertices.clear();
+			for (std::size_t key : used)
+				vertices.emplace_back(key, local[key]);
+		}
+		for (std::size_t key : used)
+			local[key] = unused;
+		used.clear();
+		current = building;
+		is_current_named = is_named;
+		current_height = building_heights[building];
+		auto const it (named_vertices.find(building));
+		if (it == named_vertices.end())
+			return;
+		for (std::pair<std::size_t, std::uint32_t> const& vertex : it->second)
+		{
+			local[vertex.first] = vertex.second;
+			used.push_back(vertex.first);
+		}
+	};
+
+	std::map<std::string, std::uint32_t> building_names;
+	std::uint32_t n_buildings (0);
+	auto const newBuilding = [&](std::string const& name) -> std::uint32_t
+	{
+		auto const it (heights.find(name));
+		building_heights.push_back((it == heights.end()) ? default_height : it->second);
+		return n_buildings++;
+	};
+	std::vector<std::size_t> ids;
+	GmlHandler handler;
+	handler.polyline = [&](GmlObject const& object)
+	{
+		pnts.mapIds(object.point_ids, ids);
+		std::uint32_t const building (newBuilding(object.name));
+		selectBuilding(building, !object.name.empty() &&
+			building_names.insert(std::make_pair(object.name, building)).second);
+		for (std::size_t i=1; i<ids.size(); ++i)
+		{
+			std::uint32_t const a (getVertex(ids[i], false));
+			std::uint32_t const b (getVertex(ids[i-1], false));
+			std::uint32_t const b_top (getVertex(ids[i-1], true));
+			std::uint32_t const a_top (getVertex(ids[i], true));
+			addTriangle(a, b, b_top, building);
+			addTriangle(a, b_top, a_top, building);
+		}
+	};
+	handler.surface = [&](GmlObject const& object)
+	{
+		pnts.mapIds(object.point_ids, ids);
+		auto const it (building_names.find(object.name));
+		bool const is_matched (!object.name.empty() && it != building_names.end());
+		std::uint32_t const building (is_matched ? it->second : newBuilding(object.name));
+		selectBuilding(building, is_matched);
+		for (std::size_t i=0; i+2<ids.size(); i+=3)
+		{
+			std::uint32_t const a (getVertex(ids[i], true));
+			std::uint32_t const b (getVertex(ids[i+1], true));
+			std::uint32_t const c (getVertex(ids[i+2], true));
+			addTriangle(a, b, c, building);
+		}
+	};
+	timer.start("extrude");
+	if (!reader.read(handler))
+		return false;
+	if (too_large)
+	{
+		ERR ("Number of vertices exceeds the range of 32 bit indices.");
+		return false;
+	}
+	timer.addBytesRead(file_size);
+	timer.stop(n_buildings);
+	INFO ("%d buildings with %d vertices and %d triangles.", n_buildings, mesh.getNumberOfPoints(), mesh.getNumberOfTriangles());
+	return true;
+}
+
+} // end namespace ToolsLib
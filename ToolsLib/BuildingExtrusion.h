@@ -0,0 +1,107 @@
+/**
+ * @file   BuildingExtrusion.h
+ * @author Karsten Rink
+ * @date   2026/10/14
+ * @brief  Extrusion of building footprints read from geometry (*.gml) files
+ *
+ * @copyright
+ * Copyright (c) 2012-2026, OpenGeoSys Community (http://www.opengeosys.org)
+ *            Distributed under a Modified BSD License.
+ *              See accompanying file LICENSE.txt or
+ *              http://www.opengeosys.org/LICENSE.txt
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <limits>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "TriangleMesh.h"
+
+namespace ToolsLib
+{
+
+class GmlReader;
+class PhaseTimer;
+
+/**
+ * The extruded copies of the points of a geometry. Each point has one copy at
+ * the largest height of the buildings using it. Buildings with a lower height
+ * get additional copies of their points, shared by all buildings of the same
+ * height, i.e. neighbouring buildings of different heights keep vertical
+ * walls.
+ */
+class ExtrudedPoints
+{
+public:
+	explicit ExtrudedPoints(std::size_t n_pnts = 0)
+		: _heights(n_pnts, std::numeric_limits<double>::lowest())
+	{}
+
+	/// Adds a point not used by any building yet.
+	void addPoint() { _heights.push_back(std::numeric_limits<double>::lowest()); }
+
+	/// Marks point id as used by a building of the given height.
+	void add(std::size_t id, double height);
+
+	/// Assigns the default height to points not used by any building and
+	/// collects the additional copies, called once all buildings are added.
+	void finalize(double default_height);
+
+	std::size_t size() const { return _heights.size(); }
+
+	/// Returns the height of the first copy of point id.
+	double getHeight(std::size_t id) const { return _heights[id]; }
+
+	/// Point indices and heights of the additional copies, sorted by index.
+	std::vector<std::pair<std::size_t, double>> const& getAdditionalCopies() const { return _additional; }
+
+	/// Returns the index of the copy of point id at the height of a building,
+	/// i.e. id for the first copy and size()+k for the k-th additional copy.
+	std::size_t getIndex(std::size_t id, double height) const;
+
+private:
+	std::vector<double> _heights;
+	std::vector<std::pair<std::size_t, double>> _additional;
+};
+
+/// Points of a geometry file with their extruded copies. IDs used in the file
+/// are mapped to point indices.
+struct StreamedPoints
+{
+	std::string geo_name;
+	std::vector<std::array<double, 3>> coords;
+	ExtrudedPoints extruded;
+	std::vector<std::size_t> id_map;
+
+	/// Maps the point IDs of an object, returns false for undefined IDs.
+	bool mapIds(std::vector<std::size_t> const& file_ids, std::vector<std::size_t> &ids) const;
+};
+
+/// Reads the points of a geometry file and computes their extruded copies from
+/// the polylines and surfaces in the same pass. Buildings are looked up by name
+/// in heights, unnamed or unlisted ones get the default height.
+bool readStreamedPoints(GmlReader const& reader, std::map<std::string, double> const& heights,
+                        double default_height, StreamedPoints &pnts);
+
+/**
+ * Creates the buildings of a geometry file as compact triangle mesh. Each
+ * polyline becomes a building consisting of its walls, a surface is the roof
+ * of the building whose polyline has the same name, unnamed or unmatched
+ * surfaces are buildings on their own. Each building is extruded to its own
+ * height, looked up by name in heights (the default height otherwise). Only
+ * the vertices used by a building are stored, shared by all of its
+ * triangles, i.e. a roof shares the top vertices of its walls. Building IDs
+ * are assigned in file order and stored as object IDs of the mesh. The time
+ * is added to the phases "parse" and "extrude" of the timer.
+ */
+bool makeCompactBuildings(std::string const& input_file,
+                          std::map<std::string, double> const& heights, double default_height,
+                          TriangleMesh &mesh, PhaseTimer &timer);
+
+} // end namespace ToolsLib
@@ -0,0 +1,349 @@
+/**
+ * @file   CellAggregation.cpp
+ * @author Karsten Rink
+ * @date   2026/10/14
+ * @brief  Statistics of scattered measurements binned into mesh cells
+ *
+ * @copyright
+ * Copyright (c) 2012-2026, OpenGeoSys Community (http://www.opengeosys.org)
+ *            Distributed under a Modified BSD License.
+ *              See accompanying file LICENSE.txt or
+ *              http://www.opengeosys.org/LICENSE.txt
+ */
+
+#include "CellAggregation.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+#include "ParallelFor.h"
+#include "PointSamples.h"
+
+namespace ToolsLib
+{
+
+namespace
+{
+std::array<char const*, 8> const statistic_names = {{
+	"mean", "idw", "median", "trimmed-mean", "min", "max", "std", "count" }};
+
+/// Distances below this are treated as points located at the cell center.
+double const min_idw_distance (1e-12);
+
+/// Pseudo-random number for the n-th value of a cell (splitmix64).
+std::uint64_t getRandomNumber(std::size_t cell_id, std::size_t n)
+{
+	std::uint64_t z (static_cast<std::uint64_t>(cell_id) * 0x9E3779B97F4A7C15ull + n);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+	return z ^ (z >> 31);
+}
+} // end anonymous namespace
+
+/**
+ * Running statistics of the values of all cells and channels, indexed by
+ * cell * n_channels + channel. Only the arrays needed for the requested
+ * statistics are allocated, e.g. a count and a sum per value for the mean.
+ */
+struct CellAggregator::Storage
+{
+	Storage(std::size_t n_values, AggregationSettings const& settings)
+	: has_sum(settings.needs(Statistic::Mean)),
+	  has_moments(settings.needs(Statistic::Std)),
+	  has_min(settings.needs(Statistic::Min)),
+	  has_max(settings.needs(Statistic::Max)),
+	  has_idw(settings.needsDistances()),
+	  has_sample(settings.needsSample()),
+	  n(n_values, 0)
+	{
+		if (has_sum)
+			sum.assign(n_values, 0);
+		if (has_moments)
+		{
+			mean.assign(n_values, 0);
+			m2.assign(n_values, 0);
+		}
+		if (has_min)
+			min.assign(n_values, std::numeric_limits<double>::max());
+		if (has_max)
+			max.assign(n_values, std::numeric_limits<double>::lowest());
+		if (has_idw)
+		{
+			weight_sum.assign(n_values, 0);
+			weighted_sum.assign(n_values, 0);
+			n_centered.assign(n_values, 0);
+			centered_sum.assign(n_values, 0);
+		}
+		if (has_sample)
+			sample.resize(n_values);
+	}
+
+	void add(std::size_t k, double value, double distance, std::size_t cell_id,
+	         AggregationSettings const& settings, bool use_distance)
+	{
+		std::size_t const n_k (++n[k]);
+		if (has_sum)
+			sum[k] += value;
+		if (has_moments)
+		{
+			// Welford's update for the variance
+			double const delta (value - mean[k]);
+			mean[k] += delta / static_cast<double>(n_k);
+			m2[k] += delta * (value - mean[k]);
+		}
+		if (has_min)
+			min[k] = std::min(min[k], value);
+		if (has_max)
+			max[k] = std::max(max[k], value);
+
+		if (has_idw && use_distance)
+		{
+			if (distance < min_idw_distance)
+			{
+				n_centered[k]++;
+				centered_sum[k] += value;
+			}
+			else
+			{
+				double const weight (1.0 / std::pow(distance, settings.idw_power));
+				weight_sum[k] += weight;
+				weighted_sum[k] += weight * value;
+			}
+		}
+
+		if (!has_sample)
+			return;
+		std::vector<double> &values (sample[k]);
+		if (values.size() < settings.sample_size)
+			values.push_back(value);
+		else
+		{
+			std::size_t const j (getRandomNumber(cell_id, n_k) % n_k);
+			if (j < settings.sample_size)
+				values[j] = value;
+		}
+	}
+
+	static double getMedian(std::vector<double> const& sorted)
+	{
+		std::size_t const m (sorted.size());
+		return (m % 2 == 1) ? sorted[m/2] : 0.5 * (sorted[m/2 - 1] + sorted[m/2]);
+	}
+
+	static double getTrimmedMean(std::vector<double> const& sorted, double trim_fraction)
+	{
+		std::size_t const k (static_cast<std::size_t>(trim_fraction * sorted.size()));
+		if (2 * k >= sorted.size())
+			return getMedian(sorted);
+		double trimmed_sum (0);
+		for (std::size_t i=k; i<sorted.size()-k; ++i)
+			trimmed_sum += sorted[i];
+		return trimmed_sum / static_cast<double>(sorted.size() - 2 * k);
+	}
+
+	double get(std::size_t k, Statistic statistic, std::vector<double> const& sorted,
+	           AggregationSettings const& settings) const
+	{
+		if (statistic == Statistic::Count)
+			return static_cast<double>(n[k]);
+		if (n[k] == 0)
+			return std::numeric_limits<double>::quiet_NaN();
+
+		switch (statistic)
+		{
+		case Statistic::Mean:
+			return sum[k] / static_cast<double>(n[k]);
+		case Statistic::IDW:
+			if (n_centered[k] > 0)
+				return centered_sum[k] / static_cast<double>(n_centered[k]);
+			return weighted_sum[k] / weight_sum[k];
+		case Statistic::Median:
+			return getMedian(sorted);
+		case Statistic::TrimmedMean:
+			return getTrimmedMean(sorted, settings.trim_fraction);
+		case Statistic::Min:
+			return min[k];
+		case Statistic::Max:
+			return max[k];
+		case Statistic::Std:
+			return std::sqrt(m2[k] / static_cast<double>(n[k]));
+		default:
+			return std::numeric_limits<double>::quiet_NaN();
+		}
+	}
+
+	bool const has_sum;
+	bool const has_moments;
+	bool const has_min;
+	bool const has_max;
+	bool const has_idw;
+	bool const has_sample;
+	std::vector<std::size_t> n;
+	std::vector<double> sum;
+	std::vector<double> mean;
+	std::vector<double> m2;
+	std::vector<double> min;
+	std::vector<double> max;
+	std::vector<double> weight_sum;
+	std::vector<double> weighted_sum;
+	std::vector<std::size_t> n_centered;
+	std::vector<double> centered_sum;
+	std::vector<std::vector<double>> sample;
+};
+
+std::vector<std::string> getStatisticNames()
+{
+	return std::vector<std::string>(statistic_names.begin(), statistic_names.end());
+}
+
+bool parseStatistic(std::string const& name, Statistic &statistic)
+{
+	for (std::size_t i=0; i<statistic_names.size(); ++i)
+		if (name == statistic_names[i])
+		{
+			statistic = static_cast<Statistic>(i);
+			return true;
+		}
+	return false;
+}
+
+std::string getStatisticName(Statistic statistic)
+{
+	return statistic_names[static_cast<std::size_t>(statistic)];
+}
+
+bool AggregationSettings::needs(Statistic statistic) const
+{
+	return std::find(statistics.cbegin(), statistics.cend(), statistic) != statistics.cend();
+}
+
+bool AggregationSettings::needsSample() const
+{
+	return needs(Statistic::Median) || needs(Statistic::TrimmedMean);
+}
+
+bool AggregationSettings::needsDistances() const
+{
+	return needs(Statistic::IDW);
+}
+
+std::vector<std::vector<double>> aggregateCellValues(std::size_t n_cells,
+	std::vector<std::size_t> const& cell_ids, std::vector<double> const& distances,
+	PointSamples const& points, AggregationSettings const& settings, unsigned n_threads)
+{
+	CellAggregator aggregator(n_cells, points.n_channels, settings);
+	aggregator.add(cell_ids, distances, points, n_threads);
+	return aggregator.getResults(n_threads);
+}
+
+CellAggregator::CellAggregator(std::size_t n_cells, std::size_t n_channels, AggregationSettings const& settings)
+: _n_cells(n_cells), _n_channels(n_channels), _settings(settings),
+  _storage(new Storage(n_cells * n_channels, settings))
+{}
+
+CellAggregator::~CellAggregator() = default;
+
+void CellAggregator::add(std::vector<std::size_t> const& cell_ids, std::vector<double> const& distances,
+                         PointSamples const& points, unsigned n_threads)
+{
+	std::size_t const n_points (points.size());
+	bool const use_distance (_settings.needsDistances() && distances.size() == n_points);
+	auto const addPoint = [&](std::size_t i)
+	{
+		std::size_t const idx (cell_ids[i]);
+		double const distance (use_distance ? distances[i] : 0);
+		for (std::size_t c=0; c<_n_channels; ++c)
+			_storage->add(idx * _n_channels + c, points.getValue(i, c), distance, idx,
+				_settings, use_distance);
+	};
+
+	// each thread owns a range of cells, partitioned the same way as by parallelFor()
+	std::size_t const n_parts (std::max<std::size_t>(1, std::min<std::size_t>(n_threads, _n_cells)));
+	if (n_parts == 1)
+	{
+		for (std::size_t i=0; i<n_points; ++i)
+			if (cell_ids[i] < _n_cells)
+				addPoint(i);
+		return;
+	}
+	std::size_t const part_size ((_n_cells + n_parts - 1) / n_parts);
+
+	// Counting sort of the point indices by cell range: per-thread histograms,
+	// a prefix sum over ranges and threads and a scatter. Threads scatter
+	// consecutive parts of the input, so points keep their input order within
+	// each range.
+	std::vector<std::size_t> &offsets (_offsets);
+	offsets.assign(n_parts * n_parts, 0);
+	parallelFor(n_points, n_parts,
+		[&](std::size_t begin, std::size_t end, unsigned t)
+		{
+			std::size_t* const counts (&offsets[t * n_parts]);
+			for (std::size_t i=begin; i<end; ++i)
+				if (cell_ids[i] < _n_cells)
+					counts[cell_ids[i] / part_size]++;
+		});
+
+	std::vector<std::size_t> &range_begin (_range_begin);
+	range_begin.resize(n_parts + 1);
+	std::size_t n_inside (0);
+	for (std::size_t r=0; r<n_parts; ++r)
+	{
+		range_begin[r] = n_inside;
+		for (std::size_t t=0; t<n_parts; ++t)
+		{
+			std::size_t const count (offsets[t * n_parts + r]);
+			offsets[t * n_parts + r] = n_inside;
+			n_inside += count;
+		}
+	}
+	range_begin[n_parts] = n_inside;
+
+	std::vector<std::size_t> &order (_order);
+	order.resize(n_inside);
+	parallelFor(n_points, n_parts,
+		[&](std::size_t begin, std::size_t end, unsigned t)
+		{
+			std::size_t* const positions (&offsets[t * n_parts]);
+			for (std::size_t i=begin; i<end; ++i)
+				if (cell_ids[i] < _n_cells)
+					order[positions[cell_ids[i] / part_size]++] = i;
+		});
+
+	parallelFor(_n_cells, n_parts,
+		[&](std::size_t, std::size_t, unsigned r)
+		{
+			for (std::size_t k=range_begin[r]; k<range_begin[r+1]; ++k)
+				addPoint(order[k]);
+		});
+}
+
+std::vector<std::vector<double>> CellAggregator::getResults(unsigned n_threads) const
+{
+	std::size_t const n_stats (_settings.statistics.size());
+	bool const keep_sample (_settings.needsSample());
+
+	std::vector<std::vector<double>> data(_n_channels * n_stats, std::vector<double>(_n_cells));
+	parallelFor(_n_cells, n_threads,
+		[&](std::size_t begin, std::size_t end, unsigned)
+		{
+			std::vector<double> sorted;
+			for (std::size_t j=begin; j<end; ++j)
+				for (std::size_t c=0; c<_n_channels; ++c)
+				{
+					std::size_t const k (j * _n_channels + c);
+					if (keep_sample)
+					{
+						sorted = _storage->sample[k];
+						std::sort(sorted.begin(), sorted.end());
+					}
+					for (std::size_t s=0; s<n_stats; ++s)
+						data[c * n_stats + s][j] = _storage->get(k, _settings.statistics[s], sorted, _settings);
+				}
+		});
+	return data;
+}
+
+} // end namespace ToolsLib
@@ -0,0 +1,123 @@
+/**
+ * @file   CellAggregation.h
+ * @author Karsten Rink
+ * @date   2026/10/14
+ * @brief  Statistics of scattered measurements binned into mesh cells
+ *
+ * @copyright
+ * Copyright (c) 2012-2026, OpenGeoSys Community (http://www.opengeosys.org)
+ *            Distributed under a Modified BSD License.
+ *              See accompanying file LICENSE.txt or
+ *              http://www.opengeosys.org/LICENSE.txt
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ToolsLib
+{
+
+struct PointSamples;
+
+/// Statistics that can be computed from the values within a cell.
+enum class Statistic
+{
+	Mean,        ///< arithmetic mean
+	IDW,         ///< mean weighted by the inverse distance to the cell center
+	Median,      ///< median of a bounded sample of the values
+	TrimmedMean, ///< mean without the smallest and largest values of the sample
+	Min,
+	Max,
+	Std,         ///< population standard deviation
+	Count        ///< number of values
+};
+
+/// Names of all statistics as accepted by parseStatistic().
+std::vector<std::string> getStatisticNames();
+
+/// Returns false if the name does not denote a statistic.
+bool parseStatistic(std::string const& name, Statistic &statistic);
+
+/// Returns the name of the given statistic.
+std::string getStatisticName(Statistic statistic);
+
+struct AggregationSettings
+{
+	std::vector<Statistic> statistics = { Statistic::Mean };
+	/// fraction of the sample dropped at each end for the trimmed mean
+	double trim_fraction = 0.1;
+	/// exponent of the inverse distance weights
+	double idw_power = 2;
+	/// maximum number of values kept per cell for median and trimmed mean
+	std::size_t sample_size = 1024;
+
+	/// Returns true if the statistic is among the requested ones.
+	bool needs(Statistic statistic) const;
+	bool needsSample() const;
+	bool needsDistances() const;
+};
+
+/**
+ * Computes all requested statistics for all channels of the points in a
+ * single pass over the points. cell_ids[i] is the cell containing point i
+ * (any id >= n_cells marks points outside of all cells), distances[i] its
+ * distance to the center of the cell (only needed for IDW).
+ * Median and trimmed mean are computed from a sample of at most
+ * sample_size values per cell and are exact for cells with fewer values.
+ * The sample is drawn by reservoir sampling with a pseudo-random sequence
+ * seeded by the cell id. Each thread owns a range of cells and visits only
+ * the points within its range, in input order, so results do not depend on
+ * the number of threads. Cells without points
+ * are set to NaN (0 for Count).
+ * @return one array per statistic and channel, ordered by channel first.
+ */
+std::vector<std::vector<double>> aggregateCellValues(std::size_t n_cells,
+	std::vector<std::size_t> const& cell_ids, std::vector<double> const& distances,
+	PointSamples const& points, AggregationSettings const& settings, unsigned n_threads);
+
+/**
+ * Running statistics of points binned into cells for data that is processed
+ * in chunks. The memory needed depends on the number of cells and channels
+ * and on the requested statistics (e.g. a count and a sum per cell and
+ * channel for the mean, plus the sample for median and trimmed mean) but not
+ * on the number of points. Adding the points in any number of consecutive chunks gives the
+ * same results as aggregateCellValues() for all points at once.
+ */
+class CellAggregator
+{
+public:
+	CellAggregator(std::size_t n_cells, std::size_t n_channels, AggregationSettings const& settings);
+	~CellAggregator();
+
+	CellAggregator(CellAggregator const&) = delete;
+	CellAggregator& operator=(CellAggregator const&) = delete;
+
+	/// Adds a chunk of points, the arguments are the same as for
+	/// aggregateCellValues(). Chunks have to be added in input order. The
+	/// work per chunk only depends on the size of the chunk.
+	void add(std::vector<std::size_t> const& cell_ids, std::vector<double> const& distances,
+	         PointSamples const& points, unsigned n_threads);
+
+	/// @return one array per statistic and channel, ordered by channel first.
+	std::vector<std::vector<double>> getResults(unsigned n_threads) const;
+
+private:
+	struct Storage;
+
+	std::size_t const _n_cells;
+	std::size_t const _n_channels;
+	AggregationSettings const _settings;
+	std::unique_ptr<Storage> _storage;
+
+	/// Buffers for distributing the points onto the threads, reused by
+	/// consecutive calls of add().
+	std::vector<std::size_t> _offsets;
+	std::vector<std::size_t> _range_begin;
+	std::vector<std::size_t> _order;
+};
+
+} // end namespace ToolsLib
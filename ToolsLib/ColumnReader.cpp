@@ -0,0 +1,133 @@
+/**
+ * @file   ColumnReader.cpp
+ * @author Karsten Rink
+ * @date   2026/10/14
+ * @brief  Implementation of the single pass column reader
+ *
+ * @copyright
+ * Copyright (c) 2012-2026, OpenGeoSys Community (http://www.opengeosys.org)
+ *            Distributed under a Modified BSD License.
+ *              See accompanying file LICENSE.txt or
+ *              http://www.opengeosys.org/LICENSE.txt
+ */
+
+#include "ColumnReader.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <list>
+
+#include "logog/include/logog.hpp"
+
+#include "BaseLib/StringTools.h"
+
+namespace ToolsLib
+{
+
+int readColumns(std::string const& file_name, char delim, std::vector<CsvColumn> const& columns)
+{
+	std::ifstream in(file_name.c_str());
+	if (!in.is_open())
+	{
+		ERR ("readColumns(): Could not open file %s.", file_name.c_str());
+		return -1;
+	}
+
+	std::string line;
+	if (!getline(in, line))
+	{
+		ERR ("readColumns(): File %s is empty.", file_name.c_str());
+		return -1;
+	}
+
+	// maps the index of a field within a row to the requested column
+	std::size_t const not_requested (std::numeric_limits<std::size_t>::max());
+	std::list<std::string> const header (BaseLib::splitString(line, delim));
+	std::vector<std::size_t> field_to_column(header.size(), not_requested);
+	std::vector<bool> is_active(columns.size(), false);
+	std::size_t last_field (0);
+	for (std::size_t i=0; i<columns.size(); ++i)
+	{
+		auto const it = std::find(header.cbegin(), header.cend(), columns[i].name);
+		if (it == header.cend())
+		{
+			if (columns[i].required)
+			{
+				ERR ("Column '%s' not found in file header.", columns[i].name.c_str());
+				return -1;
+			}
+			WARN ("Column '%s' not found in file header.", columns[i].name.c_str());
+			continue;
+		}
+		std::size_t const field_idx (std::distance(header.cbegin(), it));
+		field_to_column[field_idx] = i;
+		is_active[i] = true;
+		last_field = std::max(last_field, field_idx);
+	}
+
+	std::vector<double> row_values(columns.size());
+	std::vector<bool> has_value(columns.size());
+	std::size_t line_count (0);
+	std::size_t error_count (0);
+	while (getline(in, line))
+	{
+		line_count++;
+		std::fill(has_value.begin(), has_value.end(), false);
+		char const* field_begin (line.c_str());
+		char const* const line_end (field_begin + line.size());
+		bool is_valid (true);
+		for (std::size_t field_idx=0; field_idx <= last_field; ++field_idx)
+		{
+			if (field_begin > line_end)
+				break;
+			char const* field_end (field_begin);
+			while (field_end != line_end && *field_end != delim)
+				++field_end;
+
+			std::size_t const column_idx (field_to_column[field_idx]);
+			if (column_idx != not_requested)
+			{
+				char* parse_end (nullptr);
+				double const value (std::strtod(field_begin, &parse_end));
+				if (parse_end != field_begin && parse_end <= field_end)
+				{
+					row_values[column_idx] = value;
+					has_value[column_idx] = true;
+				}
+				else if (columns[column_idx].required)
+				{
+					is_valid = false;
+					break;
+				}
+			}
+			field_begin = field_end + 1;
+		}
+		for (std::size_t i=0; i<columns.size() && is_valid; ++i)
+			if (is_active[i] && !has_value[i] && columns[i].required)
+				is_valid = false;
+
+		if (!is_valid)
+		{
+			ERR ("Error reading values in line %d. Skipping line...", line_count);
+			error_count++;
+			continue;
+		}
+		for (std::size_t i=0; i<columns.size(); ++i)
+		{
+			if (!is_active[i])
+				continue;
+			if (!has_value[i])
+			{
+				WARN ("Invalid value of column '%s' in line %d, set to NaN.", columns[i].name.c_str(), line_count);
+				row_values[i] = std::numeric_limits<double>::quiet_NaN();
+			}
+			columns[i].values->push_back(row_values[i]);
+		}
+	}
+	return error_count;
+}
+
+} // end namespace ToolsLib
@@ -0,0 +1,43 @@
+/**
+ * @file   ColumnReader.h
+ * @author Karsten Rink
+ * @date   2026/10/14
+ * @brief  Single pass reader for named columns of delimiter separated files
+ *
+ * @copyright
+ * Copyright (c) 2012-2026, OpenGeoSys Community (http://www.opengeosys.org)
+ *            Distributed under a Modified BSD License.
+ *              See accompanying file LICENSE.txt or
+ *              http://www.opengeosys.org/LICENSE.txt
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace ToolsLib
+{
+
+/// A column of a file requested by its header name.
+struct CsvColumn
+{
+	std::string name;
+	std::vector<double>* values;
+	bool required;
+};
+
+/**
+ * Reads all requested columns of a delimiter separated file in a single pass.
+ * Header names are mapped to column indices once, afterwards every row is
+ * tokenized exactly once and each requested field is appended to its vector.
+ * Rows with missing or invalid values in a required column are skipped
+ * entirely such that all vectors stay aligned row by row. Missing or invalid
+ * values in optional columns are stored as NaN. Optional columns missing in
+ * the header are left empty.
+ * @return -1 if the file cannot be read or a required column does not
+ * exist, otherwise the number of skipped rows.
+ */
+int readColumns(std::string const& file_name, char delim, std::vector<CsvColumn> const& columns);
+
+} // end namespace ToolsLib
@@ -0,0 +1,221 @@
+/**
+ * @file   ElementGrid.cpp
+ * @author Karsten Rink
+ * @date   2026/10/14
+ * @brief  Uniform bin grid for locating the mesh element containing a point
+ *
+ * @copyright
+ * Copyright (c) 2012-2026, OpenGeoSys Community (http://www.opengeosys.org)
+ *            Distributed under a Modified BSD License.
+ *              See accompanying file LICENSE.txt or
+ *              http://www.opengeosys.org/LICENSE.txt
+ */
+
+#include "ElementGrid.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "MeshLib/Mesh.h"
+#include "MeshLib/Node.h"
+#include "MeshLib/Elements/Element.h"
+
+namespace ToolsLib
+{
+
+std::size_t const ElementGrid::not_found = std::numeric_limits<std::size_t>::max();
+
+ElementGrid::ElementGrid(MeshLib::Mesh const& mesh)
+: _min({{ std::numeric_limits<double>::max(), std::numeric_limits<double>::max() }}),
+  _max({{ std::numeric_limits<double>::lowest(), std::numeric_limits<double>::lowest() }}),
+  _bin_size({{ 1.0, 1.0 }}), _n_bins({{ 1, 1 }})
+{
+	std::vector<MeshLib::Element*> const& elements (mesh.getElements());
+	std::size_t const n_elems (elements.size());
+
+	// flatten element outlines
+	_vertex_offsets.reserve(n_elems + 1);
+	_vertex_offsets.push_back(0);
+	for (MeshLib::Element const* elem : elements)
+	{
+		if (elem->getDimension() == 2)
+		{
+			unsigned const n_base_nodes (elem->getNBaseNodes());
+			for (unsigned j=0; j<n_base_nodes; ++j)
+			{
+				MeshLib::Node const& node (*elem->getNode(j));
+				_vertices.push_back({{ node[0], node[1] }});
+				for (std::size_t d=0; d<2; ++d)
+				{
+					_min[d] = std::min(_min[d], node[d]);
+					_max[d] = std::max(_max[d], node[d]);
+				}
+			}
+		}
+		_vertex_offsets.push_back(_vertices.size());
+	}
+	if (_vertices.empty())
+	{
+		_min = {{ 0, 0 }};
+		_max = {{ 0, 0 }};
+		_bin_offsets.assign(2, 0);
+		return;
+	}
+
+	// aim at roughly one element per bin
+	double const width (std::max(_max[0] - _min[0], std::numeric_limits<double>::epsilon()));
+	double const height (std::max(_max[1] - _min[1], std::numeric_limits<double>::epsilon()));
+	double const bin_edge (std::sqrt(width * height / static_cast<double>(n_elems)));
+	_n_bins[0] = std::max<std::size_t>(1, static_cast<std::size_t>(std::ceil(width / bin_edge)));
+	_n_bins[1] = std::max<std::size_t>(1, static_cast<std::size_t>(std::ceil(height / bin_edge)));
+	_bin_size[0] = width / _n_bins[0];
+	_bin_size[1] = height / _n_bins[1];
+
+	auto const bin_range = [this](std::size_t elem_id, std::array<std::size_t, 2> &lower, std::array<std::size_t, 2> &upper)
+	{
+		std::array<double, 2> elem_min = _vertices[_vertex_offsets[elem_id]];
+		std::array<double, 2> elem_max = elem_min;
+		for (std::size_t k=_vertex_offsets[elem_id]+1; k<_vertex_offsets[elem_id+1]; ++k)
+			for (std::size_t d=0; d<2; ++d)
+			{
+				elem_min[d] = std::min(elem_min[d], _vertices[k][d]);
+				elem_max[d] = std::max(elem_max[d], _vertices[k][d]);
+			}
+		for (std::size_t d=0; d<2; ++d)
+		{
+			lower[d] = std::min(_n_bins[d]-1, static_cast<std::size_t>((elem_min[d] - _min[d]) / _bin_size[d]));
+			upper[d] = std::min(_n_bins[d]-1, static_cast<std::size_t>((elem_max[d] - _min[d]) / _bin_size[d]));
+		}
+	};
+
+	// count elements per bin, then fill bins in order of element IDs
+	std::size_t const n_bins (_n_bins[0] * _n_bins[1]);
+	_bin_offsets.assign(n_bins + 1, 0);
+	std::array<std::size_t, 2> lower, upper;
+	for (std::size_t i=0; i<n_elems; ++i)
+	{
+		if (_vertex_offsets[i] == _vertex_offsets[i+1])
+			continue;
+		bin_range(i, lower, upper);
+		for (std::size_t iy=lower[1]; iy<=upper[1]; ++iy)
+			for (std::size_t ix=lower[0]; ix<=upper[0]; ++ix)
+				_bin_offsets[getBin(ix, iy) + 1]++;
+	}
+	for (std::size_t b=0; b<n_bins; ++b)
+		_bin_offsets[b+1] += _bin_offsets[b];
+
+	_bin_elements.resize(_bin_offsets.back());
+	std::vector<std::size_t> fill_pos(_bin_offsets.cbegin(), _bin_offsets.cend() - 1);
+	for (std::size_t i=0; i<n_elems; ++i)
+	{
+		if (_vertex_offsets[i] == _vertex_offsets[i+1])
+			continue;
+		bin_range(i, lower, upper);
+		for (std::size_t iy=lower[1]; iy<=upper[1]; ++iy)
+			for (std::size_t ix=lower[0]; ix<=upper[0]; ++ix)
+				_bin_elements[fill_pos[getBin(ix, iy)]++] = i;
+	}
+}
+
+std::size_t ElementGrid::findElement(double x, double y) const
+{
+	if (x < _min[0] || x > _max[0] || y < _min[1] || y > _max[1])
+		return not_found;
+
+	auto const getBinOf = [this](double px, double py)
+	{
+		std::size_t const ix (std::min(_n_bins[0]-1, static_cast<std::size_t>((px - _min[0]) / _bin_size[0])));
+		std::size_t const iy (std::min(_n_bins[1]-1, static_cast<std::size_t>((py - _min[1]) / _bin_size[1])));
+		return getBin(ix, iy);
+	};
+	auto const find = [&](double px, double py)
+	{
+		std::size_t const bin (getBinOf(px, py));
+		for (std::size_t k=_bin_offsets[bin]; k<_bin_offsets[bin+1]; ++k)
+			if (isPointInElement(_bin_elements[k], px, py))
+				return _bin_elements[k];
+		return not_found;
+	};
+
+	std::size_t elem_id (find(x, y));
+	if (elem_id != not_found)
+		return elem_id;
+
+	// points on the upper or right boundary of the mesh belong to the element
+	// left of or below them, as for RegularGrid::findElements()
+	double const x_left (std::nextafter(x, _min[0]));
+	double const y_below (std::nextafter(y, _min[1]));
+	if ((elem_id = find(x_left, y)) != not_found ||
+	    (elem_id = find(x, y_below)) != not_found ||
+	    (elem_id = find(x_left, y_below)) != not_found)
+		return elem_id;
+
+	// remaining points on slanted boundary edges
+	std::size_t const bin (getBinOf(x, y));
+	for (std::size_t k=_bin_offsets[bin]; k<_bin_offsets[bin+1]; ++k)
+		if (isPointOnOutline(_bin_elements[k], x, y))
+			return _bin_elements[k];
+	return not_found;
+}
+
+std::array<double, 2> ElementGrid::getElementCenter(std::size_t elem_id) const
+{
+	std::array<double, 2> center = {{ 0, 0 }};
+	std::size_t const begin (_vertex_offsets[elem_id]);
+	std::size_t const end (_vertex_offsets[elem_id+1]);
+	if (begin == end)
+		return center;
+	for (std::size_t i=begin; i<end; ++i)
+	{
+		center[0] += _vertices[i][0];
+		center[1] += _vertices[i][1];
+	}
+	center[0] /= static_cast<double>(end - begin);
+	center[1] /= static_cast<double>(end - begin);
+	return center;
+}
+
+bool ElementGrid::isPointInElement(std::size_t elem_id, double x, double y) const
+{
+	// crossing number test, the half-open comparisons assign points on an edge
+	// shared by two elements to exactly one of them
+	std::size_t const begin (_vertex_offsets[elem_id]);
+	std::size_t const end (_vertex_offsets[elem_id+1]);
+	if (end - begin < 3)
+		return false;
+
+	bool inside (false);
+	for (std::size_t i=begin, j=end-1; i<end; j=i++)
+	{
+		std::array<double, 2> const& a (_vertices[i]);
+		std::array<double, 2> const& b (_vertices[j]);
+		if ((a[1] > y) != (b[1] > y) &&
+		    x < a[0] + (y - a[1]) * (b[0] - a[0]) / (b[1] - a[1]))
+			inside = !inside;
+	}
+	return inside;
+}
+
+bool ElementGrid::isPointOnOutline(std::size_t elem_id, double x, double y) const
+{
+	std::size_t const begin (_vertex_offsets[elem_id]);
+	std::size_t const end (_vertex_offsets[elem_id+1]);
+	if (end - begin < 3)
+		return false;
+
+	for (std::size_t i=begin, j=end-1; i<end; j=i++)
+	{
+		std::array<double, 2> const& a (_vertices[i]);
+		std::array<double, 2> const& b (_vertices[j]);
+		if (x < std::min(a[0], b[0]) || x > std::max(a[0], b[0]) ||
+		    y < std::min(a[1], b[1]) || y > std::max(a[1], b[1]))
+			continue;
+		double const u ((b[0] - a[0]) * (y - a[1]));
+		double const v ((b[1] - a[1]) * (x - a[0]));
+		if (std::abs(u - v) <= 4 * std::numeric_limits<double>::epsilon() * (std::abs(u) + std::abs(v)))
+			return true;
+	}
+	return false;
+}
+
+} // end namespace ToolsLib
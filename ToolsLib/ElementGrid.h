@@ -0,0 +1,83 @@
+/**
+ * @file   ElementGrid.h
+ * @author Karsten Rink
+ * @date   2026/10/14
+ * @brief  Uniform bin grid for locating the mesh element containing a point
+ *
+ * @copyright
+ * Copyright (c) 2012-2026, OpenGeoSys Community (http://www.opengeosys.org)
+ *            Distributed under a Modified BSD License.
+ *              See accompanying file LICENSE.txt or
+ *              http://www.opengeosys.org/LICENSE.txt
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+namespace MeshLib
+{
+	class Mesh;
+}
+
+namespace ToolsLib
+{
+
+/**
+ * Spatial index over the elements of a mesh projected onto the xy-plane.
+ * The outlines of all 2d elements (using their base nodes) are stored
+ * contiguously and the bounding box of each element is registered in all bins
+ * of a uniform grid it overlaps. A query tests the point exactly against the
+ * polygons registered in its bin, hence it works for arbitrary polygonal
+ * element types.
+ */
+class ElementGrid
+{
+public:
+	/// Builds the index for all 2d elements of the given mesh, z-coordinates
+	/// are ignored. Elements of other dimensions are never found.
+	explicit ElementGrid(MeshLib::Mesh const& mesh);
+
+	/// Returns the ID of the element containing (x,y) or \c not_found. Points
+	/// on an edge shared by two elements belong to one of them, points on the
+	/// outer boundary of the mesh belong to the element they lie on, as for
+	/// RegularGrid::findElements().
+	std::size_t findElement(double x, double y) const;
+
+	/// Returns true if (x,y) is within the outline of the given element. Only
+	/// the lower and left edges of the outline are included.
+	bool isPointInElement(std::size_t elem_id, double x, double y) const;
+
+	/// Returns true if (x,y) is on one of the edges of the given element.
+	bool isPointOnOutline(std::size_t elem_id, double x, double y) const;
+
+	std::size_t getNumberOfElements() const { return _vertex_offsets.size() - 1; }
+
+	/// Returns the mean of the outline vertices of the given element.
+	std::array<double, 2> getElementCenter(std::size_t elem_id) const;
+
+	static std::size_t const not_found;
+
+private:
+	std::size_t getBin(std::size_t ix, std::size_t iy) const { return iy * _n_bins[0] + ix; }
+
+	std::array<double, 2> _min;
+	std::array<double, 2> _max;
+	std::array<double, 2> _bin_size;
+	std::array<std::size_t, 2> _n_bins;
+
+	/// xy-coordinates of the element outlines, vertices of element i are in
+	/// the range [_vertex_offsets[i], _vertex_offsets[i+1]).
+	std::vector<std::size_t> _vertex_offsets;
+	std::vector<std::array<double, 2>> _vertices;
+
+	/// IDs of the elements overlapping bin b are in the range
+	/// [_bin_offsets[b], _bin_offsets[b+1]) of _bin_elements.
+	std::vector<std::size_t> _bin_offsets;
+	std::vector<std::size_t> _bin_elements;
+};
+
+} // end namespace ToolsLib
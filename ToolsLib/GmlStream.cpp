@@ -0,0 +1,497 @@
+/**
+ * @file   GmlStream.cpp
+ * @author Karsten Rink
+ * @date   2026/10/14
+ * @brief  Streaming reader and writer for OGS geometry (*.gml) files
+ *
+ * @copyright
+ * Copyright (c) 2012-2026, OpenGeoSys Community (http://www.opengeosys.org)
+ *            Distributed under a Modified BSD License.
+ *              See accompanying file LICENSE.txt or
+ *              http://www.opengeosys.org/LICENSE.txt
+ */
+
+#include "GmlStream.h"
+
+#include <cstring>
+#include <limits>
+
+// ThirdParty/logog
+#include "logog/include/logog.hpp"
+
+#include "NumberParsing.h"
+
+namespace ToolsLib
+{
+
+namespace
+{
+
+/// A start or end tag, attributes are kept as unparsed range.
+struct XmlTag
+{
+	std::string name;
+	char const* attributes_begin;
+	char const* attributes_end;
+	bool is_end;
+	bool is_empty;
+};
+
+bool isSpace(char c)
+{
+	return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+/// Appends the UTF-8 encoding of a unicode code point.
+void appendUtf8(unsigned long code_point, std::string &result)
+{
+	if (code_point < 0x80)
+		result += static_cast<char>(code_point);
+	else if (code_point < 0x800)
+	{
+		result += static_cast<char>(0xC0 | (code_point >> 6));
+		result += static_cast<char>(0x80 | (code_point & 0x3F));
+	}
+	else if (code_point < 0x10000)
+	{
+		result += static_cast<char>(0xE0 | (code_point >> 12));
+		result += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+		result += static_cast<char>(0x80 | (code_point & 0x3F));
+	}
+	else
+	{
+		result += static_cast<char>(0xF0 | (code_point >> 18));
+		result += static_cast<char>(0x80 | ((code_point >> 12) & 0x3F));
+		result += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+		result += static_cast<char>(0x80 | (code_point & 0x3F));
+	}
+}
+
+/// Decodes a character reference "&#NN;" or "&#xNN;" starting at begin.
+/// Returns the position after the reference or begin if there is no valid one.
+char const* decodeCharacterReference(char const* begin, char const* end, std::string &result)
+{
+	if (end - begin < 4 || begin[1] != '#')
+		return begin;
+	char const* pos (begin + 2);
+	unsigned long base (10);
+	if (*pos == 'x')
+	{
+		base = 16;
+		++pos;
+	}
+	unsigned long code_point (0);
+	char const* const digits_begin (pos);
+	for (; pos < end && *pos != ';'; ++pos)
+	{
+		unsigned long digit;
+		if (*pos >= '0' && *pos <= '9')
+			digit = *pos - '0';
+		else if (base == 16 && *pos >= 'a' && *pos <= 'f')
+			digit = *pos - 'a' + 10;
+		else if (base == 16 && *pos >= 'A' && *pos <= 'F')
+			digit = *pos - 'A' + 10;
+		else
+			return begin;
+		code_point = base * code_point + digit;
+		if (code_point > 0x10FFFF)
+			return begin;
+	}
+	if (pos == end || pos == digits_begin || code_point == 0
+		|| (code_point >= 0xD800 && code_point <= 0xDFFF))
+		return begin;
+	appendUtf8(code_point, result);
+	return pos + 1;
+}
+
+/// Replaces the predefined entities of XML and character references, the
+/// latter are encoded as UTF-8.
+std::string decodeEntities(char const* begin, char const* end)
+{
+	static char const* const entities[] = { "&amp;", "&lt;", "&gt;", "&quot;", "&apos;" };
+	static char const replacements[] = { '&', '<', '>', '"', '\'' };
+	std::string result;
+	result.reserve(end - begin);
+	while (begin < end)
+	{
+		bool replaced (false);
+		if (*begin == '&')
+		{
+			char const* const next (decodeCharacterReference(begin, end, result));
+			replaced = (next != begin);
+			begin = next;
+			for (std::size_t i=0; i<5 && !replaced; ++i)
+			{
+				std::size_t const length (std::strlen(entities[i]));
+				if (static_cast<std::size_t>(end - begin) >= length && std::strncmp(begin, entities[i], length) == 0)
+				{
+					result += replacements[i];
+					begin += length;
+					replaced = true;
+				}
+			}
+		}
+		if (!replaced)
+			result += *begin++;
+	}
+	return result;
+}
+
+std::string encodeEntities(std::string const& str)
+{
+	std::string result;
+	result.reserve(str.size());
+	for (char c : str)
+	{
+		switch (c)
+		{
+			case '&': result += "&amp;"; break;
+			case '<': result += "&lt;"; break;
+			case '>': result += "&gt;"; break;
+			case '"': result += "&quot;"; break;
+			default: result += c;
+		}
+	}
+	return result;
+}
+
+bool parseIndex(char const* begin, char const* end, std::size_t &value)
+{
+	while (begin < end && isSpace(*begin))
+		++begin;
+	while (end > begin && isSpace(*(end-1)))
+		--end;
+	if (begin == end)
+		return false;
+	std::size_t const max (std::numeric_limits<std::size_t>::max());
+	value = 0;
+	for (; begin < end; ++begin)
+	{
+		if (*begin < '0' || *begin > '9')
+			return false;
+		std::size_t const digit (*begin - '0');
+		if (value > (max - digit) / 10)
+			return false;
+		value = 10 * value + digit;
+	}
+	return true;
+}
+
+/// Finds the next tag starting at pos, skipping the XML declaration,
+/// processing instructions and comments. Returns the position after the tag
+/// or nullptr if there is none.
+char const* nextTag(char const* pos, char const* end, XmlTag &tag)
+{
+	for (;;)
+	{
+		pos = static_cast<char const*>(std::memchr(pos, '<', end - pos));
+		if (pos == nullptr || end - pos < 2)
+			return nullptr;
+		if (pos[1] == '?' || pos[1] == '!')
+		{
+			char const* const close ((pos[1] == '!' && end - pos > 3 && pos[2] == '-' && pos[3] == '-') ? "-->" : ">");
+			std::size_t const close_length (std::strlen(close));
+			char const* p (pos + 2);
+			while (p + close_length <= end && std::strncmp(p, close, close_length) != 0)
+				++p;
+			if (p + close_length > end)
+				return nullptr;
+			pos = p + close_length;
+			continue;
+		}
+		break;
+	}
+
+	char const* p (pos + 1);
+	tag.is_end = (*p == '/');
+	if (tag.is_end)
+		++p;
+	char const* const name_begin (p);
+	while (p < end && !isSpace(*p) && *p != '>' && *p != '/')
+		++p;
+	tag.name.assign(name_begin, p);
+	tag.attributes_begin = p;
+
+	// '>' within quoted attribute values does not end the tag
+	char quote (0);
+	while (p < end && (quote != 0 || *p != '>'))
+	{
+		if (quote == 0 && (*p == '"' || *p == '\''))
+			quote = *p;
+		else if (*p == quote)
+			quote = 0;
+		++p;
+	}
+	if (p == end)
+		return nullptr;
+	tag.is_empty = (*(p-1) == '/');
+	tag.attributes_end = tag.is_empty ? p-1 : p;
+	return p + 1;
+}
+
+/// Returns the raw value of the named attribute of the tag.
+bool getAttribute(XmlTag const& tag, char const* name, char const* &value_begin, char const* &value_end)
+{
+	std::size_t const name_length (std::strlen(name));
+	char const* p (tag.attributes_begin);
+	char const* const end (tag.attributes_end);
+	while (p < end)
+	{
+		while (p < end && isSpace(*p))
+			++p;
+		char const* const attr_begin (p);
+		while (p < end && *p != '=' && !isSpace(*p))
+			++p;
+		char const* const attr_end (p);
+		while (p < end && *p != '"' && *p != '\'')
+			++p;
+		if (p == end)
+			return false;
+		char const quote (*p++);
+		char const* const val_begin (p);
+		while (p < end && *p != quote)
+			++p;
+		if (p == end)
+			return false;
+		if (static_cast<std::size_t>(attr_end - attr_begin) == name_length &&
+		    std::strncmp(attr_begin, name, name_length) == 0)
+		{
+			value_begin = val_begin;
+			value_end = p;
+			return true;
+		}
+		++p;
+	}
+	return false;
+}
+
+bool getDoubleAttribute(XmlTag const& tag, char const* name, double &value)
+{
+	char const* begin (nullptr);
+	char const* end (nullptr);
+	return getAttribute(tag, name, begin, end) && parseDouble(begin, end, value);
+}
+
+bool getIndexAttribute(XmlTag const& tag, char const* name, std::size_t &value)
+{
+	char const* begin (nullptr);
+	char const* end (nullptr);
+	return getAttribute(tag, name, begin, end) && parseIndex(begin, end, value);
+}
+
+std::string getNameAttribute(XmlTag const& tag)
+{
+	char const* begin (nullptr);
+	char const* end (nullptr);
+	if (!getAttribute(tag, "name", begin, end))
+		return std::string();
+	return decodeEntities(begin, end);
+}
+
+/// Returns the end of the text content starting at pos.
+char const* findTextEnd(char const* pos, char const* end)
+{
+	char const* const text_end (static_cast<char const*>(std::memchr(pos, '<', end - pos)));
+	return (text_end == nullptr) ? end : text_end;
+}
+
+} // end anonymous namespace
+
+GmlReader::GmlReader(std::string const& file_name)
+: _file_name(file_name), _file(file_name)
+{
+}
+
+bool GmlReader::read(GmlHandler const& handler) const
+{
+	if (!isOpen())
+	{
+		ERR ("GmlReader::read(): Could not open file %s.", _file_name.c_str());
+		return false;
+	}
+
+	enum class Object { None, Polyline, Surface };
+	Object object (Object::None);
+	GmlObject current;
+	std::size_t depth (0);
+	bool is_gml (false);
+
+	XmlTag tag;
+	char const* const end (_file.end());
+	char const* pos (_file.begin());
+	while ((pos = nextTag(pos, end, tag)) != nullptr)
+	{
+		if (tag.is_end)
+		{
+			if (depth > 0)
+				depth--;
+			if (tag.name == "polyline" && object == Object::Polyline)
+			{
+				if (handler.polyline)
+					handler.polyline(current);
+				object = Object::None;
+			}
+			else if (tag.name == "surface" && object == Object::Surface)
+			{
+				if (handler.surface)
+					handler.surface(current);
+				object = Object::None;
+			}
+			continue;
+		}
+
+		if (depth == 0)
+		{
+			if (tag.name != "OpenGeoSysGLI")
+			{
+				ERR ("GmlReader::read(): %s is not a geometry file.", _file_name.c_str());
+				return false;
+			}
+			is_gml = true;
+		}
+		else if (tag.name == "name" && depth == 1 && !tag.is_empty)
+		{
+			if (handler.name)
+				handler.name(decodeEntities(pos, findTextEnd(pos, end)));
+		}
+		else if (tag.name == "point")
+		{
+			if (handler.point)
+			{
+				std::size_t id (0);
+				double x (0), y (0), z (0);
+				if (!getIndexAttribute(tag, "id", id) || !getDoubleAttribute(tag, "x", x) ||
+				    !getDoubleAttribute(tag, "y", y) || !getDoubleAttribute(tag, "z", z))
+				{
+					ERR ("GmlReader::read(): Invalid point in file %s.", _file_name.c_str());
+					return false;
+				}
+				handler.point(id, x, y, z);
+			}
+		}
+		else if (tag.name == "polyline" || tag.name == "surface")
+		{
+			bool const is_polyline (tag.name == "polyline");
+			bool const is_handled (is_polyline ? static_cast<bool>(handler.polyline) : static_cast<bool>(handler.surface));
+			object = is_handled ? (is_polyline ? Object::Polyline : Object::Surface) : Object::None;
+			if (is_handled)
+			{
+				if (!getIndexAttribute(tag, "id", current.id))
+					current.id = std::numeric_limits<std::size_t>::max();
+				current.name = getNameAttribute(tag);
+				current.point_ids.clear();
+				if (tag.is_empty)
+				{
+					if (is_polyline)
+						handler.polyline(current);
+					else
+						handler.surface(current);
+					object = Object::None;
+				}
+			}
+		}
+		else if (tag.name == "pnt" && object == Object::Polyline && !tag.is_empty)
+		{
+			std::size_t id (0);
+			if (!parseIndex(pos, findTextEnd(pos, end), id))
+			{
+				ERR ("GmlReader::read(): Invalid polyline point in file %s.", _file_name.c_str());
+				return false;
+			}
+			current.point_ids.push_back(id);
+		}
+		else if (tag.name == "element" && object == Object::Surface)
+		{
+			std::size_t p1 (0), p2 (0), p3 (0);
+			if (!getIndexAttribute(tag, "p1", p1) || !getIndexAttribute(tag, "p2", p2) ||
+			    !getIndexAttribute(tag, "p3", p3))
+			{
+				ERR ("GmlReader::read(): Invalid surface element in file %s.", _file_name.c_str());
+				return false;
+			}
+			current.point_ids.push_back(p1);
+			current.point_ids.push_back(p2);
+			current.point_ids.push_back(p3);
+		}
+
+		if (!tag.is_empty)
+			depth++;
+	}
+
+	if (!is_gml)
+		ERR ("GmlReader::read(): %s is not a geometry file.", _file_name.c_str());
+	return is_gml;
+}
+
+GmlWriter::GmlWriter(std::string const& file_name, std::string const& geo_name)
+: _out(file_name.c_str())
+{
+	if (!_out.is_open())
+	{
+		ERR ("GmlWriter: Could not open file %s.", file_name.c_str());
+		return;
+	}
+	_out.precision(std::numeric_limits<double>::max_digits10);
+	_out << "<?xml version=\"1.0\" encoding=\"ISO-8859-1\"?>\n"
+	     << "<?xml-stylesheet type=\"text/xsl\" href=\"OpenGeoSysGLI.xsl\"?>\n"
+	     << "<OpenGeoSysGLI xmlns:ogs=\"http://www.opengeosys.org\" xmlns:xsi=\"http://www.w3.org/2001/XMLSchema-instance\">\n"
+	     << " <name>" << encodeEntities(geo_name) << "</name>\n";
+}
+
+void GmlWriter::beginSection(Section section)
+{
+	if (_section == section)
+		return;
+	static char const* const tags[] = { "", "points", "polylines", "surfaces" };
+	if (_section != Section::None)
+		_out << " </" << tags[static_cast<int>(_section)] << ">\n";
+	_section = section;
+	if (_section != Section::None)
+		_out << " <" << tags[static_cast<int>(_section)] << ">\n";
+}
+
+void GmlWriter::writeObjectTag(char const* tag, std::size_t id, std::string const& name)
+{
+	_out << "  <" << tag << " id=\"" << id << "\"";
+	if (!name.empty())
+		_out << " name=\"" << encodeEntities(name) << "\"";
+	_out << ">\n";
+}
+
+void GmlWriter::addPoint(double x, double y, double z)
+{
+	beginSection(Section::Points);
+	_out << "  <point id=\"" << _n_points++ << "\" x=\"" << x << "\" y=\"" << y << "\" z=\"" << z << "\"/>\n";
+}
+
+void GmlWriter::addPolyline(std::string const& name, std::vector<std::size_t> const& point_ids)
+{
+	beginSection(Section::Polylines);
+	writeObjectTag("polyline", _n_polylines++, name);
+	for (std::size_t id : point_ids)
+		_out << "   <pnt>" << id << "</pnt>\n";
+	_out << "  </polyline>\n";
+}
+
+void GmlWriter::addSurface(std::string const& name, std::vector<std::size_t> const& triangle_point_ids)
+{
+	beginSection(Section::Surfaces);
+	writeObjectTag("surface", _n_surfaces++, name);
+	std::size_t const n_triangles (triangle_point_ids.size() / 3);
+	for (std::size_t i=0; i<n_triangles; ++i)
+		_out << "   <element p1=\"" << triangle_point_ids[3*i] << "\" p2=\"" << triangle_point_ids[3*i+1]
+		     << "\" p3=\"" << triangle_point_ids[3*i+2] << "\"/>\n";
+	_out << "  </surface>\n";
+}
+
+bool GmlWriter::close()
+{
+	if (!_out.is_open())
+		return false;
+	beginSection(Section::None);
+	_out << "</OpenGeoSysGLI>\n";
+	_out.close();
+	return !_out.fail();
+}
+
+} // end namespace ToolsLib
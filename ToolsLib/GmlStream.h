@@ -0,0 +1,98 @@
+/**
+ * @file   GmlStream.h
+ * @author Karsten Rink
+ * @date   2026/10/14
+ * @brief  Streaming reader and writer for OGS geometry (*.gml) files
+ *
+ * @copyright
+ * Copyright (c) 2012-2026, OpenGeoSys Community (http://www.opengeosys.org)
+ *            Distributed under a Modified BSD License.
+ *              See accompanying file LICENSE.txt or
+ *              http://www.opengeosys.org/LICENSE.txt
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "MappedFile.h"
+
+namespace ToolsLib
+{
+
+/// A polyline or surface of a geometry file. Point IDs refer to the IDs used
+/// in the file, a surface stores three point IDs per triangle.
+struct GmlObject
+{
+	std::size_t id;
+	std::string name;
+	std::vector<std::size_t> point_ids;
+};
+
+/// Callbacks for the objects of a geometry file, unset callbacks are skipped.
+struct GmlHandler
+{
+	std::function<void(std::string const& geo_name)> name;
+	std::function<void(std::size_t id, double x, double y, double z)> point;
+	std::function<void(GmlObject const& polyline)> polyline;
+	std::function<void(GmlObject const& surface)> surface;
+};
+
+/**
+ * Reads geometry files in a single pass without building a DOM. The file is
+ * memory mapped and the handlers are called in file order, so the memory
+ * needed does not depend on the size of the file. Several passes with
+ * different handlers can be made over the same file.
+ */
+class GmlReader
+{
+public:
+	explicit GmlReader(std::string const& file_name);
+
+	bool isOpen() const { return _file.isOpen(); }
+
+	/// Parses the file and calls the handlers for all objects.
+	/// @return false if the file is not a valid geometry file.
+	bool read(GmlHandler const& handler) const;
+
+private:
+	std::string const _file_name;
+	MappedFile const _file;
+};
+
+/**
+ * Writes geometry files object by object. Points have to be added first,
+ * followed by polylines and surfaces, IDs are assigned consecutively.
+ */
+class GmlWriter
+{
+public:
+	GmlWriter(std::string const& file_name, std::string const& geo_name);
+
+	bool isOpen() const { return _out.is_open(); }
+
+	void addPoint(double x, double y, double z);
+	void addPolyline(std::string const& name, std::vector<std::size_t> const& point_ids);
+	void addSurface(std::string const& name, std::vector<std::size_t> const& triangle_point_ids);
+
+	/// Finishes the file, no objects can be added afterwards.
+	bool close();
+
+private:
+	enum class Section { None, Points, Polylines, Surfaces };
+
+	void beginSection(Section section);
+	void writeObjectTag(char const* tag, std::size_t id, std::string const& name);
+
+	std::ofstream _out;
+	Section _section = Section::None;
+	std::size_t _n_points = 0;
+	std::size_t _n_polylines = 0;
+	std::size_t _n_surfaces = 0;
+};
+
+} // end namespace ToolsLib
@@ -0,0 +1,98 @@
+/**
+ * @file   MappedFile.cpp
+ * @author Karsten Rink
+ * @date   2026/10/14
+ * @brief  Read-only memory mapping of input files
+ *
+ * @copyright
+ * Copyright (c) 2012-2026, OpenGeoSys Community (http://www.opengeosys.org)
+ *            Distributed under a Modified BSD License.
+ *              See accompanying file LICENSE.txt or
+ *              http://www.opengeosys.org/LICENSE.txt
+ */
+
+#include "MappedFile.h"
+
+#include <fstream>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// ThirdParty/logog
+#include "logog/include/logog.hpp"
+
+namespace ToolsLib
+{
+
+MappedFile::MappedFile(std::string const& file_name)
+{
+#ifndef _WIN32
+	int const fd = ::open(file_name.c_str(), O_RDONLY);
+	if (fd < 0)
+	{
+		ERR ("MappedFile: Could not open file %s.", file_name.c_str());
+		return;
+	}
+
+	struct stat file_stat;
+	if (::fstat(fd, &file_stat) != 0)
+	{
+		ERR ("MappedFile: Could not determine size of file %s.", file_name.c_str());
+		::close(fd);
+		return;
+	}
+	_size = static_cast<std::size_t>(file_stat.st_size);
+	_is_open = true;
+
+	if (_size > 0)
+	{
+		void* const addr = ::mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (addr != MAP_FAILED)
+		{
+			::madvise(addr, _size, MADV_SEQUENTIAL);
+			_data = static_cast<char const*>(addr);
+			_is_mapped = true;
+		}
+	}
+	::close(fd);
+
+	if (!_is_mapped && _size > 0)
+	{
+		WARN ("MappedFile: Mapping of %s failed, reading file into memory.", file_name.c_str());
+		_is_open = readIntoBuffer(file_name);
+	}
+#else
+	_is_open = readIntoBuffer(file_name);
+#endif
+}
+
+MappedFile::~MappedFile()
+{
+#ifndef _WIN32
+	if (_is_mapped)
+		::munmap(const_cast<char*>(_data), _size);
+#endif
+}
+
+bool MappedFile::readIntoBuffer(std::string const& file_name)
+{
+	std::ifstream in(file_name.c_str(), std::ios::in | std::ios::binary);
+	if (!in.is_open())
+	{
+		ERR ("MappedFile: Could not open file %s.", file_name.c_str());
+		return false;
+	}
+	in.seekg(0, std::ios::end);
+	_buffer.resize(static_cast<std::size_t>(in.tellg()));
+	in.seekg(0, std::ios::beg);
+	in.read(_buffer.data(), _buffer.size());
+	_data = _buffer.data();
+	_size = _buffer.size();
+	return !in.fail();
+}
+
+} // end namespace ToolsLib
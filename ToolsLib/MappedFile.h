@@ -0,0 +1,55 @@
+/**
+ * @file   MappedFile.h
+ * @author Karsten Rink
+ * @date   2026/10/14
+ * @brief  Read-only memory mapping of input files
+ *
+ * @copyright
+ * Copyright (c) 2012-2026, OpenGeoSys Community (http://www.opengeosys.org)
+ *            Distributed under a Modified BSD License.
+ *              See accompanying file LICENSE.txt or
+ *              http://www.opengeosys.org/LICENSE.txt
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace ToolsLib
+{
+
+/**
+ * Maps the complete content of a file read-only into memory. On platforms
+ * without mmap (or if mapping fails) the file is read into a buffer instead,
+ * such that users can always work on a contiguous range of characters.
+ * Note that the range is not null-terminated.
+ */
+class MappedFile
+{
+public:
+	explicit MappedFile(std::string const& file_name);
+	~MappedFile();
+
+	MappedFile(MappedFile const&) = delete;
+	MappedFile& operator=(MappedFile const&) = delete;
+
+	/// Returns true if the file could be opened (this includes empty files).
+	bool isOpen() const { return _is_open; }
+
+	char const* begin() const { return _data; }
+	char const* end() const { return _data + _size; }
+	std::size_t size() const { return _size; }
+
+private:
+	bool readIntoBuffer(std::string const& file_name);
+
+	char const* _data = nullptr;
+	std::size_t _size = 0;
+	bool _is_open = false;
+	bool _is_mapped = false;
+	std::vector<char> _buffer;
+};
+
+} // end namespace ToolsLib
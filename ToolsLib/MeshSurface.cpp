@@ -0,0 +1,83 @@
+/**
+ * @file   MeshSurface.cpp
+ * @author Karsten Rink
+ * @date   2026/10/14
+ * @brief  Elevation queries on 2d surface meshes
+ *
+ * @copyright
+ * Copyright (c) 2012-2026, OpenGeoSys Community (http://www.opengeosys.org)
+ *            Distributed under a Modified BSD License.
+ *              See accompanying file LICENSE.txt or
+ *              http://www.opengeosys.org/LICENSE.txt
+ */
+
+#include "MeshSurface.h"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+#include "MeshLib/Mesh.h"
+#include "MeshLib/Node.h"
+#include "MeshLib/Elements/Element.h"
+
+#include "ParallelFor.h"
+
+namespace ToolsLib
+{
+
+MeshSurface::MeshSurface(MeshLib::Mesh const& mesh)
+: _mesh(mesh), _grid(mesh)
+{
+}
+
+bool MeshSurface::getElevation(double x, double y, double &z) const
+{
+	std::size_t const elem_id (_grid.findElement(x, y));
+	if (elem_id == ElementGrid::not_found)
+		return false;
+
+	// use the triangle of the fan around node 0 the point is located in, for
+	// non-convex elements the one it is closest to
+	MeshLib::Element const& elem (*_mesh.getElement(elem_id));
+	MeshLib::Node const& a (*elem.getNode(0));
+	unsigned const n_nodes (elem.getNBaseNodes());
+	double best_min_weight (std::numeric_limits<double>::lowest());
+	for (unsigned i=1; i+1<n_nodes; ++i)
+	{
+		MeshLib::Node const& b (*elem.getNode(i));
+		MeshLib::Node const& c (*elem.getNode(i+1));
+		double const det ((b[1]-c[1])*(a[0]-c[0]) + (c[0]-b[0])*(a[1]-c[1]));
+		if (det == 0)
+			continue;
+		double const w0 (((b[1]-c[1])*(x-c[0]) + (c[0]-b[0])*(y-c[1])) / det);
+		double const w1 (((c[1]-a[1])*(x-c[0]) + (a[0]-c[0])*(y-c[1])) / det);
+		double const w2 (1.0 - w0 - w1);
+		double const min_weight (std::min(w0, std::min(w1, w2)));
+		if (min_weight > best_min_weight)
+		{
+			best_min_weight = min_weight;
+			z = w0 * a[2] + w1 * b[2] + w2 * c[2];
+		}
+		if (min_weight >= 0)
+			break;
+	}
+	return best_min_weight > std::numeric_limits<double>::lowest();
+}
+
+std::size_t MeshSurface::getElevations(std::size_t n, double const* x, double const* y,
+                                       double* z, unsigned n_threads) const
+{
+	std::vector<std::size_t> n_unmapped (std::max(n_threads, 1u), 0);
+	parallelFor(n, n_threads,
+		[&](std::size_t begin, std::size_t end, unsigned thread_id)
+		{
+			for (std::size_t i=begin; i<end; ++i)
+				if (!getElevation(x[i], y[i], z[i]))
+					n_unmapped[thread_id]++;
+		});
+	return std::accumulate(n_unmapped.begin(), n_unmapped.end(), std::size_t(0));
+}
+
+} // end namespace ToolsLib
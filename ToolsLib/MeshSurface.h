@@ -0,0 +1,52 @@
+/**
+ * @file   MeshSurface.h
+ * @author Karsten Rink
+ * @date   2026/10/14
+ * @brief  Elevation queries on 2d surface meshes
+ *
+ * @copyright
+ * Copyright (c) 2012-2026, OpenGeoSys Community (http://www.opengeosys.org)
+ *            Distributed under a Modified BSD License.
+ *              See accompanying file LICENSE.txt or
+ *              http://www.opengeosys.org/LICENSE.txt
+ */
+
+#pragma once
+
+#include "ElementGrid.h"
+
+namespace MeshLib
+{
+	class Mesh;
+}
+
+namespace ToolsLib
+{
+
+/**
+ * A 2d mesh interpreted as a surface z = f(x, y), e.g. a DEM. Elements are
+ * located via an ElementGrid and the elevation is interpolated linearly
+ * within a triangle fan of the element's base nodes. Queries are read-only
+ * and can be issued from any number of threads.
+ */
+class MeshSurface
+{
+public:
+	explicit MeshSurface(MeshLib::Mesh const& mesh);
+
+	/// Sets z to the elevation of the surface at (x, y).
+	/// @return false if the point is not located on the surface.
+	bool getElevation(double x, double y, double &z) const;
+
+	/// Computes the elevation of n points in parallel, z is left unchanged
+	/// for points not located on the surface.
+	/// @return The number of points not located on the surface.
+	std::size_t getElevations(std::size_t n, double const* x, double const* y,
+	                          double* z, unsigned n_threads = 1) const;
+
+private:
+	MeshLib::Mesh const& _mesh;
+	ElementGrid const _grid;
+};
+
+} // end namespace ToolsLib
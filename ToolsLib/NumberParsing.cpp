@@ -0,0 +1,40 @@
+/**
+ * @file   NumberParsing.cpp
+ * @author Karsten Rink
+ * @date   2026/10/14
+ * @brief  Allocation-free parsing of numbers from character ranges
+ *
+ * @copyright
+ * Copyright (c) 2012-2026, OpenGeoSys Community (http://www.opengeosys.org)
+ *            Distributed under a Modified BSD License.
+ *              See accompanying file LICENSE.txt or
+ *              http://www.opengeosys.org/LICENSE.txt
+ */
+
+#include "NumberParsing.h"
+
+#include <cstdlib>
+
+namespace ToolsLib
+{
+
+bool parseDouble(char const* begin, char const* end, double &value)
+{
+	// strtod() expects a terminated string, so the field is copied to the stack
+	char buffer[64];
+	std::size_t const length (end - begin);
+	if (length == 0 || length >= sizeof(buffer))
+		return false;
+	std::memcpy(buffer, begin, length);
+	buffer[length] = '\0';
+
+	char* parse_end (nullptr);
+	value = std::strtod(buffer, &parse_end);
+	if (parse_end == buffer)
+		return false;
+	while (*parse_end == ' ' || *parse_end == '\t' || *parse_end == '\r')
+		++parse_end;
+	return *parse_end == '\0';
+}
+
+} // end namespace ToolsLib
@@ -0,0 +1,44 @@
+/**
+ * @file   NumberParsing.h
+ * @author Karsten Rink
+ * @date   2026/10/14
+ * @brief  Allocation-free parsing of numbers from character ranges
+ *
+ * @copyright
+ * Copyright (c) 2012-2026, OpenGeoSys Community (http://www.opengeosys.org)
+ *            Distributed under a Modified BSD License.
+ *              See accompanying file LICENSE.txt or
+ *              http://www.opengeosys.org/LICENSE.txt
+ */
+
+#pragma once
+
+#include <cstring>
+
+namespace ToolsLib
+{
+
+/**
+ * Parses a floating point number from the range [begin, end), which does not
+ * need to be null-terminated (e.g. a field within a memory mapped file).
+ * Trailing whitespace such as '\r' from DOS line endings is accepted.
+ * @return false if the range does not contain a valid number.
+ */
+bool parseDouble(char const* begin, char const* end, double &value);
+
+/// Returns the end of the field starting at \c begin, i.e. the position of
+/// the next delimiter or \c end if there is none.
+inline char const* findFieldEnd(char const* begin, char const* end, char delim)
+{
+	char const* const field_end = static_cast<char const*>(std::memchr(begin, delim, end - begin));
+	return (field_end == nullptr) ? end : field_end;
+}
+
+/// Returns the end of the line starting at \c begin, the line break is not
+/// part of the line.
+inline char const* findLineEnd(char const* begin, char const* end)
+{
+	return findFieldEnd(begin, end, '\n');
+}
+
+} // end namespace ToolsLib
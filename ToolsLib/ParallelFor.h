@@ -0,0 +1,62 @@
+/**
+ * @file   ParallelFor.h
+ * @author Karsten Rink
+ * @date   2026/10/14
+ * @brief  Static partitioning of index ranges onto threads
+ *
+ * @copyright
+ * Copyright (c) 2012-2026, OpenGeoSys Community (http://www.opengeosys.org)
+ *            Distributed under a Modified BSD License.
+ *              See accompanying file LICENSE.txt or
+ *              http://www.opengeosys.org/LICENSE.txt
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace ToolsLib
+{
+
+/// Returns the number of threads to be used, 0 selects all available cores.
+inline unsigned getNumberOfThreads(unsigned requested)
+{
+	if (requested > 0)
+		return requested;
+	return std::max(std::thread::hardware_concurrency(), 1u);
+}
+
+/**
+ * Splits the range [0, n) into at most n_threads contiguous parts of equal
+ * size and calls f(begin, end, thread_id) for each part in its own thread.
+ * The partitioning only depends on n and n_threads. The calling thread
+ * processes the first part, the function returns once all parts are done.
+ */
+template <typename F>
+void parallelFor(std::size_t n, unsigned n_threads, F const& f)
+{
+	std::size_t const n_parts (std::max<std::size_t>(1, std::min<std::size_t>(n_threads, n)));
+	std::size_t const part_size ((n + n_parts - 1) / n_parts);
+	if (n_parts == 1)
+	{
+		f(0, n, 0u);
+		return;
+	}
+
+	std::vector<std::thread> threads;
+	threads.reserve(n_parts - 1);
+	for (std::size_t t=1; t<n_parts; ++t)
+	{
+		std::size_t const begin (std::min(n, t * part_size));
+		std::size_t const end (std::min(n, begin + part_size));
+		threads.emplace_back([&f, begin, end, t]() { f(begin, end, static_cast<unsigned>(t)); });
+	}
+	f(0, std::min(n, part_size), 0u);
+	for (std::thread &thread : threads)
+		thread.join();
+}
+
+} // end namespace ToolsLib
@@ -0,0 +1,226 @@
+/**
+ * @file   PhaseTimer.cpp
+ * @author Karsten Rink
+ * @date   2026/10/14
+ * @brief  Implementation of the phase timer
+ *
+ * @copyright
+ * Copyright (c) 2012-2026, OpenGeoSys Community (http://www.opengeosys.org)
+ *            Distributed under a Modified BSD License.
+ *              See accompanying file LICENSE.txt or
+ *              http://www.opengeosys.org/LICENSE.txt
+ */
+
+#include "PhaseTimer.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#include <sys/stat.h>
+#endif
+
+// ThirdParty/logog
+#include "logog/include/logog.hpp"
+
+namespace ToolsLib
+{
+
+PhaseTimer::PhaseTimer()
+: _creation(Clock::now())
+{
+}
+
+void PhaseTimer::start(std::string const& name)
+{
+	stop();
+	_running = { name, 0.0, 0, 0, 0, 0, 1 };
+	_is_running = true;
+	_start = Clock::now();
+}
+
+void PhaseTimer::stop(std::size_t n_items)
+{
+	if (!_is_running)
+		return;
+	std::chrono::duration<double> const elapsed (Clock::now() - _start);
+	_running.seconds = elapsed.count();
+	_running.n_items += n_items;
+	_is_running = false;
+	add(_running);
+}
+
+void PhaseTimer::addBytesRead(std::size_t n_bytes)
+{
+	if (_is_running)
+		_running.bytes_read += n_bytes;
+}
+
+void PhaseTimer::addBytesWritten(std::size_t n_bytes)
+{
+	if (_is_running)
+		_running.bytes_written += n_bytes;
+}
+
+void PhaseTimer::add(Phase const& phase)
+{
+	std::size_t const peak_rss (getPeakResidentSetSize());
+	std::lock_guard<std::mutex> lock(_mutex);
+	auto const it = std::find_if(_phases.begin(), _phases.end(),
+		[&phase](Phase const& p) { return p.name == phase.name; });
+	if (it == _phases.end())
+	{
+		_phases.push_back(phase);
+		_phases.back().peak_rss = peak_rss;
+		return;
+	}
+	it->seconds += phase.seconds;
+	it->n_items += phase.n_items;
+	it->bytes_read += phase.bytes_read;
+	it->bytes_written += phase.bytes_written;
+	it->peak_rss = std::max(it->peak_rss, peak_rss);
+	it->n_calls += phase.n_calls;
+}
+
+std::vector<Phase> PhaseTimer::getPhases() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _phases;
+}
+
+double PhaseTimer::getTotalSeconds() const
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	double seconds (0);
+	for (Phase const& phase : _phases)
+		seconds += phase.seconds;
+	return seconds;
+}
+
+double PhaseTimer::getWallSeconds() const
+{
+	std::chrono::duration<double> const elapsed (Clock::now() - _creation);
+	return elapsed.count();
+}
+
+void PhaseTimer::writeJson(std::ostream &out, std::string const& indent) const
+{
+	std::vector<Phase> const phases (getPhases());
+	out << "[";
+	for (std::size_t i=0; i<phases.size(); ++i)
+	{
+		Phase const& phase (phases[i]);
+		bool const has_time (phase.seconds > 0);
+		out << ((i == 0) ? "\n" : ",\n") << indent << "  { \"name\": " << toJsonString(phase.name)
+		    << ", \"calls\": " << phase.n_calls
+		    << ", \"seconds\": " << phase.seconds
+		    << ", \"items\": " << phase.n_items
+		    << ", \"items_per_second\": " << (has_time ? phase.n_items / phase.seconds : 0.0)
+		    << ", \"bytes_read\": " << phase.bytes_read
+		    << ", \"bytes_written\": " << phase.bytes_written
+		    << ", \"bytes_per_second\": " << (has_time ? (phase.bytes_read + phase.bytes_written) / phase.seconds : 0.0)
+		    << ", \"peak_rss_bytes\": " << phase.peak_rss << " }";
+	}
+	out << "\n" << indent << "]";
+}
+
+ScopedPhase::ScopedPhase(PhaseTimer &timer, std::string const& name)
+: _timer(timer), _phase({ name, 0.0, 0, 0, 0, 0, 1 }), _start(std::chrono::steady_clock::now())
+{
+}
+
+ScopedPhase::~ScopedPhase()
+{
+	std::chrono::duration<double> const elapsed (std::chrono::steady_clock::now() - _start);
+	_phase.seconds = elapsed.count();
+	_timer.add(_phase);
+}
+
+std::size_t getPeakResidentSetSize()
+{
+#ifndef _WIN32
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) != 0)
+		return 0;
+#ifdef __APPLE__
+	return static_cast<std::size_t>(usage.ru_maxrss);
+#else
+	// Linux and BSD report kilobytes
+	return static_cast<std::size_t>(usage.ru_maxrss) * 1024;
+#endif
+#else
+	return 0;
+#endif
+}
+
+std::size_t getFileSize(std::string const& file_name)
+{
+#ifndef _WIN32
+	struct stat file_stat;
+	if (::stat(file_name.c_str(), &file_stat) != 0)
+		return 0;
+	return static_cast<std::size_t>(file_stat.st_size);
+#else
+	std::ifstream in(file_name.c_str(), std::ios::binary | std::ios::ate);
+	if (!in.is_open())
+		return 0;
+	return static_cast<std::size_t>(in.tellg());
+#endif
+}
+
+std::string toJsonString(std::string const& str)
+{
+	std::string result ("\"");
+	for (char const c : str)
+	{
+		if (c == '"' || c == '\\')
+		{
+			result += '\\';
+			result += c;
+		}
+		else if (static_cast<unsigned char>(c) < 0x20)
+		{
+			char escaped[7];
+			std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned>(c));
+			result += escaped;
+		}
+		else
+			result += c;
+	}
+	return result + "\"";
+}
+
+bool writeProfile(std::string const& file_name, std::string const& tool_name, PhaseTimer const& timer)
+{
+	std::ofstream out(file_name.c_str());
+	if (!out.is_open())
+	{
+		ERR ("writeProfile(): Could not open file %s.", file_name.c_str());
+		return false;
+	}
+
+	std::size_t bytes_read (0);
+	std::size_t bytes_written (0);
+	for (Phase const& phase : timer.getPhases())
+	{
+		bytes_read += phase.bytes_read;
+		bytes_written += phase.bytes_written;
+	}
+	out << "{\n"
+	    << "  \"tool\": " << toJsonString(tool_name) << ",\n"
+	    << "  \"wall_seconds\": " << timer.getWallSeconds() << ",\n"
+	    << "  \"peak_rss_bytes\": " << getPeakResidentSetSize() << ",\n"
+	    << "  \"bytes_read\": " << bytes_read << ",\n"
+	    << "  \"bytes_written\": " << bytes_written << ",\n"
+	    << "  \"phases\": ";
+	timer.writeJson(out, "  ");
+	out << "\n}\n";
+	if (!out.good())
+		return false;
+	INFO ("Profile written to %s.", file_name.c_str());
+	return true;
+}
+
+} // end namespace ToolsLib
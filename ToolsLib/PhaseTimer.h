@@ -0,0 +1,132 @@
+/**
+ * @file   PhaseTimer.h
+ * @author Karsten Rink
+ * @date   2026/10/14
+ * @brief  Wall time, memory and I/O measurement of the phases of a run
+ *
+ * @copyright
+ * Copyright (c) 2012-2026, OpenGeoSys Community (http://www.opengeosys.org)
+ *            Distributed under a Modified BSD License.
+ *              See accompanying file LICENSE.txt or
+ *              http://www.opengeosys.org/LICENSE.txt
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace ToolsLib
+{
+
+/// Measurements of a phase. Items are the units processed within the phase
+/// (rows, points, cells, ...) and are used for its throughput.
+struct Phase
+{
+	std::string name;
+	double seconds;
+	std::size_t n_items;
+	std::size_t bytes_read;
+	std::size_t bytes_written;
+	std::size_t peak_rss;  ///< peak resident set size of the process at the end of the phase
+	std::size_t n_calls;   ///< number of measurements summed up in the phase
+};
+
+/**
+ * Measures the phases of a run, e.g. parse, build, bin and write. Each name
+ * denotes one phase, repeated measurements of a phase (several files, time
+ * steps or worker threads) are summed up, i.e. the seconds of a phase
+ * running on several threads are the sum over all threads. Phases are
+ * reported in the order they first occur.
+ * start() and stop() time the consecutive phases of the main thread, add()
+ * and ScopedPhase can be used concurrently from any thread.
+ */
+class PhaseTimer
+{
+public:
+	PhaseTimer();
+
+	PhaseTimer(PhaseTimer const&) = delete;
+	PhaseTimer& operator=(PhaseTimer const&) = delete;
+
+	/// Starts a new phase, a running phase is stopped first.
+	void start(std::string const& name);
+
+	/// Stops the running phase, n_items is used for its throughput.
+	void stop(std::size_t n_items = 0);
+
+	/// Adds to the I/O volume of the running phase.
+	void addBytesRead(std::size_t n_bytes);
+	void addBytesWritten(std::size_t n_bytes);
+
+	/// Adds a measurement to the phase of the same name.
+	void add(Phase const& phase);
+
+	std::vector<Phase> getPhases() const;
+
+	/// Returns the sum of the seconds of all phases.
+	double getTotalSeconds() const;
+
+	/// Returns the wall time since the timer has been created.
+	double getWallSeconds() const;
+
+	/// Writes the phases as JSON array including their throughput, lines
+	/// after the first are prefixed with indent.
+	void writeJson(std::ostream &out, std::string const& indent = "") const;
+
+private:
+	using Clock = std::chrono::steady_clock;
+
+	mutable std::mutex _mutex;
+	std::vector<Phase> _phases;
+	Clock::time_point const _creation;
+	Clock::time_point _start;
+	Phase _running;
+	bool _is_running = false;
+};
+
+/**
+ * Measures its own lifetime and adds it to the timer as phase of the given
+ * name on destruction. Intended for phases running within worker threads.
+ */
+class ScopedPhase
+{
+public:
+	ScopedPhase(PhaseTimer &timer, std::string const& name);
+	~ScopedPhase();
+
+	ScopedPhase(ScopedPhase const&) = delete;
+	ScopedPhase& operator=(ScopedPhase const&) = delete;
+
+	void addItems(std::size_t n_items) { _phase.n_items += n_items; }
+	void addBytesRead(std::size_t n_bytes) { _phase.bytes_read += n_bytes; }
+	void addBytesWritten(std::size_t n_bytes) { _phase.bytes_written += n_bytes; }
+
+private:
+	PhaseTimer &_timer;
+	Phase _phase;
+	std::chrono::steady_clock::time_point const _start;
+};
+
+/// Returns the peak resident set size of the process in bytes, 0 if it
+/// cannot be determined on this platform.
+std::size_t getPeakResidentSetSize();
+
+/// Returns the size of the file in bytes, 0 if it does not exist.
+std::size_t getFileSize(std::string const& file_name);
+
+/// Returns the string quoted and escaped as JSON string.
+std::string toJsonString(std::string const& str);
+
+/**
+ * Writes the profile of a run of a tool as JSON document containing the
+ * total wall time, peak resident set size and I/O volume of the process
+ * followed by the measurements of all phases.
+ */
+bool writeProfile(std::string const& file_name, std::string const& tool_name, PhaseTimer const& timer);
+
+} // end namespace ToolsLib
@@ -0,0 +1,92 @@
+/**
+ * @file   PointBinning.cpp
+ * @author Karsten Rink
+ * @date   2026/10/14
+ * @brief  Binning of scattered data points into the elements of a mesh
+ *
+ * @copyright
+ * Copyright (c) 2012-2026, OpenGeoSys Community (http://www.opengeosys.org)
+ *            Distributed under a Modified BSD License.
+ *              See accompanying file LICENSE.txt or
+ *              http://www.opengeosys.org/LICENSE.txt
+ */
+
+#include "PointBinning.h"
+
+#include <cmath>
+
+// ThirdParty/logog
+#include "logog/include/logog.hpp"
+
+#include "MeshLib/Mesh.h"
+
+#include "ParallelFor.h"
+#include "PointSamples.h"
+
+namespace ToolsLib
+{
+
+BinningContext::BinningContext(MeshLib::Mesh const& mesh, unsigned n_threads_, AggregationSettings const& settings_)
+: regular_grid(RegularGrid::create(mesh)),
+  grid(regular_grid ? nullptr : new ElementGrid(mesh)),
+  n_elements(mesh.getNElements()), n_threads(n_threads_), settings(settings_)
+{
+	if (regular_grid)
+		INFO ("Mesh is a regular grid of %dx%d cells, elements are located directly.",
+		      regular_grid->getNumberOfColumns(), regular_grid->getNumberOfRows());
+}
+
+void BinningContext::findElements(std::size_t n_points, double const* x, double const* y, std::size_t* elem_ids) const
+{
+	if (regular_grid)
+	{
+		regular_grid->findElements(n_points, x, y, elem_ids);
+		return;
+	}
+	for (std::size_t i=0; i<n_points; ++i)
+		elem_ids[i] = grid->findElement(x[i], y[i]);
+}
+
+void locatePoints(BinningContext const& context, PointSamples const& data_points,
+                  std::vector<std::size_t> &elem_ids, std::vector<double> &distances)
+{
+	std::size_t const n_points (data_points.size());
+	bool const needs_distances (context.settings.needsDistances());
+
+	elem_ids.resize(n_points);
+	distances.resize(needs_distances ? n_points : 0);
+	parallelFor(n_points, context.n_threads,
+		[&](std::size_t begin, std::size_t end, unsigned)
+		{
+			context.findElements(end - begin, data_points.x.data() + begin, data_points.y.data() + begin,
+			                     elem_ids.data() + begin);
+			if (!needs_distances)
+				return;
+			for (std::size_t i=begin; i<end; ++i)
+			{
+				if (elem_ids[i] == ElementGrid::not_found)
+					continue;
+				std::array<double, 2> const center (context.getElementCenter(elem_ids[i]));
+				distances[i] = std::hypot(data_points.x[i] - center[0], data_points.y[i] - center[1]);
+			}
+		});
+}
+
+std::vector<std::vector<double>> binPoints(BinningContext const& context, PointSamples const& data_points)
+{
+	std::vector<std::size_t> elem_ids;
+	std::vector<double> distances;
+	locatePoints(context, data_points, elem_ids, distances);
+	return aggregateCellValues(context.n_elements, elem_ids, distances,
+		data_points, context.settings, context.n_threads);
+}
+
+void binPoints(BinningContext const& context, PointSamples const& data_points, CellAggregator &aggregator)
+{
+	std::vector<std::size_t> elem_ids;
+	std::vector<double> distances;
+	locatePoints(context, data_points, elem_ids, distances);
+	aggregator.add(elem_ids, distances, data_points, context.n_threads);
+}
+
+} // end namespace ToolsLib
@@ -0,0 +1,83 @@
+/**
+ * @file   PointBinning.h
+ * @author Karsten Rink
+ * @date   2026/10/14
+ * @brief  Binning of scattered data points into the elements of a mesh
+ *
+ * @copyright
+ * Copyright (c) 2012-2026, OpenGeoSys Community (http://www.opengeosys.org)
+ *            Distributed under a Modified BSD License.
+ *              See accompanying file LICENSE.txt or
+ *              http://www.opengeosys.org/LICENSE.txt
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "CellAggregation.h"
+#include "ElementGrid.h"
+#include "RegularGrid.h"
+
+namespace MeshLib
+{
+	class Mesh;
+}
+
+namespace ToolsLib
+{
+
+struct PointSamples;
+
+/**
+ * The mesh projected onto the xy-plane together with its search structure.
+ * Only the xy-outlines of the elements are stored, hence no copy of the mesh
+ * is needed. The context is built once and any number of data channels can be
+ * binned against it. For regular grids (e.g. meshes created from rasters) the
+ * element containing a point is computed directly and no search structure is
+ * built.
+ */
+struct BinningContext
+{
+	BinningContext(MeshLib::Mesh const& mesh, unsigned n_threads_, AggregationSettings const& settings_);
+
+	/// Writes the IDs of the elements containing the points to elem_ids,
+	/// ElementGrid::not_found for points outside of the mesh.
+	void findElements(std::size_t n_points, double const* x, double const* y, std::size_t* elem_ids) const;
+
+	std::array<double, 2> getElementCenter(std::size_t elem_id) const
+	{
+		return regular_grid ? regular_grid->getElementCenter(elem_id) : grid->getElementCenter(elem_id);
+	}
+
+	std::unique_ptr<RegularGrid const> const regular_grid;
+	std::unique_ptr<ElementGrid const> const grid; ///< only for meshes other than regular grids
+	std::size_t const n_elements;
+	unsigned const n_threads;
+	AggregationSettings const settings;
+};
+
+/**
+ * Locates the data points in the mesh in parallel. Points outside of the mesh
+ * are marked with not_found and skipped when binning. Distances to the
+ * element centers are only computed if a statistic needs them.
+ */
+void locatePoints(BinningContext const& context, PointSamples const& data_points,
+                  std::vector<std::size_t> &elem_ids, std::vector<double> &distances);
+
+/**
+ * Computes the requested statistics of the data points located within each
+ * mesh element, separately for each channel of the samples. Points are
+ * located in parallel, afterwards all statistics of all channels are
+ * computed in a single pass (see aggregateCellValues()).
+ * @return one array per channel and statistic, ordered by channel first.
+ */
+std::vector<std::vector<double>> binPoints(BinningContext const& context, PointSamples const& data_points);
+
+/// Adds a chunk of data points to the running statistics of the elements.
+void binPoints(BinningContext const& context, PointSamples const& data_points, CellAggregator &aggregator);
+
+} // end namespace ToolsLib
@@ -0,0 +1,174 @@
+/**
+ * @file   PointSamples.cpp
+ * @author Karsten Rink
+ * @date   2026/10/14
+ * @brief  Contiguous storage and reading of scattered measurements
+ *
+ * @copyright
+ * Copyright (c) 2012-2026, OpenGeoSys Community (http://www.opengeosys.org)
+ *            Distributed under a Modified BSD License.
+ *              See accompanying file LICENSE.txt or
+ *              http://www.opengeosys.org/LICENSE.txt
+ */
+
+#include "PointSamples.h"
+
+#include <algorithm>
+
+// ThirdParty/logog
+#include "logog/include/logog.hpp"
+
+#include "MappedFile.h"
+#include "NumberParsing.h"
+
+namespace ToolsLib
+{
+
+namespace
+{
+/// Estimates the number of lines from the average length of the first lines.
+std::size_t estimateNumberOfLines(char const* begin, char const* end)
+{
+	std::size_t const n_sample_lines (64);
+	char const* pos (begin);
+	std::size_t n_lines (0);
+	for (; n_lines < n_sample_lines && pos < end; ++n_lines)
+		pos = findLineEnd(pos, end) + 1;
+	if (n_lines == 0)
+		return 0;
+	double const avg_length (static_cast<double>(std::min(pos, end) - begin) / n_lines);
+	return static_cast<std::size_t>((end - begin) / avg_length) + 1;
+}
+
+/// Parses the fields of the line [begin, line_end) given by columns into
+/// values. Columns beyond the last one needed are not looked at.
+/// @return true if all columns have been found and parsed.
+bool parseColumns(char const* begin, char const* line_end, char delim,
+                  std::vector<std::size_t> const& columns, std::vector<double> &values)
+{
+	std::size_t const n_slots (columns.size());
+	std::size_t const last_column (*std::max_element(columns.cbegin(), columns.cend()));
+	std::size_t n_values (0);
+	std::size_t column (0);
+	for (char const* field = begin; column <= last_column && field <= line_end; ++column)
+	{
+		char const* const field_end (findFieldEnd(field, line_end, delim));
+		for (std::size_t k=0; k<n_slots; ++k)
+		{
+			if (columns[k] != column)
+				continue;
+			if (!parseDouble(field, field_end, values[k]))
+				break;
+			n_values++;
+		}
+		field = field_end + 1;
+	}
+	return n_values == n_slots;
+}
+
+/// Returns the start of the first line beginning at or after the given
+/// fraction part/n_parts of the range.
+char const* getPartBegin(char const* begin, char const* end, std::size_t part, std::size_t n_parts)
+{
+	if (part == 0)
+		return begin;
+	if (part >= n_parts)
+		return end;
+	std::size_t const size (end - begin);
+	char const* const pos (begin + static_cast<std::size_t>(static_cast<double>(size) * part / n_parts));
+	if (pos == begin || *(pos - 1) == '\n')
+		return pos;
+	char const* const line_end (findLineEnd(pos, end));
+	return (line_end == end) ? end : line_end + 1;
+}
+}
+
+int readPointSamples(std::string const& file_name, char delim, std::size_t x_column, std::size_t y_column,
+                     std::vector<std::size_t> const& value_columns, PointSamples &samples)
+{
+	return readPointSamples(file_name, delim, x_column, y_column, value_columns, 0, 1, samples);
+}
+
+int readPointSamples(std::string const& file_name, char delim, std::size_t x_column, std::size_t y_column,
+                     std::vector<std::size_t> const& value_columns, std::size_t part, std::size_t n_parts,
+                     PointSamples &samples)
+{
+	if (value_columns.size() != samples.n_channels)
+	{
+		ERR ("readPointSamples(): Number of columns does not match the number of channels.");
+		return -1;
+	}
+
+	MappedFile const file(file_name);
+	if (!file.isOpen())
+	{
+		ERR ("readPointSamples(): Could not open file %s.", file_name.c_str());
+		return -1;
+	}
+
+	char const* pos (getPartBegin(file.begin(), file.end(), part, n_parts));
+	char const* const end (getPartBegin(file.begin(), file.end(), part + 1, n_parts));
+	samples.reserve(samples.size() + estimateNumberOfLines(pos, end));
+
+	// slot 0 and 1 hold the coordinates, followed by the channel values
+	std::vector<std::size_t> columns { x_column, y_column };
+	columns.insert(columns.end(), value_columns.cbegin(), value_columns.cend());
+	std::vector<double> values (columns.size());
+	std::size_t line_count (0);
+	std::size_t error_count (0);
+	while (pos < end)
+	{
+		char const* const line_end (findLineEnd(pos, end));
+		line_count++;
+
+		if (parseColumns(pos, line_end, delim, columns, values))
+			samples.push_back(values[0], values[1], &values[2]);
+		else if (line_end != pos)
+		{
+			ERR ("Error reading line %d of file %s, skipping line...", line_count, file_name.c_str());
+			error_count++;
+		}
+		pos = line_end + 1;
+	}
+	return error_count;
+}
+
+PointSampleReader::PointSampleReader(std::string const& file_name, char delim,
+                                     std::size_t x_column, std::size_t y_column,
+                                     std::vector<std::size_t> const& value_columns)
+: _file_name(file_name), _in(file_name.c_str()), _delim(delim), _columns { x_column, y_column }
+{
+	_columns.insert(_columns.end(), value_columns.cbegin(), value_columns.cend());
+	_values.resize(_columns.size());
+}
+
+bool PointSampleReader::read(std::size_t n_points, PointSamples &samples)
+{
+	samples.x.clear();
+	samples.y.clear();
+	samples.values.clear();
+	if (samples.n_channels + 2 != _columns.size())
+	{
+		ERR ("PointSampleReader::read(): Number of columns does not match the number of channels.");
+		return false;
+	}
+
+	samples.reserve(n_points);
+	while (samples.size() < n_points && std::getline(_in, _line))
+	{
+		_line_count++;
+		_bytes_read += _line.size() + (_in.eof() ? 0 : 1);
+		char const* const begin (_line.data());
+		char const* const end (begin + _line.size());
+		if (parseColumns(begin, end, _delim, _columns, _values))
+			samples.push_back(_values[0], _values[1], &_values[2]);
+		else if (begin != end)
+		{
+			ERR ("Error reading line %d of file %s, skipping line...", _line_count, _file_name.c_str());
+			_error_count++;
+		}
+	}
+	return samples.size() > 0;
+}
+
+} // end namespace ToolsLib
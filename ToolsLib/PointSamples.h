@@ -0,0 +1,120 @@
+/**
+ * @file   PointSamples.h
+ * @author Karsten Rink
+ * @date   2026/10/14
+ * @brief  Contiguous storage and reading of scattered measurements
+ *
+ * @copyright
+ * Copyright (c) 2012-2026, OpenGeoSys Community (http://www.opengeosys.org)
+ *            Distributed under a Modified BSD License.
+ *              See accompanying file LICENSE.txt or
+ *              http://www.opengeosys.org/LICENSE.txt
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace ToolsLib
+{
+
+/// Scattered measurements stored as structure of arrays, i.e. coordinates
+/// and values are kept in separate contiguous arrays. Each point carries the
+/// values of n_channels data channels, stored interleaved.
+struct PointSamples
+{
+	explicit PointSamples(std::size_t n_channels_ = 1) : n_channels(n_channels_) {}
+
+	std::size_t n_channels;
+	std::vector<double> x;
+	std::vector<double> y;
+	std::vector<double> values;
+
+	std::size_t size() const { return x.size(); }
+
+	double getValue(std::size_t i, std::size_t channel) const { return values[i * n_channels + channel]; }
+
+	void reserve(std::size_t n)
+	{
+		x.reserve(n);
+		y.reserve(n);
+		values.reserve(n * n_channels);
+	}
+
+	/// Adds a point, \c values_ points to the values of all channels.
+	void push_back(double x_, double y_, double const* values_)
+	{
+		x.push_back(x_);
+		y.push_back(y_);
+		values.insert(values.end(), values_, values_ + n_channels);
+	}
+};
+
+/**
+ * Appends the samples of a delimiter separated file to \c samples. The file is
+ * memory mapped and the arrays are pre-sized based on the file length and the
+ * length of the first lines, values are parsed in place. All channels are
+ * read in the same pass over the file.
+ * @param x_column Index of the x-column.
+ * @param y_column Index of the y-column.
+ * @param value_columns Index of the value-column of each channel.
+ * @return -1 if the file cannot be read, otherwise the number of lines that
+ * have been skipped because they could not be parsed (e.g. a header).
+ */
+int readPointSamples(std::string const& file_name, char delim, std::size_t x_column, std::size_t y_column,
+                     std::vector<std::size_t> const& value_columns, PointSamples &samples);
+
+/**
+ * Reads one of n_parts consecutive ranges of about the same size of the file
+ * as readPointSamples() does for the complete file, e.g. for reading a file
+ * on several processes. Each line belongs to the range it starts in, so the
+ * parts together contain every line exactly once and in file order. Line
+ * numbers in error messages are counted from the beginning of the part.
+ */
+int readPointSamples(std::string const& file_name, char delim, std::size_t x_column, std::size_t y_column,
+                     std::vector<std::size_t> const& value_columns, std::size_t part, std::size_t n_parts,
+                     PointSamples &samples);
+
+/**
+ * Reads the samples of a delimiter separated file in chunks of a fixed number
+ * of points, such that files larger than the available memory can be
+ * processed. Lines are parsed as in readPointSamples(), but the file is read
+ * sequentially through a single line buffer instead of being mapped.
+ */
+class PointSampleReader
+{
+public:
+	PointSampleReader(std::string const& file_name, char delim, std::size_t x_column, std::size_t y_column,
+	                  std::vector<std::size_t> const& value_columns);
+
+	bool isOpen() const { return _in.is_open(); }
+
+	/// Replaces the content of \c samples by the next (at most) n_points
+	/// points of the file.
+	/// @return false if the end of the file has been reached and no point has
+	/// been read.
+	bool read(std::size_t n_points, PointSamples &samples);
+
+	/// Number of lines skipped so far because they could not be parsed.
+	std::size_t getNumberOfErrors() const { return _error_count; }
+
+	/// Number of bytes consumed so far, including line breaks.
+	std::size_t getBytesRead() const { return _bytes_read; }
+
+private:
+	std::string const _file_name;
+	std::ifstream _in;
+	char const _delim;
+	/// slot 0 and 1 hold the coordinates, followed by the channel values
+	std::vector<std::size_t> _columns;
+	std::vector<double> _values;
+	std::string _line;
+	std::size_t _line_count = 0;
+	std::size_t _error_count = 0;
+	std::size_t _bytes_read = 0;
+};
+
+} // end namespace ToolsLib
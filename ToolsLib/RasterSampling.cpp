@@ -0,0 +1,111 @@
+/**
+ * @file   RasterSampling.cpp
+ * @author Karsten Rink
+ * @date   2026/10/14
+ * @brief  Batch sampling of raster data at many points
+ *
+ * @copyright
+ * Copyright (c) 2012-2026, OpenGeoSys Community (http://www.opengeosys.org)
+ *            Distributed under a Modified BSD License.
+ *              See accompanying file LICENSE.txt or
+ *              http://www.opengeosys.org/LICENSE.txt
+ */
+
+#include "RasterSampling.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "GeoLib/Raster.h"
+
+namespace ToolsLib
+{
+
+RasterView makeRasterView(GeoLib::Raster const& raster)
+{
+	GeoLib::RasterHeader const& header (raster.getHeader());
+	RasterView const view = { header.n_cols, header.n_rows, header.origin[0], header.origin[1],
+	                          header.cell_size, header.no_data, &(*raster.begin()) };
+	return view;
+}
+
+namespace
+{
+void sampleNearest(RasterView const& raster, double const* xy, std::size_t n, double* values)
+{
+	double const x_max (raster.x0 + raster.cell_size * raster.n_cols);
+	double const y_max (raster.y0 + raster.cell_size * raster.n_rows);
+	for (std::size_t i=0; i<n; ++i)
+	{
+		double const x (xy[2*i]);
+		double const y (xy[2*i+1]);
+		bool const inside (x >= raster.x0 && x < x_max && y >= raster.y0 && y < y_max);
+		// Indices are clamped such that the lookup is valid for any point. The
+		// division (rather than a multiplication by the inverse) assigns points
+		// on cell edges to the same cell as Raster::getValueAtPoint().
+		std::size_t const col (std::min(raster.n_cols - 1,
+			static_cast<std::size_t>(std::max(0.0, (x - raster.x0) / raster.cell_size))));
+		std::size_t const row (std::min(raster.n_rows - 1,
+			static_cast<std::size_t>(std::max(0.0, (y - raster.y0) / raster.cell_size))));
+		double const value (raster.data[row * raster.n_cols + col]);
+		values[i] = inside ? value : raster.no_data;
+	}
+}
+
+void sampleBilinear(RasterView const& raster, double const* xy, std::size_t n, double* values)
+{
+	double const inv_cell_size (1.0 / raster.cell_size);
+	double const x_max (raster.x0 + raster.cell_size * raster.n_cols);
+	double const y_max (raster.y0 + raster.cell_size * raster.n_rows);
+	std::size_t const max_col (raster.n_cols > 1 ? raster.n_cols - 2 : 0);
+	std::size_t const max_row (raster.n_rows > 1 ? raster.n_rows - 2 : 0);
+	std::size_t const col_step (raster.n_cols > 1 ? 1 : 0);
+	std::size_t const row_step (raster.n_rows > 1 ? raster.n_cols : 0);
+	for (std::size_t i=0; i<n; ++i)
+	{
+		double const x (xy[2*i]);
+		double const y (xy[2*i+1]);
+		bool const inside (x >= raster.x0 && x < x_max && y >= raster.y0 && y < y_max);
+
+		// position relative to the cell centres, clamped to the outermost ones
+		double const fx (std::max(0.0, (x - raster.x0) * inv_cell_size - 0.5));
+		double const fy (std::max(0.0, (y - raster.y0) * inv_cell_size - 0.5));
+		std::size_t const col (std::min(max_col, static_cast<std::size_t>(fx)));
+		std::size_t const row (std::min(max_row, static_cast<std::size_t>(fy)));
+		double const tx (std::min(1.0, fx - col));
+		double const ty (std::min(1.0, fy - row));
+
+		std::size_t const idx (row * raster.n_cols + col);
+		double const v[4] = { raster.data[idx], raster.data[idx + col_step],
+		                      raster.data[idx + row_step], raster.data[idx + row_step + col_step] };
+		double const w[4] = { (1-tx)*(1-ty), tx*(1-ty), (1-tx)*ty, tx*ty };
+
+		double sum (0);
+		double weight (0);
+		for (std::size_t k=0; k<4; ++k)
+		{
+			double const valid (v[k] != raster.no_data ? 1.0 : 0.0);
+			sum += valid * w[k] * v[k];
+			weight += valid * w[k];
+		}
+		values[i] = (inside && weight > 0) ? sum / weight : raster.no_data;
+	}
+}
+}
+
+void sampleRaster(RasterView const& raster, double const* xy, std::size_t n,
+                  double* values, RasterInterpolation method)
+{
+	if (raster.n_cols == 0 || raster.n_rows == 0)
+	{
+		std::fill(values, values + n, raster.no_data);
+		return;
+	}
+
+	if (method == RasterInterpolation::Bilinear)
+		sampleBilinear(raster, xy, n, values);
+	else
+		sampleNearest(raster, xy, n, values);
+}
+
+} // end namespace ToolsLib
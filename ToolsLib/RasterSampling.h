@@ -0,0 +1,58 @@
+/**
+ * @file   RasterSampling.h
+ * @author Karsten Rink
+ * @date   2026/10/14
+ * @brief  Batch sampling of raster data at many points
+ *
+ * @copyright
+ * Copyright (c) 2012-2026, OpenGeoSys Community (http://www.opengeosys.org)
+ *            Distributed under a Modified BSD License.
+ *              See accompanying file LICENSE.txt or
+ *              http://www.opengeosys.org/LICENSE.txt
+ */
+
+#pragma once
+
+#include <cstddef>
+
+namespace GeoLib
+{
+	class Raster;
+}
+
+namespace ToolsLib
+{
+
+/// Non-owning view onto raster data. Values are stored row by row starting
+/// with the row at the lower left corner, i.e. the layout of GeoLib::Raster.
+struct RasterView
+{
+	std::size_t n_cols;
+	std::size_t n_rows;
+	double x0; ///< x-coordinate of the lower left corner
+	double y0; ///< y-coordinate of the lower left corner
+	double cell_size;
+	double no_data;
+	double const* data;
+};
+
+/// Returns a view onto the data of the given raster.
+RasterView makeRasterView(GeoLib::Raster const& raster);
+
+enum class RasterInterpolation
+{
+	Nearest,  ///< value of the cell containing the point (as Raster::getValueAtPoint())
+	Bilinear  ///< bilinear interpolation between the centres of the adjacent cells
+};
+
+/**
+ * Samples the raster at \c n points. Coordinates are given interleaved as
+ * x0, y0, x1, y1, ... and the results are written to \c values. Points outside
+ * of the raster are assigned the no-data value. For bilinear interpolation
+ * no-data cells are ignored and the weights of the remaining cells are
+ * normalised.
+ */
+void sampleRaster(RasterView const& raster, double const* xy, std::size_t n,
+                  double* values, RasterInterpolation method);
+
+} // end namespace ToolsLib
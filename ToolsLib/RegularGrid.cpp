@@ -0,0 +1,239 @@
+/**
+ * @file   RegularGrid.cpp
+ * @author Karsten Rink
+ * @date   2026/10/14
+ * @brief  Direct cell lookup for meshes on regular axis-aligned grids
+ *
+ * @copyright
+ * Copyright (c) 2012-2026, OpenGeoSys Community (http://www.opengeosys.org)
+ *            Distributed under a Modified BSD License.
+ *              See accompanying file LICENSE.txt or
+ *              http://www.opengeosys.org/LICENSE.txt
+ */
+
+#include "RegularGrid.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <limits>
+
+// ThirdParty/logog
+#include "logog/include/logog.hpp"
+
+#include "MeshLib/Mesh.h"
+#include "MeshLib/Node.h"
+#include "MeshLib/Elements/Element.h"
+
+namespace ToolsLib
+{
+
+std::size_t const RegularGrid::not_found = std::numeric_limits<std::size_t>::max();
+
+namespace
+{
+/// Tolerance for element corners relative to the edge length of the cells.
+double const relative_tolerance (1e-4);
+
+/// Returns the bounding rectangle (x_min, y_min, x_max, y_max) of the element
+/// if it is an axis-aligned rectangle.
+bool getRectangle(MeshLib::Element const& elem, std::array<double, 4> &rect)
+{
+	if (elem.getDimension() != 2 || elem.getNBaseNodes() != 4)
+		return false;
+
+	rect = {{ std::numeric_limits<double>::max(), std::numeric_limits<double>::max(),
+	          std::numeric_limits<double>::lowest(), std::numeric_limits<double>::lowest() }};
+	for (unsigned j=0; j<4; ++j)
+	{
+		MeshLib::Node const& node (*elem.getNode(j));
+		for (std::size_t d=0; d<2; ++d)
+		{
+			rect[d] = std::min(rect[d], node[d]);
+			rect[d+2] = std::max(rect[d+2], node[d]);
+		}
+	}
+	double const width (rect[2] - rect[0]);
+	double const height (rect[3] - rect[1]);
+	if (width <= 0 || height <= 0)
+		return false;
+
+	// all nodes have to be corners of the rectangle
+	for (unsigned j=0; j<4; ++j)
+	{
+		MeshLib::Node const& node (*elem.getNode(j));
+		double const tol_x (relative_tolerance * width);
+		double const tol_y (relative_tolerance * height);
+		if ((std::abs(node[0] - rect[0]) > tol_x && std::abs(node[0] - rect[2]) > tol_x) ||
+		    (std::abs(node[1] - rect[1]) > tol_y && std::abs(node[1] - rect[3]) > tol_y))
+			return false;
+	}
+	return true;
+}
+
+/// Returns the lattice index of the coordinate if it is on the lattice.
+bool getLatticeIndex(double value, double origin, double cell_size, std::size_t n, std::size_t &idx)
+{
+	double const position ((value - origin) / cell_size);
+	double const rounded (std::round(position));
+	if (std::abs(position - rounded) > relative_tolerance || rounded < 0 || rounded >= n)
+		return false;
+	idx = static_cast<std::size_t>(rounded);
+	return true;
+}
+} // end anonymous namespace
+
+RegularGrid::RegularGrid(double x0, double y0, double dx, double dy, std::size_t n_cols, std::size_t n_rows)
+: _x0(x0), _y0(y0), _dx(dx), _dy(dy), _n_cols(n_cols), _n_rows(n_rows), _n_elements(n_cols * n_rows)
+{}
+
+std::unique_ptr<RegularGrid> RegularGrid::create(MeshLib::Mesh const& mesh)
+{
+	std::vector<MeshLib::Element*> const& elements (mesh.getElements());
+	std::size_t const n_elems (elements.size());
+	if (n_elems == 0)
+		return nullptr;
+
+	std::vector<std::array<double, 4>> rects(n_elems);
+	for (std::size_t i=0; i<n_elems; ++i)
+		if (!getRectangle(*elements[i], rects[i]))
+			return nullptr;
+
+	double const dx (rects[0][2] - rects[0][0]);
+	double const dy (rects[0][3] - rects[0][1]);
+	std::array<double, 4> bounds (rects[0]);
+	for (std::array<double, 4> const& rect : rects)
+	{
+		if (std::abs(rect[2] - rect[0] - dx) > relative_tolerance * dx ||
+		    std::abs(rect[3] - rect[1] - dy) > relative_tolerance * dy)
+			return nullptr;
+		bounds[0] = std::min(bounds[0], rect[0]);
+		bounds[1] = std::min(bounds[1], rect[1]);
+		bounds[2] = std::max(bounds[2], rect[2]);
+		bounds[3] = std::max(bounds[3], rect[3]);
+	}
+
+	double const n_cols (std::round((bounds[2] - bounds[0]) / dx));
+	double const n_rows (std::round((bounds[3] - bounds[1]) / dy));
+	if (n_cols * n_rows > 4.0 * n_elems)
+		return nullptr;
+
+	std::unique_ptr<RegularGrid> grid (new RegularGrid(bounds[0], bounds[1], dx, dy,
+		static_cast<std::size_t>(n_cols), static_cast<std::size_t>(n_rows)));
+	std::vector<std::size_t> cell_elements(grid->_n_cols * grid->_n_rows, not_found);
+	std::vector<std::size_t> element_cells(n_elems);
+	bool is_identity (n_elems == cell_elements.size());
+	for (std::size_t i=0; i<n_elems; ++i)
+	{
+		std::size_t col (0);
+		std::size_t row (0);
+		if (!getLatticeIndex(rects[i][0], grid->_x0, dx, grid->_n_cols, col) ||
+		    !getLatticeIndex(rects[i][1], grid->_y0, dy, grid->_n_rows, row))
+			return nullptr;
+		std::size_t const cell (row * grid->_n_cols + col);
+		if (cell_elements[cell] != not_found)
+			return nullptr;
+		cell_elements[cell] = i;
+		element_cells[i] = cell;
+		is_identity = is_identity && (cell == i);
+	}
+
+	grid->_n_elements = n_elems;
+	if (!is_identity)
+	{
+		grid->_cell_elements = std::move(cell_elements);
+		grid->_element_cells = std::move(element_cells);
+	}
+	return grid;
+}
+
+void RegularGrid::findElements(std::size_t n_points, double const* x, double const* y, std::size_t* elem_ids) const
+{
+	double const n_cols (static_cast<double>(_n_cols));
+	double const n_rows (static_cast<double>(_n_rows));
+	long long const n_cols_int (static_cast<long long>(_n_cols));
+	for (std::size_t i=0; i<n_points; ++i)
+	{
+		double const fx ((x[i] - _x0) / _dx);
+		double const fy ((y[i] - _y0) / _dy);
+		// non-short-circuit tests keep the loop free of branches
+		bool const is_inside ((fx >= 0) & (fx <= n_cols) & (fy >= 0) & (fy <= n_rows));
+		// points on the upper boundaries belong to the last column or row
+		double const col (is_inside ? std::min(fx, n_cols - 1) : 0);
+		double const row (is_inside ? std::min(fy, n_rows - 1) : 0);
+		// signed conversions have vector instructions, unsigned ones do not
+		long long const cell (static_cast<long long>(row) * n_cols_int + static_cast<long long>(col));
+		elem_ids[i] = is_inside ? static_cast<std::size_t>(cell) : not_found;
+	}
+
+	if (_cell_elements.empty())
+		return;
+	for (std::size_t i=0; i<n_points; ++i)
+		if (elem_ids[i] != not_found)
+			elem_ids[i] = _cell_elements[elem_ids[i]];
+}
+
+std::array<double, 2> RegularGrid::getElementCenter(std::size_t elem_id) const
+{
+	std::size_t const cell (_element_cells.empty() ? elem_id : _element_cells[elem_id]);
+	std::size_t const row (cell / _n_cols);
+	std::size_t const col (cell % _n_cols);
+	return {{ _x0 + (col + 0.5) * _dx, _y0 + (row + 0.5) * _dy }};
+}
+
+std::size_t RegularGrid::getElement(std::size_t row, std::size_t col) const
+{
+	std::size_t const cell (row * _n_cols + col);
+	return _cell_elements.empty() ? cell : _cell_elements[cell];
+}
+
+bool writeAscRaster(RegularGrid const& grid, std::vector<double> const& values,
+                    std::string const& file_name, double no_data)
+{
+	std::array<double, 2> const cell_size (grid.getCellSize());
+	if (std::abs(cell_size[0] - cell_size[1]) > relative_tolerance * cell_size[0])
+	{
+		ERR ("writeAscRaster(): Raster files require square cells.");
+		return false;
+	}
+	if (values.size() != grid.getNumberOfElements())
+	{
+		ERR ("writeAscRaster(): Number of values does not match the number of elements.");
+		return false;
+	}
+
+	std::ofstream out(file_name.c_str());
+	if (!out.is_open())
+	{
+		ERR ("writeAscRaster(): Could not open file %s.", file_name.c_str());
+		return false;
+	}
+
+	std::array<double, 2> const origin (grid.getOrigin());
+	std::size_t const n_cols (grid.getNumberOfColumns());
+	std::size_t const n_rows (grid.getNumberOfRows());
+	out.precision(std::numeric_limits<double>::digits10);
+	out << "ncols " << n_cols << "\n"
+	    << "nrows " << n_rows << "\n"
+	    << "xllcorner " << origin[0] << "\n"
+	    << "yllcorner " << origin[1] << "\n"
+	    << "cellsize " << cell_size[0] << "\n"
+	    << "NODATA_value " << no_data << "\n";
+
+	// rows are written from the top
+	out.precision(std::numeric_limits<float>::digits10 + 2);
+	for (std::size_t r=n_rows; r-- > 0; )
+	{
+		for (std::size_t c=0; c<n_cols; ++c)
+		{
+			std::size_t const elem_id (grid.getElement(r, c));
+			double const value ((elem_id == RegularGrid::not_found || std::isnan(values[elem_id])) ?
+				no_data : values[elem_id]);
+			out << ((c == 0) ? "" : " ") << value;
+		}
+		out << "\n";
+	}
+	return out.good();
+}
+
+} // end namespace ToolsLib
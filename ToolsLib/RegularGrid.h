@@ -0,0 +1,96 @@
+/**
+ * @file   RegularGrid.h
+ * @author Karsten Rink
+ * @date   2026/10/14
+ * @brief  Direct cell lookup for meshes on regular axis-aligned grids
+ *
+ * @copyright
+ * Copyright (c) 2012-2026, OpenGeoSys Community (http://www.opengeosys.org)
+ *            Distributed under a Modified BSD License.
+ *              See accompanying file LICENSE.txt or
+ *              http://www.opengeosys.org/LICENSE.txt
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace MeshLib
+{
+	class Mesh;
+}
+
+namespace ToolsLib
+{
+
+/**
+ * A mesh whose elements are axis-aligned rectangles of the same size placed
+ * on a common lattice, e.g. a mesh created from a raster. Lattice cells
+ * without an element (such as no-data pixels) are allowed. The cell
+ * containing a point is computed directly from its coordinates as
+ * floor((x - x0) / dx), floor((y - y0) / dy) instead of searching the
+ * elements. Points on an edge shared by two cells are assigned to the upper
+ * (or right) cell, points on the outer boundary to the adjacent cell.
+ */
+class RegularGrid
+{
+public:
+	/// Returns the grid of the mesh if it is a regular grid (z-coordinates
+	/// are ignored), nullptr otherwise. Grids with more than four lattice
+	/// cells per element are not considered regular.
+	static std::unique_ptr<RegularGrid> create(MeshLib::Mesh const& mesh);
+
+	/// Writes the IDs of the elements containing the points to elem_ids,
+	/// not_found for points outside of all elements. Rows and columns are
+	/// computed in a branch-free loop the compiler can vectorise.
+	void findElements(std::size_t n_points, double const* x, double const* y, std::size_t* elem_ids) const;
+
+	/// Returns the center of the given element.
+	std::array<double, 2> getElementCenter(std::size_t elem_id) const;
+
+	/// Returns the ID of the element at the given lattice position, rows are
+	/// counted from the lower left corner, or not_found if there is none.
+	std::size_t getElement(std::size_t row, std::size_t col) const;
+
+	std::size_t getNumberOfElements() const { return _n_elements; }
+	std::size_t getNumberOfColumns() const { return _n_cols; }
+	std::size_t getNumberOfRows() const { return _n_rows; }
+
+	/// Lower left corner of the grid.
+	std::array<double, 2> getOrigin() const { return {{ _x0, _y0 }}; }
+
+	/// Edge lengths of the cells.
+	std::array<double, 2> getCellSize() const { return {{ _dx, _dy }}; }
+
+	static std::size_t const not_found;
+
+private:
+	RegularGrid(double x0, double y0, double dx, double dy, std::size_t n_cols, std::size_t n_rows);
+
+	double _x0;
+	double _y0;
+	double _dx;
+	double _dy;
+	std::size_t _n_cols;
+	std::size_t _n_rows;
+	std::size_t _n_elements;
+
+	/// Element of each lattice cell and lattice cell of each element. Both
+	/// are empty if element i is lattice cell i for all cells.
+	std::vector<std::size_t> _cell_elements;
+	std::vector<std::size_t> _element_cells;
+};
+
+/**
+ * Writes one value per element of the grid as ESRI ASCII raster (*.asc).
+ * Lattice cells without an element and NaN values are written as no_data.
+ * @return false if the cells are not square or the file cannot be written.
+ */
+bool writeAscRaster(RegularGrid const& grid, std::vector<double> const& values,
+                    std::string const& file_name, double no_data = -9999);
+
+} // end namespace ToolsLib
@@ -0,0 +1,148 @@
+/**
+ * @file   StructuredGrid.cpp
+ * @author Karsten Rink
+ * @date   2026/10/14
+ * @brief  Implicit representation of logically structured quad grids
+ *
+ * @copyright
+ * Copyright (c) 2012-2026, OpenGeoSys Community (http://www.opengeosys.org)
+ *            Distributed under a Modified BSD License.
+ *              See accompanying file LICENSE.txt or
+ *              http://www.opengeosys.org/LICENSE.txt
+ */
+
+#include "StructuredGrid.h"
+
+#include <fstream>
+#include <utility>
+
+// ThirdParty/logog
+#include "logog/include/logog.hpp"
+
+#include "MeshLib/Mesh.h"
+#include "MeshLib/Properties.h"
+#include "MeshLib/PropertyVector.h"
+
+#include "StructuredQuadMesh.h"
+
+namespace ToolsLib
+{
+
+StructuredGrid::StructuredGrid(std::size_t n_rows, std::size_t n_cols,
+	std::vector<double> x, std::vector<double> y, std::vector<double> z)
+: _n_rows(n_rows), _n_cols(n_cols), _x(std::move(x)), _y(std::move(y)), _z(std::move(z))
+{
+}
+
+std::unique_ptr<StructuredGrid> StructuredGrid::create(std::size_t n_rows, std::size_t n_cols,
+	std::vector<double> x, std::vector<double> y, std::vector<double> z)
+{
+	std::size_t const n_nodes (n_rows * n_cols);
+	if (n_rows < 2 || n_cols < 2 || x.size() != y.size() ||
+	    (x.size() != n_cols && x.size() != n_nodes) ||
+	    (z.size() != n_rows && z.size() != n_nodes))
+	{
+		ERR ("StructuredGrid::create(): Coordinate arrays do not match a %d x %d grid.", n_rows, n_cols);
+		return nullptr;
+	}
+	return std::unique_ptr<StructuredGrid>(
+		new StructuredGrid(n_rows, n_cols, std::move(x), std::move(y), std::move(z)));
+}
+
+bool StructuredGrid::addCellData(std::string const& name, std::vector<double> values, unsigned n_components,
+	bool single_precision)
+{
+	if (n_components == 0 || values.size() != getNumberOfCells() * n_components)
+	{
+		WARN ("StructuredGrid::addCellData(): Size of array \"%s\" does not match the grid.", name.c_str());
+		return false;
+	}
+	CellData data = { name, n_components, std::vector<double>(), std::vector<float>() };
+	if (single_precision)
+		data.float_values.assign(values.cbegin(), values.cend());
+	else
+		data.values = std::move(values);
+	_cell_data.push_back(std::move(data));
+	return true;
+}
+
+bool StructuredGrid::writeVts(std::string const& file_name,
+	VtkAppendedData::Encoding encoding, unsigned n_threads, bool compact_material_ids) const
+{
+	std::ofstream out(file_name.c_str(), std::ios::binary);
+	if (!out.is_open())
+	{
+		ERR ("StructuredGrid::writeVts(): Could not open file %s.", file_name.c_str());
+		return false;
+	}
+
+	std::vector<double> points;
+	points.reserve(3 * getNumberOfNodes());
+	for (std::size_t r=0; r<_n_rows; ++r)
+		for (std::size_t c=0; c<_n_cols; ++c)
+		{
+			std::array<double, 3> const pnt (getNodeCoordinates(r, c));
+			points.insert(points.end(), pnt.begin(), pnt.end());
+		}
+
+	bool const uint8_materials (compact_material_ids && _n_rows - 1 <= 256);
+	std::vector<std::int32_t> materials;
+	std::vector<std::uint8_t> compact_materials;
+	for (std::size_t r=0; r<_n_rows-1; ++r)
+	{
+		if (uint8_materials)
+			compact_materials.insert(compact_materials.end(), _n_cols-1, static_cast<std::uint8_t>(r));
+		else
+			materials.insert(materials.end(), _n_cols-1, static_cast<std::int32_t>(r));
+	}
+
+	VtkAppendedData appended(encoding, n_threads);
+	std::string const extent ("0 " + std::to_string(_n_cols-1) + " 0 " + std::to_string(_n_rows-1) + " 0 0");
+	out << "<?xml version=\"1.0\"?>\n"
+	    << "<VTKFile type=\"StructuredGrid\" version=\"1.0\" " << appended.getFileAttributes() << ">\n"
+	    << "  <StructuredGrid WholeExtent=\"" << extent << "\">\n"
+	    << "    <Piece Extent=\"" << extent << "\">\n"
+	    << "      <CellData>\n"
+	    << "        " << (uint8_materials ?
+	           appended.addDataArray("MaterialIDs", 1, compact_materials.data(), compact_materials.size()) :
+	           appended.addDataArray("MaterialIDs", 1, materials.data(), materials.size())) << "\n";
+	for (CellData const& data : _cell_data)
+		out << "        " << (data.float_values.empty() ?
+		       appended.addDataArray(data.name, data.n_components, data.values.data(), data.values.size()) :
+		       appended.addDataArray(data.name, data.n_components, data.float_values.data(), data.float_values.size())) << "\n";
+	out << "      </CellData>\n"
+	    << "      <Points>\n"
+	    << "        " << appended.addDataArray("Points", 3, points.data(), points.size()) << "\n"
+	    << "      </Points>\n"
+	    << "    </Piece>\n"
+	    << "  </StructuredGrid>\n";
+	if (!appended.write(out))
+		return false;
+	out << "</VTKFile>\n";
+	return out.good();
+}
+
+std::unique_ptr<MeshLib::Mesh> StructuredGrid::toMesh(std::string const& mesh_name) const
+{
+	auto const node_coords = [this](std::size_t r, std::size_t c) { return getNodeCoordinates(r, c); };
+	std::unique_ptr<MeshLib::Mesh> mesh (
+		createStructuredQuadMesh(mesh_name, _n_rows, _n_cols, _n_rows-1, node_coords));
+	for (CellData const& data : _cell_data)
+	{
+		if (data.float_values.empty())
+		{
+			boost::optional<MeshLib::PropertyVector<double>&> prop (mesh->getProperties().createNewPropertyVector<double>(
+				data.name, MeshLib::MeshItemType::Cell, data.n_components));
+			prop->insert(prop->end(), data.values.cbegin(), data.values.cend());
+		}
+		else
+		{
+			boost::optional<MeshLib::PropertyVector<float>&> prop (mesh->getProperties().createNewPropertyVector<float>(
+				data.name, MeshLib::MeshItemType::Cell, data.n_components));
+			prop->insert(prop->end(), data.float_values.cbegin(), data.float_values.cend());
+		}
+	}
+	return mesh;
+}
+
+} // end namespace ToolsLib
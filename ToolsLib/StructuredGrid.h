@@ -0,0 +1,105 @@
+/**
+ * @file   StructuredGrid.h
+ * @author Karsten Rink
+ * @date   2026/10/14
+ * @brief  Implicit representation of logically structured quad grids
+ *
+ * @copyright
+ * Copyright (c) 2012-2026, OpenGeoSys Community (http://www.opengeosys.org)
+ *            Distributed under a Modified BSD License.
+ *              See accompanying file LICENSE.txt or
+ *              http://www.opengeosys.org/LICENSE.txt
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "VtkAppendedData.h"
+
+namespace MeshLib {
+	class Mesh;
+}
+
+namespace ToolsLib
+{
+
+/**
+ * A two-dimensional grid of n_rows x n_cols nodes in 3d space where quad
+ * (r, c) connects the nodes (r, c), (r+1, c), (r+1, c+1) and (r, c+1).
+ * Instead of explicit nodes and elements only the coordinate arrays are
+ * stored: x and y are given either per column (vertical profiles) or per
+ * node, z either per row or per node. Nodes and cells are numbered row by
+ * row, the material ID of a cell is its row.
+ */
+class StructuredGrid
+{
+public:
+	/// Creates the grid, returns nullptr if the array sizes do not match
+	/// any of the supported layouts.
+	static std::unique_ptr<StructuredGrid> create(std::size_t n_rows, std::size_t n_cols,
+		std::vector<double> x, std::vector<double> y, std::vector<double> z);
+
+	std::size_t getNumberOfRows() const { return _n_rows; }
+	std::size_t getNumberOfColumns() const { return _n_cols; }
+	std::size_t getNumberOfNodes() const { return _n_rows * _n_cols; }
+	std::size_t getNumberOfCells() const { return (_n_rows - 1) * (_n_cols - 1); }
+
+	std::array<double, 3> getNodeCoordinates(std::size_t r, std::size_t c) const
+	{
+		std::size_t const node_id (r * _n_cols + c);
+		std::size_t const xy_id ((_x.size() == _n_cols) ? c : node_id);
+		std::size_t const z_id ((_z.size() == _n_rows) ? r : node_id);
+		return {{ _x[xy_id], _y[xy_id], _z[z_id] }};
+	}
+
+	/// Node ids of the given cell in counter-clockwise order.
+	std::array<std::size_t, 4> getCellNodeIds(std::size_t cell_id) const
+	{
+		std::size_t const r (cell_id / (_n_cols - 1));
+		std::size_t const node_id (r * _n_cols + cell_id % (_n_cols - 1));
+		return {{ node_id, node_id + _n_cols, node_id + _n_cols + 1, node_id + 1 }};
+	}
+
+	/// Adds a cell array with the given number of interleaved components,
+	/// optionally stored and written with single precision.
+	/// Returns false if the number of values does not match the grid.
+	bool addCellData(std::string const& name, std::vector<double> values, unsigned n_components = 1,
+	                 bool single_precision = false);
+
+	/// Writes the grid as VTK XML StructuredGrid (*.vts) with raw binary or
+	/// compressed appended data. With compact_material_ids the material IDs
+	/// are written as UInt8 if there are at most 256 rows of cells.
+	bool writeVts(std::string const& file_name,
+	              VtkAppendedData::Encoding encoding = VtkAppendedData::Encoding::Raw,
+	              unsigned n_threads = 1, bool compact_material_ids = false) const;
+
+	/// Creates an equivalent unstructured mesh including all cell arrays.
+	std::unique_ptr<MeshLib::Mesh> toMesh(std::string const& mesh_name) const;
+
+private:
+	StructuredGrid(std::size_t n_rows, std::size_t n_cols,
+		std::vector<double> x, std::vector<double> y, std::vector<double> z);
+
+	/// Values are stored either in values or in float_values.
+	struct CellData
+	{
+		std::string name;
+		unsigned n_components;
+		std::vector<double> values;
+		std::vector<float> float_values;
+	};
+
+	std::size_t const _n_rows;
+	std::size_t const _n_cols;
+	std::vector<double> const _x;
+	std::vector<double> const _y;
+	std::vector<double> const _z;
+	std::vector<CellData> _cell_data;
+};
+
+} // end namespace ToolsLib
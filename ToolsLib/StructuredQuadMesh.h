@@ -0,0 +1,86 @@
+/**
+ * @file   StructuredQuadMesh.h
+ * @author Karsten Rink
+ * @date   2026/10/14
+ * @brief  Bulk construction of quad meshes on logically structured grids
+ *
+ * @copyright
+ * Copyright (c) 2012-2026, OpenGeoSys Community (http://www.opengeosys.org)
+ *            Distributed under a Modified BSD License.
+ *              See accompanying file LICENSE.txt or
+ *              http://www.opengeosys.org/LICENSE.txt
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "MeshLib/Mesh.h"
+#include "MeshLib/Node.h"
+#include "MeshLib/Properties.h"
+#include "MeshLib/PropertyVector.h"
+#include "MeshLib/Elements/Quad.h"
+
+namespace ToolsLib
+{
+
+/**
+ * Creates a quad mesh on a logically structured grid with n_node_rows x
+ * n_node_cols nodes, numbered row by row. The coordinates of node (r, c) are
+ * given by coords(r, c), which returns a std::array<double, 3>. Quad (r, c)
+ * connects the nodes (r, c), (r+1, c), (r+1, c+1) and (r, c+1) and is
+ * assigned the material ID r; only the first n_elem_rows rows of quads are
+ * created.
+ * All node, element and property storage is sized exactly up front and
+ * filled in a single pass without intermediate containers. Note that
+ * MeshLib::Mesh takes ownership of the nodes and elements and releases each
+ * of them individually, hence they are still allocated one by one.
+ */
+template <typename NodeCoordinates>
+std::unique_ptr<MeshLib::Mesh> createStructuredQuadMesh(std::string const& mesh_name,
+	std::size_t n_node_rows, std::size_t n_node_cols, std::size_t n_elem_rows,
+	NodeCoordinates const& coords)
+{
+	if (n_node_rows < 2 || n_node_cols < 2 || n_elem_rows > n_node_rows - 1)
+		return nullptr;
+
+	std::vector<MeshLib::Node*> nodes;
+	nodes.reserve(n_node_rows * n_node_cols);
+	for (std::size_t r=0; r<n_node_rows; ++r)
+		for (std::size_t c=0; c<n_node_cols; ++c)
+		{
+			std::array<double, 3> const x (coords(r, c));
+			nodes.push_back(new MeshLib::Node(x[0], x[1], x[2], nodes.size()));
+		}
+
+	std::size_t const n_elem_cols (n_node_cols - 1);
+	std::vector<MeshLib::Element*> elems;
+	elems.reserve(n_elem_rows * n_elem_cols);
+	for (std::size_t r=0; r<n_elem_rows; ++r)
+	{
+		std::size_t const base_idx (r * n_node_cols);
+		for (std::size_t c=0; c<n_elem_cols; ++c)
+		{
+			std::array<MeshLib::Node*, 4> quad_nodes;
+			quad_nodes[0] = nodes[base_idx + c];
+			quad_nodes[1] = nodes[base_idx + c + n_node_cols];
+			quad_nodes[2] = nodes[base_idx + c + n_node_cols + 1];
+			quad_nodes[3] = nodes[base_idx + c + 1];
+			elems.push_back(new MeshLib::Quad(quad_nodes));
+		}
+	}
+
+	std::unique_ptr<MeshLib::Mesh> mesh (new MeshLib::Mesh(mesh_name, nodes, elems));
+	boost::optional<MeshLib::PropertyVector<int>&> mat_prop (
+		mesh->getProperties().createNewPropertyVector<int>("MaterialIDs", MeshLib::MeshItemType::Cell));
+	mat_prop->reserve(elems.size());
+	for (std::size_t r=0; r<n_elem_rows; ++r)
+		mat_prop->insert(mat_prop->end(), n_elem_cols, static_cast<int>(r));
+	return mesh;
+}
+
+} // end namespace ToolsLib
@@ -0,0 +1,69 @@
+/**
+ * @file   ThreadPool.h
+ * @author Karsten Rink
+ * @date   2026/10/14
+ * @brief  Fixed number of worker threads processing queued tasks
+ *
+ * @copyright
+ * Copyright (c) 2012-2026, OpenGeoSys Community (http://www.opengeosys.org)
+ *            Distributed under a Modified BSD License.
+ *              See accompanying file LICENSE.txt or
+ *              http://www.opengeosys.org/LICENSE.txt
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "BoundedQueue.h"
+
+namespace ToolsLib
+{
+
+/**
+ * Runs submitted tasks on a fixed number of threads in the order of
+ * submission. Tasks of very different runtime are balanced dynamically,
+ * submit() blocks while a few tasks per thread are waiting already.
+ */
+class ThreadPool
+{
+public:
+	explicit ThreadPool(unsigned n_threads)
+		: _tasks(2 * std::max(n_threads, 1u))
+	{
+		for (unsigned t=0; t<std::max(n_threads, 1u); ++t)
+			_threads.emplace_back([this]()
+			{
+				std::function<void()> task;
+				while (_tasks.pop(task))
+					task();
+			});
+	}
+
+	ThreadPool(ThreadPool const&) = delete;
+	ThreadPool& operator=(ThreadPool const&) = delete;
+
+	~ThreadPool() { wait(); }
+
+	/// Queues a task, returns false if wait() has been called already.
+	bool submit(std::function<void()> task) { return _tasks.push(std::move(task)); }
+
+	/// Finishes all submitted tasks and stops the threads.
+	void wait()
+	{
+		_tasks.close();
+		for (std::thread &thread : _threads)
+			if (thread.joinable())
+				thread.join();
+	}
+
+private:
+	BoundedQueue<std::function<void()>> _tasks;
+	std::vector<std::thread> _threads;
+};
+
+} // end namespace ToolsLib
@@ -0,0 +1,213 @@
+/**
+ * @file   TiledRasterCache.cpp
+ * @author Karsten Rink
+ * @date   2026/10/14
+ * @brief  Binary tiled side-car cache for large ASCII rasters
+ *
+ * @copyright
+ * Copyright (c) 2012-2026, OpenGeoSys Community (http://www.opengeosys.org)
+ *            Distributed under a Modified BSD License.
+ *              See accompanying file LICENSE.txt or
+ *              http://www.opengeosys.org/LICENSE.txt
+ */
+
+#include "TiledRasterCache.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+#include <sys/stat.h>
+
+// ThirdParty/logog
+#include "logog/include/logog.hpp"
+
+#include "GeoLib/Raster.h"
+#include "GeoLib/IO/AsciiRasterInterface.h"
+
+namespace ToolsLib
+{
+
+namespace
+{
+char const cache_magic[8] = { 'O', 'G', 'S', 'T', 'I', 'L', 'E', 'S' };
+std::uint32_t const cache_byte_order (0x01020304);
+std::uint32_t const cache_version (1);
+std::size_t const cache_tile_size (256);
+
+/// Returns true if file a exists and has not been modified after file b.
+bool isUpToDate(std::string const& a, std::string const& b)
+{
+	struct stat stat_a, stat_b;
+	if (stat(a.c_str(), &stat_a) != 0)
+		return false;
+	if (stat(b.c_str(), &stat_b) != 0)
+		return true;
+	return stat_a.st_mtime >= stat_b.st_mtime;
+}
+}
+
+std::unique_ptr<TiledRasterCache> TiledRasterCache::open(std::string const& raster_file)
+{
+	std::string const cache_file (getCacheFileName(raster_file));
+	if (isUpToDate(cache_file, raster_file))
+	{
+		std::unique_ptr<TiledRasterCache> cache (new TiledRasterCache(cache_file));
+		if (cache->isValid())
+			return cache;
+		WARN ("Raster cache %s is invalid and will be recreated.", cache_file.c_str());
+	}
+
+	INFO ("Creating raster cache %s.", cache_file.c_str());
+	if (!createCache(raster_file, cache_file))
+		return nullptr;
+	std::unique_ptr<TiledRasterCache> cache (new TiledRasterCache(cache_file));
+	if (!cache->isValid())
+		return nullptr;
+	return cache;
+}
+
+TiledRasterCache::TiledRasterCache(std::string const& cache_file)
+: _file(cache_file)
+{
+	std::memset(&_header, 0, sizeof(Header));
+	if (_file.isOpen() && _file.size() >= sizeof(Header))
+	{
+		std::memcpy(&_header, _file.begin(), sizeof(Header));
+		_tiles = reinterpret_cast<double const*>(_file.begin() + sizeof(Header));
+	}
+}
+
+bool TiledRasterCache::isValid() const
+{
+	if (_tiles == nullptr ||
+		std::memcmp(_header.magic, cache_magic, sizeof(cache_magic)) != 0 ||
+		_header.byte_order != cache_byte_order || _header.version != cache_version ||
+		_header.tile_size == 0)
+		return false;
+
+	std::uint64_t const ts (_header.tile_size);
+	std::uint64_t const n_tiles (((_header.n_cols + ts - 1) / ts) * ((_header.n_rows + ts - 1) / ts));
+	return _file.size() == sizeof(Header) + n_tiles * ts * ts * sizeof(double);
+}
+
+bool TiledRasterCache::createCache(std::string const& raster_file, std::string const& cache_file)
+{
+	std::unique_ptr<GeoLib::Raster> raster (GeoLib::IO::AsciiRasterInterface::readRaster(raster_file));
+	if (raster == nullptr)
+	{
+		ERR ("TiledRasterCache: Could not read raster %s.", raster_file.c_str());
+		return false;
+	}
+	RasterView const view (makeRasterView(*raster));
+
+	Header header;
+	std::memcpy(header.magic, cache_magic, sizeof(cache_magic));
+	header.byte_order = cache_byte_order;
+	header.version = cache_version;
+	header.n_cols = view.n_cols;
+	header.n_rows = view.n_rows;
+	header.tile_size = cache_tile_size;
+	header.x0 = view.x0;
+	header.y0 = view.y0;
+	header.cell_size = view.cell_size;
+	header.no_data = view.no_data;
+
+	// the cache is written to a temporary file first such that an aborted run
+	// never leaves an incomplete cache behind
+	std::string const tmp_file (cache_file + ".tmp");
+	std::ofstream out(tmp_file.c_str(), std::ios::out | std::ios::binary);
+	if (!out.is_open())
+	{
+		WARN ("TiledRasterCache: Could not create file %s.", tmp_file.c_str());
+		return false;
+	}
+	out.write(reinterpret_cast<char const*>(&header), sizeof(Header));
+
+	std::size_t const ts (cache_tile_size);
+	std::size_t const n_tile_cols ((view.n_cols + ts - 1) / ts);
+	std::size_t const n_tile_rows ((view.n_rows + ts - 1) / ts);
+	std::vector<double> tile(ts * ts);
+	for (std::size_t tr=0; tr<n_tile_rows; ++tr)
+		for (std::size_t tc=0; tc<n_tile_cols; ++tc)
+		{
+			// tiles at the upper and right border are padded with no-data values
+			std::fill(tile.begin(), tile.end(), view.no_data);
+			std::size_t const n_cols_in_tile (std::min(ts, view.n_cols - tc * ts));
+			std::size_t const n_rows_in_tile (std::min(ts, view.n_rows - tr * ts));
+			for (std::size_t r=0; r<n_rows_in_tile; ++r)
+			{
+				double const* src (view.data + (tr * ts + r) * view.n_cols + tc * ts);
+				std::copy(src, src + n_cols_in_tile, tile.begin() + r * ts);
+			}
+			out.write(reinterpret_cast<char const*>(tile.data()), tile.size() * sizeof(double));
+		}
+	out.close();
+	if (out.fail())
+	{
+		WARN ("TiledRasterCache: Error writing file %s.", tmp_file.c_str());
+		std::remove(tmp_file.c_str());
+		return false;
+	}
+
+	std::remove(cache_file.c_str());
+	if (std::rename(tmp_file.c_str(), cache_file.c_str()) != 0)
+	{
+		WARN ("TiledRasterCache: Could not rename %s.", tmp_file.c_str());
+		return false;
+	}
+	return true;
+}
+
+RasterView TiledRasterCache::getWindow(double x_min, double y_min, double x_max, double y_max,
+                                       std::vector<double> &buffer) const
+{
+	std::size_t const n_cols (_header.n_cols);
+	std::size_t const n_rows (_header.n_rows);
+	std::size_t const ts (_header.tile_size);
+	std::size_t const n_tile_cols ((n_cols + ts - 1) / ts);
+	double const cs (_header.cell_size);
+	if (n_cols == 0 || n_rows == 0)
+	{
+		buffer.clear();
+		RasterView const empty = { 0, 0, _header.x0, _header.y0, cs, _header.no_data, buffer.data() };
+		return empty;
+	}
+
+	auto const toIndex = [cs](double value, double origin, std::size_t n, long margin)
+	{
+		long const idx (static_cast<long>(std::floor((value - origin) / cs)) + margin);
+		return static_cast<std::size_t>(std::max(0l, std::min(static_cast<long>(n) - 1, idx)));
+	};
+	std::size_t const col_begin (toIndex(x_min, _header.x0, n_cols, -2));
+	std::size_t const col_end (toIndex(x_max, _header.x0, n_cols, 2) + 1);
+	std::size_t const row_begin (toIndex(y_min, _header.y0, n_rows, -2));
+	std::size_t const row_end (toIndex(y_max, _header.y0, n_rows, 2) + 1);
+
+	std::size_t const window_cols (col_end - col_begin);
+	std::size_t const window_rows (row_end - row_begin);
+	buffer.resize(window_cols * window_rows);
+	for (std::size_t r=row_begin; r<row_end; ++r)
+	{
+		std::size_t const tile_row (r / ts);
+		for (std::size_t c=col_begin; c<col_end; )
+		{
+			// copy the part of the raster row located in the current tile
+			std::size_t const tile_col (c / ts);
+			std::size_t const n_copy (std::min(col_end, (tile_col + 1) * ts) - c);
+			double const* src (_tiles + (tile_row * n_tile_cols + tile_col) * ts * ts
+			                   + (r % ts) * ts + (c % ts));
+			std::copy(src, src + n_copy, buffer.begin() + (r - row_begin) * window_cols + (c - col_begin));
+			c += n_copy;
+		}
+	}
+
+	RasterView const view = { window_cols, window_rows,
+	                          _header.x0 + col_begin * cs, _header.y0 + row_begin * cs,
+	                          cs, _header.no_data, buffer.data() };
+	return view;
+}
+
+} // end namespace ToolsLib
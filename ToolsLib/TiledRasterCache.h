@@ -0,0 +1,79 @@
+/**
+ * @file   TiledRasterCache.h
+ * @author Karsten Rink
+ * @date   2026/10/14
+ * @brief  Binary tiled side-car cache for large ASCII rasters
+ *
+ * @copyright
+ * Copyright (c) 2012-2026, OpenGeoSys Community (http://www.opengeosys.org)
+ *            Distributed under a Modified BSD License.
+ *              See accompanying file LICENSE.txt or
+ *              http://www.opengeosys.org/LICENSE.txt
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "MappedFile.h"
+#include "RasterSampling.h"
+
+namespace ToolsLib
+{
+
+/**
+ * Binary copy of an ASCII raster split into square tiles, stored next to the
+ * raster as "<raster file>.tiles". The cache is created the first time a
+ * raster is opened (or if the raster is newer than its cache) and memory
+ * mapped afterwards, hence only the tiles actually accessed are ever read
+ * from disk.
+ */
+class TiledRasterCache
+{
+public:
+	/// Opens the cache of the given ASCII raster, creating it if necessary.
+	/// Returns nullptr if the raster cannot be read or the cache cannot be
+	/// created, e.g. because the directory of the raster is not writable.
+	static std::unique_ptr<TiledRasterCache> open(std::string const& raster_file);
+
+	/**
+	 * Copies the part of the raster covering the given bounding box (plus a
+	 * margin of two cells for interpolation) into \c buffer and returns a
+	 * view onto it. Only tiles overlapping the box are accessed.
+	 */
+	RasterView getWindow(double x_min, double y_min, double x_max, double y_max,
+	                     std::vector<double> &buffer) const;
+
+	static std::string getCacheFileName(std::string const& raster_file) { return raster_file + ".tiles"; }
+
+private:
+	struct Header
+	{
+		char magic[8];
+		std::uint32_t byte_order;
+		std::uint32_t version;
+		std::uint64_t n_cols;
+		std::uint64_t n_rows;
+		std::uint64_t tile_size;
+		double x0;
+		double y0;
+		double cell_size;
+		double no_data;
+	};
+
+	explicit TiledRasterCache(std::string const& cache_file);
+
+	bool isValid() const;
+
+	static bool createCache(std::string const& raster_file, std::string const& cache_file);
+
+	MappedFile const _file;
+	Header _header;
+	double const* _tiles = nullptr;
+};
+
+} // end namespace ToolsLib
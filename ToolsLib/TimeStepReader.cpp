@@ -0,0 +1,161 @@
+/**
+ * @file   TimeStepReader.cpp
+ * @author Karsten Rink
+ * @date   2026/10/14
+ * @brief  Splitting and parsing of csv-files containing a time series of cell values
+ *
+ * @copyright
+ * Copyright (c) 2012-2026, OpenGeoSys Community (http://www.opengeosys.org)
+ *            Distributed under a Modified BSD License.
+ *              See accompanying file LICENSE.txt or
+ *              http://www.opengeosys.org/LICENSE.txt
+ */
+
+#include "TimeStepReader.h"
+
+#include <cstring>
+
+// ThirdParty/logog
+#include "logog/include/logog.hpp"
+
+#include "NumberParsing.h"
+#include "PhaseTimer.h"
+
+namespace ToolsLib
+{
+
+namespace
+{
+
+/// Parses a single value of the range [begin, end) without heap allocations.
+bool parseValue(char const* begin, char const* end, double nan_value, double &value)
+{
+	std::size_t const length (end - begin);
+	if (length == 3 && std::strncmp(begin, "NaN", 3) == 0)
+	{
+		value = nan_value;
+		return true;
+	}
+	return parseDouble(begin, end, value);
+}
+
+/**
+ * Parses a row of comma separated values. The first field of each row is
+ * skipped, all other fields are written consecutively to \c values, at most
+ * \c n_values are written.
+ * @return The number of fields in the row (including the skipped one) or -1
+ * if a value could not be parsed.
+ */
+int parseRow(char const* begin, char const* end, double nan_value, double* values, std::size_t n_values)
+{
+	if (begin == end)
+		return 0;
+
+	int n_fields (0);
+	while (begin < end)
+	{
+		char const* const field_end (findFieldEnd(begin, end, ','));
+		if (n_fields > 0 && static_cast<std::size_t>(n_fields) <= n_values)
+			if (!parseValue(begin, field_end, nan_value, values[n_fields-1]))
+				return -1;
+		n_fields++;
+		begin = field_end + 1;
+	}
+	return n_fields;
+}
+
+} // end anonymous namespace
+
+bool StreamLineSource::nextLine(char const*& begin, char const*& end)
+{
+	bool const success (getline(_in, _line));
+	begin = _line.c_str();
+	end = begin + _line.size();
+	return success;
+}
+
+bool MappedLineSource::nextLine(char const*& begin, char const*& end)
+{
+	if (_pos == _file.end())
+	{
+		begin = end = _pos;
+		return false;
+	}
+	begin = _pos;
+	end = findLineEnd(_pos, _file.end());
+	_pos = (end == _file.end()) ? end : end + 1;
+	return true;
+}
+
+bool readTimeStep(CsvLineSource &in, int n_rows, TimeStep &step)
+{
+	char const* line_begin (nullptr);
+	char const* line_end (nullptr);
+	if (!in.nextLine(line_begin, line_end))
+		return false;
+
+	step.buffer.clear();
+	step.rows.clear();
+	std::vector<std::size_t> offsets;
+	for (int i=0; i<=n_rows; ++i)
+	{
+		if (in.keepsLines())
+		{
+			step.rows.emplace_back(line_begin, line_end);
+		}
+		else
+		{
+			offsets.push_back(step.buffer.size());
+			step.buffer.append(line_begin, line_end);
+		}
+		in.nextLine(line_begin, line_end);
+	}
+	if (!in.keepsLines())
+	{
+		offsets.push_back(step.buffer.size());
+		char const* const buffer (step.buffer.data());
+		for (int i=0; i<=n_rows; ++i)
+			step.rows.emplace_back(buffer + offsets[i], buffer + offsets[i+1]);
+	}
+
+	in.nextLine(line_begin, line_end);
+	if (line_begin != line_end)
+		ERR("something is wrong here.");
+	return true;
+}
+
+void readTimeSteps(CsvLineSource &in, int n_rows, BoundedQueue<std::unique_ptr<TimeStep>> &queue)
+{
+	std::size_t file_counter(0);
+	for (;;)
+	{
+		std::unique_ptr<TimeStep> step (new TimeStep);
+		if (!readTimeStep(in, n_rows, *step))
+			break;
+		step->index = file_counter++;
+		if (!queue.push(std::move(step)))
+			break;
+	}
+	queue.close();
+}
+
+int parseTimeStep(TimeStep const& step, int n_rows, int n_values_per_row,
+                  double nan_value, std::vector<double> &values, PhaseTimer &timer)
+{
+	ScopedPhase phase(timer, "parse");
+	for (std::pair<char const*, char const*> const& row : step.rows)
+		phase.addBytesRead(row.second - row.first);
+	phase.addItems((n_rows + 1) * n_values_per_row);
+	for (int i=0; i<=n_rows; ++i)
+	{
+		std::size_t const idx_cnt (i * n_values_per_row);
+		if (idx_cnt + n_values_per_row > values.size())
+			return -3;
+		int const n_cols (parseRow(step.rows[i].first, step.rows[i].second, nan_value, &values[idx_cnt], n_values_per_row));
+		if (n_cols != n_values_per_row + 1)
+			return -3;
+	}
+	return 0;
+}
+
+} // end namespace ToolsLib
@@ -0,0 +1,118 @@
+/**
+ * @file   TimeStepReader.h
+ * @author Karsten Rink
+ * @date   2026/10/14
+ * @brief  Splitting and parsing of csv-files containing a time series of cell values
+ *
+ * @copyright
+ * Copyright (c) 2012-2026, OpenGeoSys Community (http://www.opengeosys.org)
+ *            Distributed under a Modified BSD License.
+ *              See accompanying file LICENSE.txt or
+ *              http://www.opengeosys.org/LICENSE.txt
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "BoundedQueue.h"
+#include "MappedFile.h"
+
+namespace ToolsLib
+{
+
+class PhaseTimer;
+
+/// Provides the lines of the csv-file as character ranges without copying them.
+class CsvLineSource
+{
+public:
+	virtual ~CsvLineSource() = default;
+
+	virtual bool isOpen() const = 0;
+
+	/// Returns true if line ranges stay valid for the lifetime of the source.
+	virtual bool keepsLines() const = 0;
+
+	/// Sets [begin, end) to the next line and returns false at the end of the
+	/// file. The range stays valid until the next call.
+	virtual bool nextLine(char const*& begin, char const*& end) = 0;
+};
+
+/// Reads lines from a file stream, reusing a single line buffer.
+class StreamLineSource : public CsvLineSource
+{
+public:
+	explicit StreamLineSource(std::string const& file_name) : _in(file_name.c_str()) {}
+
+	bool isOpen() const override { return _in.is_open(); }
+
+	bool keepsLines() const override { return false; }
+
+	bool nextLine(char const*& begin, char const*& end) override;
+
+private:
+	std::ifstream _in;
+	std::string _line;
+};
+
+/// Returns lines directly from a memory mapped file.
+class MappedLineSource : public CsvLineSource
+{
+public:
+	explicit MappedLineSource(std::string const& file_name)
+		: _file(file_name), _pos(_file.begin())
+	{}
+
+	bool isOpen() const override { return _file.isOpen(); }
+
+	bool keepsLines() const override { return true; }
+
+	bool nextLine(char const*& begin, char const*& end) override;
+
+private:
+	MappedFile const _file;
+	char const* _pos;
+};
+
+/// The rows of a single time step. The row ranges either point into the
+/// memory mapped csv-file or into the buffer of the time step.
+struct TimeStep
+{
+	std::size_t index;
+	std::string buffer;
+	std::vector<std::pair<char const*, char const*>> rows;
+};
+
+/**
+ * Reads the next time step of the csv-file. Each time step consists of
+ * n_rows+1 rows, followed by a line that is skipped and an empty separator
+ * line. The index of the step is not set.
+ * @return false at the end of the file.
+ */
+bool readTimeStep(CsvLineSource &in, int n_rows, TimeStep &step);
+
+/**
+ * Splits the csv-file into time steps (see readTimeStep()) and hands them to
+ * the queue, numbered consecutively. The queue is closed once the file has
+ * been read.
+ */
+void readTimeSteps(CsvLineSource &in, int n_rows, BoundedQueue<std::unique_ptr<TimeStep>> &queue);
+
+/**
+ * Parses the n_rows+1 rows of the time step into values, which needs to
+ * hold at least (n_rows+1) * n_values_per_row entries. The first field of
+ * each row is skipped, "NaN" is replaced by nan_value. The time is added to
+ * the phase "parse" of the timer.
+ * @return 0 on success, -3 if a row has not the expected number of values
+ * or a value could not be parsed.
+ */
+int parseTimeStep(TimeStep const& step, int n_rows, int n_values_per_row,
+                  double nan_value, std::vector<double> &values, PhaseTimer &timer);
+
+} // end namespace ToolsLib
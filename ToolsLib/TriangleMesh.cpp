@@ -0,0 +1,121 @@
+/**
+ * @file   TriangleMesh.cpp
+ * @author Karsten Rink
+ * @date   2026/10/14
+ * @brief  Compact triangle meshes stored as flat index buffers
+ *
+ * @copyright
+ * Copyright (c) 2012-2026, OpenGeoSys Community (http://www.opengeosys.org)
+ *            Distributed under a Modified BSD License.
+ *              See accompanying file LICENSE.txt or
+ *              http://www.opengeosys.org/LICENSE.txt
+ */
+
+#include "TriangleMesh.h"
+
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+// ThirdParty/logog
+#include "logog/include/logog.hpp"
+
+namespace ToolsLib
+{
+
+bool writeTriangleMeshPly(TriangleMesh const& mesh, std::string const& file_name,
+                          std::string const& id_name)
+{
+	std::ofstream out(file_name.c_str(), std::ios::binary);
+	if (!out.is_open())
+	{
+		ERR ("writeTriangleMeshPly(): Could not open file %s.", file_name.c_str());
+		return false;
+	}
+
+	std::size_t const n_triangles (mesh.getNumberOfTriangles());
+	bool const is_little_endian (std::strcmp(VtkAppendedData::getByteOrder(), "LittleEndian") == 0);
+	out << "ply\n"
+	    << "format " << (is_little_endian ? "binary_little_endian" : "binary_big_endian") << " 1.0\n"
+	    << "element vertex " << mesh.getNumberOfPoints() << "\n"
+	    << "property double x\n"
+	    << "property double y\n"
+	    << "property double z\n"
+	    << "element face " << n_triangles << "\n"
+	    << "property list uchar uint vertex_indices\n"
+	    << "property uint " << id_name << "\n"
+	    << "end_header\n";
+	out.write(reinterpret_cast<char const*>(mesh.points.data()), mesh.points.size() * sizeof(double));
+
+	// faces are written in blocks of 1 MiB
+	std::size_t const face_size (1 + 4 * sizeof(std::uint32_t));
+	std::size_t const block_size (1 << 20);
+	std::vector<char> buffer (block_size);
+	std::size_t pos (0);
+	for (std::size_t i=0; i<n_triangles; ++i)
+	{
+		if (pos + face_size > block_size)
+		{
+			out.write(buffer.data(), pos);
+			pos = 0;
+		}
+		buffer[pos++] = 3;
+		std::memcpy(&buffer[pos], &mesh.triangles[3*i], 3 * sizeof(std::uint32_t));
+		pos += 3 * sizeof(std::uint32_t);
+		std::memcpy(&buffer[pos], &mesh.object_ids[i], sizeof(std::uint32_t));
+		pos += sizeof(std::uint32_t);
+	}
+	out.write(buffer.data(), pos);
+	return out.good();
+}
+
+bool writeTriangleMeshVtu(TriangleMesh const& mesh, std::string const& file_name,
+                          std::string const& id_name, VtkAppendedData::Encoding encoding,
+                          unsigned n_threads)
+{
+	std::size_t const n_triangles (mesh.getNumberOfTriangles());
+	if (3 * n_triangles > std::numeric_limits<std::uint32_t>::max())
+	{
+		ERR ("writeTriangleMeshVtu(): Number of triangles exceeds the range of 32 bit offsets.");
+		return false;
+	}
+
+	std::ofstream out(file_name.c_str(), std::ios::binary);
+	if (!out.is_open())
+	{
+		ERR ("writeTriangleMeshVtu(): Could not open file %s.", file_name.c_str());
+		return false;
+	}
+
+	std::vector<std::uint32_t> offsets (n_triangles);
+	for (std::size_t i=0; i<n_triangles; ++i)
+		offsets[i] = static_cast<std::uint32_t>(3 * (i + 1));
+	std::uint8_t const vtk_triangle (5);
+	std::vector<std::uint8_t> const types (n_triangles, vtk_triangle);
+
+	VtkAppendedData appended(encoding, n_threads);
+	out << "<?xml version=\"1.0\"?>\n"
+	    << "<VTKFile type=\"UnstructuredGrid\" version=\"1.0\" " << appended.getFileAttributes() << ">\n"
+	    << "  <UnstructuredGrid>\n"
+	    << "    <Piece NumberOfPoints=\"" << mesh.getNumberOfPoints() << "\" NumberOfCells=\"" << n_triangles << "\">\n"
+	    << "      <PointData>\n      </PointData>\n"
+	    << "      <CellData>\n"
+	    << "        " << appended.addDataArray(id_name, 1, mesh.object_ids.data(), n_triangles) << "\n"
+	    << "      </CellData>\n"
+	    << "      <Points>\n"
+	    << "        " << appended.addDataArray("Points", 3, mesh.points.data(), mesh.points.size()) << "\n"
+	    << "      </Points>\n"
+	    << "      <Cells>\n"
+	    << "        " << appended.addDataArray("connectivity", 1, mesh.triangles.data(), mesh.triangles.size()) << "\n"
+	    << "        " << appended.addDataArray("offsets", 1, offsets.data(), offsets.size()) << "\n"
+	    << "        " << appended.addDataArray("types", 1, types.data(), types.size()) << "\n"
+	    << "      </Cells>\n"
+	    << "    </Piece>\n"
+	    << "  </UnstructuredGrid>\n";
+	if (!appended.write(out))
+		return false;
+	out << "</VTKFile>\n";
+	return out.good();
+}
+
+} // end namespace ToolsLib
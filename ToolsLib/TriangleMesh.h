@@ -0,0 +1,53 @@
+/**
+ * @file   TriangleMesh.h
+ * @author Karsten Rink
+ * @date   2026/10/14
+ * @brief  Compact triangle meshes stored as flat index buffers
+ *
+ * @copyright
+ * Copyright (c) 2012-2026, OpenGeoSys Community (http://www.opengeosys.org)
+ *            Distributed under a Modified BSD License.
+ *              See accompanying file LICENSE.txt or
+ *              http://www.opengeosys.org/LICENSE.txt
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "VtkAppendedData.h"
+
+namespace ToolsLib
+{
+
+/**
+ * Triangle mesh consisting of several objects (e.g. buildings). Vertices are
+ * stored interleaved, triangles as three 32 bit vertex indices each, and
+ * every triangle carries the ID of the object it belongs to.
+ */
+struct TriangleMesh
+{
+	std::vector<double> points;
+	std::vector<std::uint32_t> triangles;
+	std::vector<std::uint32_t> object_ids;
+
+	std::size_t getNumberOfPoints() const { return points.size() / 3; }
+	std::size_t getNumberOfTriangles() const { return object_ids.size(); }
+};
+
+/// Writes the mesh as binary PLY file, object IDs are stored as face
+/// property of the given name.
+bool writeTriangleMeshPly(TriangleMesh const& mesh, std::string const& file_name,
+                          std::string const& id_name);
+
+/// Writes the mesh as VTU file with appended data, object IDs are stored as
+/// cell array of the given name.
+bool writeTriangleMeshVtu(TriangleMesh const& mesh, std::string const& file_name,
+                          std::string const& id_name,
+                          VtkAppendedData::Encoding encoding = VtkAppendedData::Encoding::Raw,
+                          unsigned n_threads = 1);
+
+} // end namespace ToolsLib
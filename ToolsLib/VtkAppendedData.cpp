@@ -0,0 +1,151 @@
+/**
+ * @file   VtkAppendedData.cpp
+ * @author Karsten Rink
+ * @date   2026/10/14
+ * @brief  Appended data section of VTK XML files
+ *
+ * @copyright
+ * Copyright (c) 2012-2026, OpenGeoSys Community (http://www.opengeosys.org)
+ *            Distributed under a Modified BSD License.
+ *              See accompanying file LICENSE.txt or
+ *              http://www.opengeosys.org/LICENSE.txt
+ */
+
+#include "VtkAppendedData.h"
+
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+#include <utility>
+
+#include <zlib.h>
+
+// ThirdParty/logog
+#include "logog/include/logog.hpp"
+
+#include "ParallelFor.h"
+
+namespace ToolsLib
+{
+
+namespace
+{
+/// Uncompressed size of the blocks of compressed arrays.
+std::size_t const compression_block_size (1 << 20);
+}
+
+std::string VtkAppendedData::addDataArray(std::string const& name, char const* type,
+	unsigned n_components, char const* data, std::size_t n_bytes)
+{
+	std::ostringstream tag;
+	tag << "<DataArray type=\"" << type << "\"";
+	if (!name.empty())
+		tag << " Name=\"" << name << "\"";
+	tag << " NumberOfComponents=\"" << n_components << "\""
+	    << " format=\"appended\" offset=\"" << _offset << "\"/>";
+
+	Block block = { data, static_cast<std::uint64_t>(n_bytes), std::vector<char>() };
+	if (_encoding == Encoding::Zlib)
+	{
+		if (!compress(data, n_bytes, block.encoded))
+		{
+			ERR ("VtkAppendedData: Compressing data array \"%s\" failed.", name.c_str());
+			_is_valid = false;
+		}
+		block.data = nullptr;
+		_offset += block.encoded.size();
+	}
+	else
+		_offset += sizeof(std::uint64_t) + block.n_bytes;
+	_blocks.push_back(std::move(block));
+	return tag.str();
+}
+
+bool VtkAppendedData::compress(char const* data, std::size_t n_bytes, std::vector<char> &encoded) const
+{
+	std::size_t const n_blocks ((n_bytes + compression_block_size - 1) / compression_block_size);
+	std::vector<std::vector<Bytef>> blocks(n_blocks);
+	std::vector<int> results(n_blocks, Z_OK);
+	parallelFor(n_blocks, _n_threads, [&](std::size_t begin, std::size_t end, unsigned)
+	{
+		for (std::size_t i=begin; i<end; ++i)
+		{
+			std::size_t const offset (i * compression_block_size);
+			uLong const size (static_cast<uLong>(std::min(compression_block_size, n_bytes - offset)));
+			uLongf compressed_size (compressBound(size));
+			blocks[i].resize(compressed_size);
+			results[i] = compress2(blocks[i].data(), &compressed_size,
+				reinterpret_cast<Bytef const*>(data + offset), size, Z_BEST_SPEED);
+			blocks[i].resize(compressed_size);
+		}
+	});
+	if (std::any_of(results.cbegin(), results.cend(), [](int result) { return result != Z_OK; }))
+		return false;
+
+	// header: number of blocks, block size, size of last block, compressed sizes
+	std::vector<std::uint64_t> header;
+	header.reserve(3 + n_blocks);
+	header.push_back(n_blocks);
+	header.push_back(compression_block_size);
+	header.push_back((n_blocks == 0) ? 0 : n_bytes - (n_blocks - 1) * compression_block_size);
+	std::size_t total_size (0);
+	for (std::vector<Bytef> const& block : blocks)
+	{
+		header.push_back(block.size());
+		total_size += block.size();
+	}
+
+	std::size_t const header_size (header.size() * sizeof(std::uint64_t));
+	encoded.resize(header_size + total_size);
+	std::memcpy(encoded.data(), header.data(), header_size);
+	char* pos (encoded.data() + header_size);
+	for (std::vector<Bytef> const& block : blocks)
+	{
+		std::memcpy(pos, block.data(), block.size());
+		pos += block.size();
+	}
+	return true;
+}
+
+bool VtkAppendedData::write(std::ostream &out) const
+{
+	if (!_is_valid)
+		return false;
+	out << "  <AppendedData encoding=\"raw\">\n   _";
+	writeArrays(out);
+	out << "\n  </AppendedData>\n";
+	return out.good();
+}
+
+bool VtkAppendedData::writeArrays(std::ostream &out) const
+{
+	if (!_is_valid)
+		return false;
+	for (Block const& block : _blocks)
+	{
+		if (_encoding == Encoding::Zlib)
+		{
+			out.write(block.encoded.data(), block.encoded.size());
+			continue;
+		}
+		out.write(reinterpret_cast<char const*>(&block.n_bytes), sizeof(block.n_bytes));
+		out.write(block.data, block.n_bytes);
+	}
+	return out.good();
+}
+
+char const* VtkAppendedData::getByteOrder()
+{
+	std::uint32_t const probe (1);
+	return (*reinterpret_cast<unsigned char const*>(&probe) == 1) ? "LittleEndian" : "BigEndian";
+}
+
+std::string VtkAppendedData::getFileAttributes() const
+{
+	std::string attributes ("byte_order=\"" + std::string(getByteOrder()) + "\" header_type=\"UInt64\"");
+	if (_encoding == Encoding::Zlib)
+		attributes += " compressor=\"vtkZLibDataCompressor\"";
+	return attributes;
+}
+
+} // end namespace ToolsLib
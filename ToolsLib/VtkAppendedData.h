@@ -0,0 +1,117 @@
+/**
+ * @file   VtkAppendedData.h
+ * @author Karsten Rink
+ * @date   2026/10/14
+ * @brief  Appended data section of VTK XML files
+ *
+ * @copyright
+ * Copyright (c) 2012-2026, OpenGeoSys Community (http://www.opengeosys.org)
+ *            Distributed under a Modified BSD License.
+ *              See accompanying file LICENSE.txt or
+ *              http://www.opengeosys.org/LICENSE.txt
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace ToolsLib
+{
+
+/// VTK XML type name of the arithmetic value type T, e.g. Int64 for long on
+/// 64 bit Linux and for long long on Windows. char is written as Int8.
+template <typename T>
+char const* getVtkTypeName()
+{
+	static_assert(std::is_arithmetic<T>::value && !std::is_same<T, bool>::value,
+		"VTK data arrays require numeric value types.");
+	if (std::is_floating_point<T>::value)
+		return (sizeof(T) == 4) ? "Float32" : "Float64";
+	bool const is_signed (std::is_signed<T>::value || std::is_same<T, char>::value);
+	switch (sizeof(T))
+	{
+	case 1:  return is_signed ? "Int8" : "UInt8";
+	case 2:  return is_signed ? "Int16" : "UInt16";
+	case 4:  return is_signed ? "Int32" : "UInt32";
+	default: return is_signed ? "Int64" : "UInt64";
+	}
+}
+
+/**
+ * Collects the data arrays of a VTK XML file (header_type="UInt64") and
+ * writes them as a single raw binary appended data section. Uncompressed
+ * arrays are not copied, i.e. the data passed to addDataArray() has to stay
+ * valid until write() has been called. Compressed arrays are split into
+ * blocks which are compressed in parallel when the array is added.
+ */
+class VtkAppendedData
+{
+public:
+	enum class Encoding
+	{
+		Raw,
+		Zlib
+	};
+
+	/// The offset of the first array can be set for adding arrays to an
+	/// existing appended data section.
+	explicit VtkAppendedData(Encoding encoding = Encoding::Raw, unsigned n_threads = 1,
+	                         std::uint64_t offset = 0)
+	: _encoding(encoding), _n_threads(n_threads), _offset(offset) {}
+
+	/// Registers the array and returns the DataArray element referencing it.
+	template <typename T>
+	std::string addDataArray(std::string const& name, unsigned n_components,
+	                         T const* data, std::size_t n_values)
+	{
+		return addDataArray(name, getVtkTypeName<T>(), n_components,
+			reinterpret_cast<char const*>(data), n_values * sizeof(T));
+	}
+
+	/// Writes the AppendedData element including all registered arrays.
+	/// Nothing is written and false is returned if an array could not be
+	/// compressed.
+	bool write(std::ostream &out) const;
+
+	/// Writes only the encoded arrays without the enclosing element, see
+	/// write().
+	bool writeArrays(std::ostream &out) const;
+
+	/// Returns false if compressing one of the arrays failed.
+	bool isValid() const { return _is_valid; }
+
+	/// Byte order attribute of the VTKFile element for this machine.
+	static char const* getByteOrder();
+
+	/// Attributes of the VTKFile element describing the encoding, i.e. byte
+	/// order, header type and compressor.
+	std::string getFileAttributes() const;
+
+private:
+	std::string addDataArray(std::string const& name, char const* type, unsigned n_components,
+	                         char const* data, std::size_t n_bytes);
+
+	/// Compresses the data in the vtkZLibDataCompressor block format,
+	/// returns false if zlib reports an error for one of the blocks.
+	bool compress(char const* data, std::size_t n_bytes, std::vector<char> &encoded) const;
+
+	struct Block
+	{
+		char const* data;
+		std::uint64_t n_bytes;
+		std::vector<char> encoded;
+	};
+
+	Encoding const _encoding;
+	unsigned const _n_threads;
+	std::vector<Block> _blocks;
+	std::uint64_t _offset;
+	bool _is_valid = true;
+};
+
+} // end namespace ToolsLib
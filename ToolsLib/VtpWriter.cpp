@@ -0,0 +1,84 @@
+/**
+ * @file   VtpWriter.cpp
+ * @author Karsten Rink
+ * @date   2026/10/14
+ * @brief  VTK PolyData output for point data sets
+ *
+ * @copyright
+ * Copyright (c) 2012-2026, OpenGeoSys Community (http://www.opengeosys.org)
+ *            Distributed under a Modified BSD License.
+ *              See accompanying file LICENSE.txt or
+ *              http://www.opengeosys.org/LICENSE.txt
+ */
+
+#include "VtpWriter.h"
+
+#include <cstdint>
+#include <fstream>
+
+// ThirdParty/logog
+#include "logog/include/logog.hpp"
+
+namespace ToolsLib
+{
+
+bool writePointsVtp(std::string const& file_name, std::vector<double> const& x,
+	std::vector<double> const& y, std::vector<double> const& z,
+	std::string const& array_name, std::vector<double> const& values,
+	VtkAppendedData::Encoding encoding, unsigned n_threads)
+{
+	std::size_t const n_points (x.size());
+	if (y.size() != n_points || z.size() != n_points || values.size() != n_points)
+	{
+		ERR ("writePointsVtp(): Sizes of coordinate and value arrays differ.");
+		return false;
+	}
+
+	std::ofstream out(file_name.c_str(), std::ios::binary);
+	if (!out.is_open())
+	{
+		ERR ("writePointsVtp(): Could not open file %s.", file_name.c_str());
+		return false;
+	}
+
+	std::vector<double> points;
+	points.reserve(3 * n_points);
+	for (std::size_t i=0; i<n_points; ++i)
+	{
+		points.push_back(x[i]);
+		points.push_back(y[i]);
+		points.push_back(z[i]);
+	}
+	std::vector<std::int64_t> connectivity(n_points);
+	std::vector<std::int64_t> offsets(n_points);
+	for (std::size_t i=0; i<n_points; ++i)
+	{
+		connectivity[i] = i;
+		offsets[i] = i + 1;
+	}
+
+	VtkAppendedData appended(encoding, n_threads);
+	out << "<?xml version=\"1.0\"?>\n"
+	    << "<VTKFile type=\"PolyData\" version=\"1.0\" " << appended.getFileAttributes() << ">\n"
+	    << "  <PolyData>\n"
+	    << "    <Piece NumberOfPoints=\"" << n_points << "\" NumberOfVerts=\"" << n_points
+	    << "\" NumberOfLines=\"0\" NumberOfStrips=\"0\" NumberOfPolys=\"0\">\n"
+	    << "      <PointData Scalars=\"" << array_name << "\">\n"
+	    << "        " << appended.addDataArray(array_name, 1, values.data(), n_points) << "\n"
+	    << "      </PointData>\n"
+	    << "      <Points>\n"
+	    << "        " << appended.addDataArray("Points", 3, points.data(), points.size()) << "\n"
+	    << "      </Points>\n"
+	    << "      <Verts>\n"
+	    << "        " << appended.addDataArray("connectivity", 1, connectivity.data(), n_points) << "\n"
+	    << "        " << appended.addDataArray("offsets", 1, offsets.data(), n_points) << "\n"
+	    << "      </Verts>\n"
+	    << "    </Piece>\n"
+	    << "  </PolyData>\n";
+	if (!appended.write(out))
+		return false;
+	out << "</VTKFile>\n";
+	return out.good();
+}
+
+} // end namespace ToolsLib
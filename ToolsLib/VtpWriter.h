@@ -0,0 +1,34 @@
+/**
+ * @file   VtpWriter.h
+ * @author Karsten Rink
+ * @date   2026/10/14
+ * @brief  VTK PolyData output for point data sets
+ *
+ * @copyright
+ * Copyright (c) 2012-2026, OpenGeoSys Community (http://www.opengeosys.org)
+ *            Distributed under a Modified BSD License.
+ *              See accompanying file LICENSE.txt or
+ *              http://www.opengeosys.org/LICENSE.txt
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "VtkAppendedData.h"
+
+namespace ToolsLib
+{
+
+/**
+ * Writes the points given by the coordinate arrays as VTK XML PolyData
+ * (*.vtp) with one vertex cell per point and the values as scalar point
+ * array of the given name. All data is stored as appended binary data.
+ */
+bool writePointsVtp(std::string const& file_name, std::vector<double> const& x,
+	std::vector<double> const& y, std::vector<double> const& z,
+	std::string const& array_name, std::vector<double> const& values,
+	VtkAppendedData::Encoding encoding = VtkAppendedData::Encoding::Raw, unsigned n_threads = 1);
+
+} // end namespace ToolsLib
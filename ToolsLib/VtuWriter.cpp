@@ -0,0 +1,467 @@
+/**
+ * @file   VtuWriter.cpp
+ * @author Karsten Rink
+ * @date   2026/10/14
+ * @brief  Fast VTU output with raw binary or compressed appended data
+ *
+ * @copyright
+ * Copyright (c) 2012-2026, OpenGeoSys Community (http://www.opengeosys.org)
+ *            Distributed under a Modified BSD License.
+ *              See accompanying file LICENSE.txt or
+ *              http://www.opengeosys.org/LICENSE.txt
+ */
+
+#include "VtuWriter.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#endif
+
+// ThirdParty/logog
+#include "logog/include/logog.hpp"
+
+#include "MeshLib/IO/VtkIO/VtuInterface.h"
+#include "MeshLib/Mesh.h"
+#include "MeshLib/MeshEnums.h"
+#include "MeshLib/Node.h"
+#include "MeshLib/Properties.h"
+#include "MeshLib/PropertyVector.h"
+#include "MeshLib/Elements/Element.h"
+
+#include "MappedFile.h"
+
+namespace ToolsLib
+{
+
+namespace
+{
+/// Number of blanks reserved in front of </CellData> for adding arrays in place.
+std::size_t const cell_data_padding (1024);
+
+/// The element name and the indentation of cell arrays.
+std::string const cell_data_end ("</CellData>");
+std::string const array_indent ("        ");
+
+/// VTK cell type of the given element type, 0 (VTK_EMPTY_CELL) if unknown.
+std::uint8_t getVtkCellType(MeshLib::CellType type)
+{
+	switch (type)
+	{
+	case MeshLib::CellType::POINT1:    return 1;
+	case MeshLib::CellType::LINE2:     return 3;
+	case MeshLib::CellType::LINE3:     return 21;
+	case MeshLib::CellType::TRI3:      return 5;
+	case MeshLib::CellType::TRI6:      return 22;
+	case MeshLib::CellType::QUAD4:     return 9;
+	case MeshLib::CellType::QUAD8:     return 23;
+	case MeshLib::CellType::QUAD9:     return 28;
+	case MeshLib::CellType::TET4:      return 10;
+	case MeshLib::CellType::TET10:     return 24;
+	case MeshLib::CellType::HEX8:      return 12;
+	case MeshLib::CellType::HEX20:     return 25;
+	case MeshLib::CellType::HEX27:     return 29;
+	case MeshLib::CellType::PRISM6:    return 13;
+	case MeshLib::CellType::PRISM15:   return 26;
+	case MeshLib::CellType::PRISM18:   return 32;
+	case MeshLib::CellType::PYRAMID5:  return 14;
+	case MeshLib::CellType::PYRAMID13: return 27;
+	default:                           return 0;
+	}
+}
+
+/// Adds the property to the appended data if it is of value type T.
+template <typename T>
+bool addProperty(MeshLib::Properties const& properties, std::string const& name,
+                 VtkAppendedData &appended, std::ostream &point_data, std::ostream &cell_data)
+{
+	boost::optional<MeshLib::PropertyVector<T> const&> const prop (properties.getPropertyVector<T>(name));
+	if (!prop)
+		return false;
+	std::string const tag (appended.addDataArray(name, prop->getNumberOfComponents(), prop->data(), prop->size()));
+	if (prop->getMeshItemType() == MeshLib::MeshItemType::Node)
+		point_data << "        " << tag << "\n";
+	else if (prop->getMeshItemType() == MeshLib::MeshItemType::Cell)
+		cell_data << "        " << tag << "\n";
+	return true;
+}
+
+/// Adds integer material IDs as UInt8 array if all IDs are within [0, 255].
+bool addCompactMaterialIds(MeshLib::Properties const& properties, VtkAppendedData &appended,
+                           std::vector<std::uint8_t> &material_ids, std::ostream &cell_data)
+{
+	boost::optional<MeshLib::PropertyVector<int> const&> const prop (properties.getPropertyVector<int>("MaterialIDs"));
+	if (!prop || prop->getMeshItemType() != MeshLib::MeshItemType::Cell || prop->getNumberOfComponents() != 1)
+		return false;
+	if (std::any_of(prop->cbegin(), prop->cend(), [](int id) { return id < 0 || id > 255; }))
+		return false;
+	material_ids.assign(prop->cbegin(), prop->cend());
+	cell_data << "        " << appended.addDataArray("MaterialIDs", 1, material_ids.data(), material_ids.size()) << "\n";
+	return true;
+}
+
+/// Adds the declaration of the property to a PVTU file if it is of value type T.
+template <typename T>
+bool addPropertyDeclaration(MeshLib::Properties const& properties, std::string const& name,
+                            std::ostream &point_data, std::ostream &cell_data)
+{
+	boost::optional<MeshLib::PropertyVector<T> const&> const prop (properties.getPropertyVector<T>(name));
+	if (!prop)
+		return false;
+	std::ostream &out ((prop->getMeshItemType() == MeshLib::MeshItemType::Node) ? point_data : cell_data);
+	if (prop->getMeshItemType() == MeshLib::MeshItemType::Node || prop->getMeshItemType() == MeshLib::MeshItemType::Cell)
+		out << "      <PDataArray type=\"" << getVtkTypeName<T>() << "\" Name=\"" << name
+		    << "\" NumberOfComponents=\"" << prop->getNumberOfComponents() << "\"/>\n";
+	return true;
+}
+
+/// Returns the value of the given attribute of the first element containing it.
+std::string getAttribute(std::string const& xml, std::string const& attribute, std::size_t pos = 0)
+{
+	std::string const key (" " + attribute + "=\"");
+	std::size_t const begin (xml.find(key, pos));
+	if (begin == std::string::npos)
+		return std::string();
+	std::size_t const end (xml.find('"', begin + key.size()));
+	return xml.substr(begin + key.size(), end - begin - key.size());
+}
+
+/// Layout of an existing VTU file with raw appended data.
+struct VtuLayout
+{
+	std::string header;        ///< XML up to the AppendedData element
+	std::size_t padding_begin; ///< begin of the blanks in front of </CellData>
+	std::size_t padding_end;   ///< position of </CellData>
+	std::size_t data_begin;    ///< first byte of the appended data
+	std::size_t data_size;     ///< number of bytes used by the existing arrays
+	VtkAppendedData::Encoding encoding;
+	bool has_array;            ///< the array exists already, the remaining layout is not set
+};
+
+/// Analyses the file, returns false if the file cannot be extended.
+bool getVtuLayout(MappedFile const& file, std::string const& name, std::size_t n_values, VtuLayout &layout)
+{
+	std::string const marker ("<AppendedData encoding=\"raw\">");
+	char const* const appended (std::search(file.begin(), file.end(), marker.begin(), marker.end()));
+	char const* const data (std::find(appended, file.end(), '_'));
+	if (data == file.end())
+		return false;
+	layout.header.assign(file.begin(), appended);
+	layout.data_begin = data + 1 - file.begin();
+
+	std::string const& header (layout.header);
+	if (getAttribute(header, "type") != "UnstructuredGrid" ||
+	    getAttribute(header, "header_type") != "UInt64" ||
+	    getAttribute(header, "byte_order") != VtkAppendedData::getByteOrder() ||
+	    getAttribute(header, "NumberOfCells") != std::to_string(n_values))
+		return false;
+	std::string const compressor (getAttribute(header, "compressor"));
+	if (!compressor.empty() && compressor != "vtkZLibDataCompressor")
+		return false;
+	layout.encoding = compressor.empty() ? VtkAppendedData::Encoding::Raw : VtkAppendedData::Encoding::Zlib;
+
+	std::size_t const cell_data_begin (header.find("<CellData>"));
+	layout.padding_end = header.find(cell_data_end);
+	if (cell_data_begin == std::string::npos || layout.padding_end == std::string::npos)
+		return false;
+	std::string const cell_data (header.substr(cell_data_begin, layout.padding_end - cell_data_begin));
+	layout.has_array = (cell_data.find(" Name=\"" + name + "\"") != std::string::npos);
+	if (layout.has_array)
+		return true;
+	layout.padding_begin = header.find_last_not_of(" \n", layout.padding_end - 1) + 1;
+
+	// the existing data ends with the last byte of the array ending last
+	char const* const data_begin (data + 1);
+	std::size_t const n_available (file.end() - data_begin);
+	auto const readHeader = [data_begin](std::uint64_t pos)
+	{
+		std::uint64_t value;
+		std::memcpy(&value, data_begin + pos, sizeof(value));
+		return value;
+	};
+	layout.data_size = 0;
+	for (std::size_t pos = header.find(" offset=\""); pos != std::string::npos; pos = header.find(" offset=\"", pos + 1))
+	{
+		std::uint64_t const offset (std::stoull(getAttribute(header, "offset", pos)));
+		std::uint64_t size (sizeof(std::uint64_t));
+		if (offset + size > n_available)
+			return false;
+		if (layout.encoding == VtkAppendedData::Encoding::Raw)
+			size += readHeader(offset);
+		else
+		{
+			// number of blocks, block sizes and the compressed size of each block
+			std::uint64_t const n_blocks (readHeader(offset));
+			size *= 3 + n_blocks;
+			if (offset + size > n_available)
+				return false;
+			for (std::uint64_t i=0; i<n_blocks; ++i)
+				size += readHeader(offset + (3 + i) * sizeof(std::uint64_t));
+		}
+		if (offset + size > n_available)
+			return false;
+		layout.data_size = std::max<std::size_t>(layout.data_size, offset + size);
+	}
+	return true;
+}
+
+/// Moves the source file onto the existing target file.
+bool replaceFile(std::string const& source, std::string const& target)
+{
+#ifndef _WIN32
+	return std::rename(source.c_str(), target.c_str()) == 0;
+#else
+	// std::rename() fails on Windows if the target exists
+	return MoveFileExA(source.c_str(), target.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#endif
+}
+
+/// Implementation of appendCellArray() for arrays of value type T.
+template <typename T>
+AppendStatus appendCellArrayImpl(std::string const& file_name, std::string const& name,
+                                 T const* values, std::size_t n_values, unsigned n_threads)
+{
+	if (n_values == 0)
+		return AppendStatus::NotAppendable;
+
+	VtuLayout layout;
+	{
+		MappedFile const file(file_name);
+		if (!file.isOpen() || !getVtuLayout(file, name, n_values, layout))
+			return AppendStatus::NotAppendable;
+	}
+	if (layout.has_array)
+		return AppendStatus::ArrayExists;
+
+	VtkAppendedData appended(layout.encoding, n_threads, layout.data_size);
+	std::string const element ("\n" + array_indent + appended.addDataArray(name, 1, values, n_values) + "\n");
+	if (!appended.isValid())
+		return AppendStatus::NotAppendable;
+	std::string const cell_data_indent ("\n      ");
+	std::string const trailer ("\n  </AppendedData>\n</VTKFile>\n");
+	std::size_t const padding_size (layout.padding_end - layout.padding_begin);
+
+	if (element.size() + cell_data_indent.size() <= padding_size)
+	{
+		// the element fits into the padding, keep all offsets in the file unchanged
+		std::string padding (element);
+		padding.append(padding_size - element.size() - cell_data_indent.size(), ' ');
+		padding.append(cell_data_indent);
+
+		// The data and trailer are written first and the header is patched
+		// last, so an interrupted write never leaves a DataArray element
+		// referencing missing data.
+		std::fstream out(file_name.c_str(), std::ios::in | std::ios::out | std::ios::binary);
+		if (!out.is_open())
+			return AppendStatus::NotAppendable;
+		out.seekp(layout.data_begin + layout.data_size);
+		appended.writeArrays(out);
+		out << trailer;
+		out.flush();
+		if (!out.good())
+			return AppendStatus::NotAppendable;
+		out.seekp(layout.padding_begin);
+		out.write(padding.data(), padding.size());
+		out.flush();
+		return out.good() ? AppendStatus::Appended : AppendStatus::NotAppendable;
+	}
+
+	// rewrite the file with new padding, existing data is copied byte by byte
+	std::string const tmp_file (file_name + ".tmp");
+	{
+		MappedFile const file(file_name);
+		std::ofstream out(tmp_file.c_str(), std::ios::binary);
+		if (!file.isOpen() || !out.is_open())
+			return AppendStatus::NotAppendable;
+		out.write(file.begin(), layout.padding_begin);
+		out << element << std::string(cell_data_padding, ' ') << cell_data_indent;
+		out.write(file.begin() + layout.padding_end, layout.data_begin + layout.data_size - layout.padding_end);
+		appended.writeArrays(out);
+		out << trailer;
+		if (!out.good())
+			return AppendStatus::NotAppendable;
+	}
+	if (!replaceFile(tmp_file, file_name))
+	{
+		ERR ("appendCellArray(): Could not replace file %s.", file_name.c_str());
+		std::remove(tmp_file.c_str());
+		return AppendStatus::NotAppendable;
+	}
+	return AppendStatus::Appended;
+}
+} // end anonymous namespace
+
+std::vector<std::string> getVtuFormatNames()
+{
+	return { "binary", "raw", "zlib" };
+}
+
+VtuFormat getVtuFormat(std::string const& name)
+{
+	if (name == "raw")
+		return VtuFormat::Raw;
+	if (name == "zlib")
+		return VtuFormat::Zlib;
+	return VtuFormat::Binary;
+}
+
+VtkAppendedData::Encoding getEncoding(VtuFormat format)
+{
+	return (format == VtuFormat::Zlib) ? VtkAppendedData::Encoding::Zlib : VtkAppendedData::Encoding::Raw;
+}
+
+bool writeVtu(MeshLib::Mesh const& mesh, std::string const& file_name,
+              VtuFormat format, unsigned n_threads, bool compact_material_ids)
+{
+	if (format == VtuFormat::Binary)
+	{
+		MeshLib::IO::VtuInterface vtu(&mesh);
+		return vtu.writeToFile(file_name);
+	}
+
+	std::ofstream out(file_name.c_str(), std::ios::binary);
+	if (!out.is_open())
+	{
+		ERR ("writeVtu(): Could not open file %s.", file_name.c_str());
+		return false;
+	}
+
+	std::vector<MeshLib::Node*> const& nodes (mesh.getNodes());
+	std::vector<double> points;
+	points.reserve(3 * nodes.size());
+	for (MeshLib::Node const* node : nodes)
+		points.insert(points.end(), node->getCoords(), node->getCoords() + 3);
+
+	std::vector<MeshLib::Element*> const& elements (mesh.getElements());
+	std::vector<std::int64_t> connectivity;
+	std::vector<std::int64_t> offsets;
+	std::vector<std::uint8_t> types;
+	offsets.reserve(elements.size());
+	types.reserve(elements.size());
+	for (MeshLib::Element const* elem : elements)
+	{
+		std::size_t const n_elem_nodes (elem->getNNodes());
+		std::size_t const first (connectivity.size());
+		for (std::size_t i=0; i<n_elem_nodes; ++i)
+			connectivity.push_back(elem->getNodeIndex(i));
+		// the two triangles of OGS prisms are ordered the other way round than in VTK
+		if (elem->getCellType() == MeshLib::CellType::PRISM6)
+			std::swap_ranges(connectivity.begin() + first, connectivity.begin() + first + 3,
+			                 connectivity.begin() + first + 3);
+		offsets.push_back(connectivity.size());
+		types.push_back(getVtkCellType(elem->getCellType()));
+	}
+
+	VtkAppendedData appended(getEncoding(format), n_threads);
+	std::ostringstream point_data;
+	std::ostringstream cell_data;
+	MeshLib::Properties const& properties (mesh.getProperties());
+	std::vector<std::uint8_t> material_ids;
+	for (std::string const& name : properties.getPropertyVectorNames())
+	{
+		if (compact_material_ids && name == "MaterialIDs" &&
+		    addCompactMaterialIds(properties, appended, material_ids, cell_data))
+			continue;
+		if (addProperty<double>(properties, name, appended, point_data, cell_data) ||
+		    addProperty<float>(properties, name, appended, point_data, cell_data) ||
+		    addProperty<int>(properties, name, appended, point_data, cell_data) ||
+		    addProperty<unsigned>(properties, name, appended, point_data, cell_data) ||
+		    addProperty<long>(properties, name, appended, point_data, cell_data) ||
+		    addProperty<unsigned long>(properties, name, appended, point_data, cell_data) ||
+		    addProperty<long long>(properties, name, appended, point_data, cell_data) ||
+		    addProperty<unsigned long long>(properties, name, appended, point_data, cell_data) ||
+		    addProperty<char>(properties, name, appended, point_data, cell_data) ||
+		    addProperty<unsigned char>(properties, name, appended, point_data, cell_data))
+			continue;
+		WARN ("writeVtu(): Skipping property \"%s\" of unsupported type.", name.c_str());
+	}
+
+	out << "<?xml version=\"1.0\"?>\n"
+	    << "<VTKFile type=\"UnstructuredGrid\" version=\"1.0\" " << appended.getFileAttributes() << ">\n"
+	    << "  <UnstructuredGrid>\n"
+	    << "    <Piece NumberOfPoints=\"" << nodes.size() << "\" NumberOfCells=\"" << elements.size() << "\">\n"
+	    << "      <PointData>\n" << point_data.str() << "      </PointData>\n"
+	    << "      <CellData>\n" << cell_data.str()
+	    << std::string(cell_data_padding, ' ') << "\n      </CellData>\n"
+	    << "      <Points>\n"
+	    << "        " << appended.addDataArray("Points", 3, points.data(), points.size()) << "\n"
+	    << "      </Points>\n"
+	    << "      <Cells>\n"
+	    << "        " << appended.addDataArray("connectivity", 1, connectivity.data(), connectivity.size()) << "\n"
+	    << "        " << appended.addDataArray("offsets", 1, offsets.data(), offsets.size()) << "\n"
+	    << "        " << appended.addDataArray("types", 1, types.data(), types.size()) << "\n"
+	    << "      </Cells>\n"
+	    << "    </Piece>\n"
+	    << "  </UnstructuredGrid>\n";
+	if (!appended.write(out))
+		return false;
+	out << "</VTKFile>\n";
+	return out.good();
+}
+
+AppendStatus appendCellArray(std::string const& file_name, std::string const& name,
+                             double const* values, std::size_t n_values, unsigned n_threads)
+{
+	return appendCellArrayImpl(file_name, name, values, n_values, n_threads);
+}
+
+AppendStatus appendCellArray(std::string const& file_name, std::string const& name,
+                             float const* values, std::size_t n_values, unsigned n_threads)
+{
+	return appendCellArrayImpl(file_name, name, values, n_values, n_threads);
+}
+
+bool writePvtu(MeshLib::Mesh const& mesh, std::string const& file_name,
+               std::vector<std::string> const& piece_files)
+{
+	std::ofstream out(file_name.c_str());
+	if (!out.is_open())
+	{
+		ERR ("writePvtu(): Could not open file %s.", file_name.c_str());
+		return false;
+	}
+
+	// declarations follow the types written by writeVtu()
+	std::ostringstream point_data;
+	std::ostringstream cell_data;
+	MeshLib::Properties const& properties (mesh.getProperties());
+	for (std::string const& name : properties.getPropertyVectorNames())
+	{
+		if (addPropertyDeclaration<double>(properties, name, point_data, cell_data) ||
+		    addPropertyDeclaration<float>(properties, name, point_data, cell_data) ||
+		    addPropertyDeclaration<int>(properties, name, point_data, cell_data) ||
+		    addPropertyDeclaration<unsigned>(properties, name, point_data, cell_data) ||
+		    addPropertyDeclaration<long>(properties, name, point_data, cell_data) ||
+		    addPropertyDeclaration<unsigned long>(properties, name, point_data, cell_data) ||
+		    addPropertyDeclaration<long long>(properties, name, point_data, cell_data) ||
+		    addPropertyDeclaration<unsigned long long>(properties, name, point_data, cell_data) ||
+		    addPropertyDeclaration<char>(properties, name, point_data, cell_data) ||
+		    addPropertyDeclaration<unsigned char>(properties, name, point_data, cell_data))
+			continue;
+		WARN ("writePvtu(): Skipping property \"%s\" of unsupported type.", name.c_str());
+	}
+
+	out << "<?xml version=\"1.0\"?>\n"
+	    << "<VTKFile type=\"PUnstructuredGrid\" version=\"1.0\" byte_order=\"" << VtkAppendedData::getByteOrder()
+	    << "\" header_type=\"UInt64\">\n"
+	    << "  <PUnstructuredGrid GhostLevel=\"0\">\n"
+	    << "    <PPointData>\n" << point_data.str() << "    </PPointData>\n"
+	    << "    <PCellData>\n" << cell_data.str() << "    </PCellData>\n"
+	    << "    <PPoints>\n"
+	    << "      <PDataArray type=\"Float64\" NumberOfComponents=\"3\"/>\n"
+	    << "    </PPoints>\n";
+	for (std::string const& piece : piece_files)
+		out << "    <Piece Source=\"" << piece << "\"/>\n";
+	out << "  </PUnstructuredGrid>\n"
+	    << "</VTKFile>\n";
+	return out.good();
+}
+
+} // end namespace ToolsLib
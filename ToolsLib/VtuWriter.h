@@ -0,0 +1,95 @@
+/**
+ * @file   VtuWriter.h
+ * @author Karsten Rink
+ * @date   2026/10/14
+ * @brief  Fast VTU output with raw binary or compressed appended data
+ *
+ * @copyright
+ * Copyright (c) 2012-2026, OpenGeoSys Community (http://www.opengeosys.org)
+ *            Distributed under a Modified BSD License.
+ *              See accompanying file LICENSE.txt or
+ *              http://www.opengeosys.org/LICENSE.txt
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "VtkAppendedData.h"
+
+namespace MeshLib {
+	class Mesh;
+}
+
+namespace ToolsLib
+{
+
+/// Output formats for unstructured grids.
+enum class VtuFormat
+{
+	Binary, ///< VTK's own writer via MeshLib::IO::VtuInterface
+	Raw,    ///< raw binary appended data
+	Zlib    ///< zlib compressed appended data
+};
+
+/// Names of the formats as accepted by getVtuFormat(), e.g. for a TCLAP::ValuesConstraint.
+std::vector<std::string> getVtuFormatNames();
+
+/// Returns the format of the given name, Binary for unknown names.
+VtuFormat getVtuFormat(std::string const& name);
+
+/// Returns the appended data encoding used for the given format.
+VtkAppendedData::Encoding getEncoding(VtuFormat format);
+
+/**
+ * Writes the mesh including all node and cell properties of the supported
+ * value types (floating point, 8, 32 and 64 bit integers) to a VTU file. For the Raw and Zlib formats the file is
+ * written directly (compressing blocks of each array on n_threads threads),
+ * otherwise MeshLib::IO::VtuInterface is used. With compact_material_ids
+ * integer MaterialIDs are written as UInt8 if all IDs are within [0, 255]
+ * (Raw and Zlib only). Returns false if the file cannot be written or an
+ * array cannot be compressed.
+ */
+bool writeVtu(MeshLib::Mesh const& mesh, std::string const& file_name,
+              VtuFormat format, unsigned n_threads = 1, bool compact_material_ids = false);
+
+/// Result of appendCellArray().
+enum class AppendStatus
+{
+	Appended,     ///< the array has been added to the file
+	ArrayExists,  ///< the file already contains an array of that name
+	NotAppendable ///< the file cannot be extended, e.g. it has a different format
+};
+
+/**
+ * Adds a scalar cell array to an existing VTU file written with the Raw or
+ * Zlib format without decoding the data already contained in the file.
+ * The new array is appended to the end of the data section and afterwards
+ * its DataArray element is written into the padding reserved by writeVtu(),
+ * i.e. only the new data is written. If the padding is used up the file
+ * is rewritten to a temporary file, copying the existing data unchanged,
+ * which then replaces the original file.
+ * Returns NotAppendable if the file has a different format, the number of
+ * values does not match the number of cells or writing fails, the file then
+ * needs to be rewritten by other means.
+ */
+AppendStatus appendCellArray(std::string const& file_name, std::string const& name,
+                             double const* values, std::size_t n_values, unsigned n_threads = 1);
+
+/// Adds a Float32 cell array, see above.
+AppendStatus appendCellArray(std::string const& file_name, std::string const& name,
+                             float const* values, std::size_t n_values, unsigned n_threads = 1);
+
+/**
+ * Writes a parallel VTU file combining the given pieces. The pieces have to
+ * be written by writeVtu() with the Raw or Zlib format (and without compact
+ * MaterialIDs) from meshes with the same properties as the given mesh, e.g.
+ * the piece of the calling process. Piece file names are written as given,
+ * i.e. they have to be relative to the location of the PVTU file.
+ */
+bool writePvtu(MeshLib::Mesh const& mesh, std::string const& file_name,
+               std::vector<std::string> const& piece_files);
+
+} // end namespace ToolsLib
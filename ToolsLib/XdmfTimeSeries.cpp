@@ -0,0 +1,258 @@
+/**
+ * @file   XdmfTimeSeries.cpp
+ * @author Karsten Rink
+ * @date   2026/10/14
+ * @brief  Time series output sharing a single copy of the mesh geometry
+ *
+ * @copyright
+ * Copyright (c) 2012-2026, OpenGeoSys Community (http://www.opengeosys.org)
+ *            Distributed under a Modified BSD License.
+ *              See accompanying file LICENSE.txt or
+ *              http://www.opengeosys.org/LICENSE.txt
+ */
+
+#include "XdmfTimeSeries.h"
+
+#include <algorithm>
+#include <cstdint>
+
+// ThirdParty/logog
+#include "logog/include/logog.hpp"
+
+#include "BaseLib/FileTools.h"
+
+#include "MeshLib/Mesh.h"
+#include "MeshLib/MeshEnums.h"
+#include "MeshLib/Node.h"
+#include "MeshLib/Properties.h"
+#include "MeshLib/PropertyVector.h"
+#include "MeshLib/Elements/Element.h"
+
+#include "VtkAppendedData.h"
+
+namespace ToolsLib
+{
+
+namespace
+{
+std::string getMeshFileName(std::string const& xdmf_file)
+{
+	return BaseLib::dropFileExtension(xdmf_file) + "_mesh.bin";
+}
+
+std::string getValuesFileName(std::string const& xdmf_file, std::string const& array_name)
+{
+	return BaseLib::dropFileExtension(xdmf_file) + "_" + array_name + ".bin";
+}
+
+/// XDMF mixed topology code of the given element type, 0 if unknown.
+std::int64_t getXdmfCellType(MeshLib::CellType type)
+{
+	switch (type)
+	{
+	case MeshLib::CellType::POINT1:    return 1;
+	case MeshLib::CellType::LINE2:     return 2;
+	case MeshLib::CellType::LINE3:     return 34;
+	case MeshLib::CellType::TRI3:      return 4;
+	case MeshLib::CellType::TRI6:      return 36;
+	case MeshLib::CellType::QUAD4:     return 5;
+	case MeshLib::CellType::QUAD8:     return 37;
+	case MeshLib::CellType::QUAD9:     return 35;
+	case MeshLib::CellType::TET4:      return 6;
+	case MeshLib::CellType::TET10:     return 38;
+	case MeshLib::CellType::HEX8:      return 9;
+	case MeshLib::CellType::HEX20:     return 48;
+	case MeshLib::CellType::HEX27:     return 50;
+	case MeshLib::CellType::PRISM6:    return 8;
+	case MeshLib::CellType::PRISM15:   return 40;
+	case MeshLib::CellType::PRISM18:   return 41;
+	case MeshLib::CellType::PYRAMID5:  return 7;
+	case MeshLib::CellType::PYRAMID13: return 39;
+	default:                           return 0;
+	}
+}
+
+std::string getEndian()
+{
+	return (std::string(VtkAppendedData::getByteOrder()) == "LittleEndian") ? "Little" : "Big";
+}
+
+std::string getDataItem(std::string const& dimensions, std::string const& number_type,
+	unsigned precision, std::size_t offset, std::string const& file_name)
+{
+	return "<DataItem Dimensions=\"" + dimensions + "\" NumberType=\"" + number_type +
+		"\" Precision=\"" + std::to_string(precision) + "\" Format=\"Binary\" Endian=\"" +
+		getEndian() + "\" Seek=\"" + std::to_string(offset) + "\">" + file_name + "</DataItem>";
+}
+
+} // end anonymous namespace
+
+template <typename T>
+bool XdmfTimeSeries::writeProperty(MeshLib::Properties const& properties, std::string const& name,
+	std::string const& number_type, std::size_t n_nodes, std::size_t n_cells,
+	std::ofstream &out, StaticArray &array)
+{
+	boost::optional<MeshLib::PropertyVector<T> const&> const prop (properties.getPropertyVector<T>(name));
+	if (!prop)
+		return false;
+	bool const is_node_array (prop->getMeshItemType() == MeshLib::MeshItemType::Node);
+	array.name = name;
+	array.center = is_node_array ? "Node" : "Cell";
+	array.type = number_type;
+	array.n_components = prop->getNumberOfComponents();
+	array.n_items = is_node_array ? n_nodes : n_cells;
+	array.precision = sizeof(T);
+	array.offset = static_cast<std::size_t>(out.tellp());
+	if (prop->size() < array.n_items * array.n_components)
+		return false;
+	out.write(reinterpret_cast<char const*>(prop->data()), array.n_items * array.n_components * sizeof(T));
+	return true;
+}
+
+XdmfTimeSeries::XdmfTimeSeries(std::string const& xdmf_file, std::string const& array_name, std::size_t n_cells,
+	std::size_t value_size)
+: _xdmf_file(xdmf_file), _array_name(array_name), _n_cells(n_cells), _value_size(value_size),
+  _n_nodes(0), _topology_size(0), _topology_offset(0), _n_steps(0)
+{
+}
+
+std::unique_ptr<XdmfTimeSeries> XdmfTimeSeries::create(MeshLib::Mesh const& mesh,
+	std::string const& xdmf_file, std::string const& array_name, bool single_precision)
+{
+	std::unique_ptr<XdmfTimeSeries> series (new XdmfTimeSeries(xdmf_file, array_name, mesh.getNElements(),
+		single_precision ? sizeof(float) : sizeof(double)));
+	std::string const mesh_file (getMeshFileName(xdmf_file));
+	std::ofstream out(mesh_file.c_str(), std::ios::binary);
+	if (!out.is_open())
+	{
+		ERR ("XdmfTimeSeries::create(): Could not open file %s.", mesh_file.c_str());
+		return nullptr;
+	}
+
+	std::vector<MeshLib::Node*> const& nodes (mesh.getNodes());
+	series->_n_nodes = nodes.size();
+	for (MeshLib::Node const* node : nodes)
+		out.write(reinterpret_cast<char const*>(node->getCoords()), 3 * sizeof(double));
+
+	std::vector<std::int64_t> topology;
+	for (MeshLib::Element const* elem : mesh.getElements())
+	{
+		std::int64_t const type (getXdmfCellType(elem->getCellType()));
+		if (type == 0)
+		{
+			ERR ("XdmfTimeSeries::create(): Unsupported element type.");
+			return nullptr;
+		}
+		topology.push_back(type);
+		// poly-vertices and poly-lines are followed by their number of nodes
+		if (type == 1 || type == 2)
+			topology.push_back(elem->getNNodes());
+		std::size_t const first (topology.size());
+		for (unsigned i=0; i<elem->getNNodes(); ++i)
+			topology.push_back(elem->getNodeIndex(i));
+		// the two triangles of OGS prisms are ordered the other way round
+		if (elem->getCellType() == MeshLib::CellType::PRISM6)
+			std::swap_ranges(topology.begin() + first, topology.begin() + first + 3,
+			                 topology.begin() + first + 3);
+	}
+	series->_topology_offset = static_cast<std::size_t>(out.tellp());
+	series->_topology_size = topology.size();
+	out.write(reinterpret_cast<char const*>(topology.data()), topology.size() * sizeof(std::int64_t));
+
+	MeshLib::Properties const& properties (mesh.getProperties());
+	std::size_t const n_cells (mesh.getNElements());
+	for (std::string const& name : properties.getPropertyVectorNames())
+	{
+		if (name == array_name)
+			continue;
+		StaticArray array;
+		if (writeProperty<double>(properties, name, "Float", nodes.size(), n_cells, out, array) ||
+		    writeProperty<float>(properties, name, "Float", nodes.size(), n_cells, out, array) ||
+		    writeProperty<int>(properties, name, "Int", nodes.size(), n_cells, out, array))
+			series->_static_arrays.push_back(array);
+		else
+			WARN ("XdmfTimeSeries::create(): Skipping property \"%s\".", name.c_str());
+	}
+	if (!out.good())
+		return nullptr;
+
+	std::string const values_file (getValuesFileName(xdmf_file, array_name));
+	series->_values.open(values_file.c_str(), std::ios::binary);
+	if (!series->_values.is_open())
+	{
+		ERR ("XdmfTimeSeries::create(): Could not open file %s.", values_file.c_str());
+		return nullptr;
+	}
+	return series;
+}
+
+bool XdmfTimeSeries::writeTimeStep(std::size_t index, double const* values)
+{
+	// conversion is done before locking such that it runs concurrently
+	std::vector<float> float_values;
+	char const* data (reinterpret_cast<char const*>(values));
+	if (_value_size == sizeof(float))
+	{
+		float_values.assign(values, values + _n_cells);
+		data = reinterpret_cast<char const*>(float_values.data());
+	}
+
+	std::lock_guard<std::mutex> lock(_mutex);
+	_values.seekp(index * _n_cells * _value_size);
+	_values.write(data, _n_cells * _value_size);
+	_n_steps = std::max(_n_steps, index + 1);
+	return _values.good();
+}
+
+bool XdmfTimeSeries::finalize()
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	_values.close();
+
+	std::ofstream out(_xdmf_file.c_str());
+	if (!out.is_open())
+	{
+		ERR ("XdmfTimeSeries::finalize(): Could not open file %s.", _xdmf_file.c_str());
+		return false;
+	}
+
+	std::string const mesh_file (BaseLib::extractBaseName(getMeshFileName(_xdmf_file)));
+	std::string const values_file (BaseLib::extractBaseName(getValuesFileName(_xdmf_file, _array_name)));
+	std::string const n_cells (std::to_string(_n_cells));
+	out << "<?xml version=\"1.0\" ?>\n"
+	    << "<Xdmf Version=\"2.0\">\n"
+	    << "  <Domain>\n"
+	    << "    <Grid Name=\"" << _array_name << "\" GridType=\"Collection\" CollectionType=\"Temporal\">\n";
+	for (std::size_t t=0; t<_n_steps; ++t)
+	{
+		out << "      <Grid Name=\"" << _array_name << "_" << t << "\" GridType=\"Uniform\">\n"
+		    << "        <Time Value=\"" << t << "\"/>\n"
+		    << "        <Topology TopologyType=\"Mixed\" NumberOfElements=\"" << n_cells << "\">\n"
+		    << "          " << getDataItem(std::to_string(_topology_size), "Int", 8, _topology_offset, mesh_file) << "\n"
+		    << "        </Topology>\n"
+		    << "        <Geometry GeometryType=\"XYZ\">\n"
+		    << "          " << getDataItem(std::to_string(_n_nodes) + " 3", "Float", 8, 0, mesh_file) << "\n"
+		    << "        </Geometry>\n";
+		for (StaticArray const& array : _static_arrays)
+		{
+			std::string const dimensions (std::to_string(array.n_items) +
+				((array.n_components > 1) ? " " + std::to_string(array.n_components) : ""));
+			std::string const attribute_type ((array.n_components == 1) ? "Scalar" :
+				((array.n_components == 3) ? "Vector" : "Matrix"));
+			out << "        <Attribute Name=\"" << array.name << "\" AttributeType=\"" << attribute_type
+			    << "\" Center=\"" << array.center << "\">\n"
+			    << "          " << getDataItem(dimensions, array.type, array.precision, array.offset, mesh_file) << "\n"
+			    << "        </Attribute>\n";
+		}
+		out << "        <Attribute Name=\"" << _array_name << "\" AttributeType=\"Scalar\" Center=\"Cell\">\n"
+		    << "          " << getDataItem(n_cells, "Float", _value_size, t * _n_cells * _value_size, values_file) << "\n"
+		    << "        </Attribute>\n"
+		    << "      </Grid>\n";
+	}
+	out << "    </Grid>\n"
+	    << "  </Domain>\n"
+	    << "</Xdmf>\n";
+	return out.good();
+}
+
+} // end namespace ToolsLib
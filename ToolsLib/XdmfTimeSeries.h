@@ -0,0 +1,90 @@
+/**
+ * @file   XdmfTimeSeries.h
+ * @author Karsten Rink
+ * @date   2026/10/14
+ * @brief  Time series output sharing a single copy of the mesh geometry
+ *
+ * @copyright
+ * Copyright (c) 2012-2026, OpenGeoSys Community (http://www.opengeosys.org)
+ *            Distributed under a Modified BSD License.
+ *              See accompanying file LICENSE.txt or
+ *              http://www.opengeosys.org/LICENSE.txt
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace MeshLib {
+	class Mesh;
+	class Properties;
+}
+
+namespace ToolsLib
+{
+
+/**
+ * Writes a time series of one cell array on a fixed mesh as an XDMF file
+ * with raw binary heavy data. Geometry, topology and all arrays already
+ * present on the mesh are written once to "<base>_mesh.bin", the values of
+ * all time steps are written consecutively to "<base>_<array name>.bin".
+ * The XDMF file itself only references these files and is written by
+ * finalize(). Time step values are stored as Float64 or, if requested,
+ * as Float32.
+ */
+class XdmfTimeSeries
+{
+public:
+	/// Writes the mesh data, returns nullptr if the files cannot be written.
+	static std::unique_ptr<XdmfTimeSeries> create(MeshLib::Mesh const& mesh,
+		std::string const& xdmf_file, std::string const& array_name, bool single_precision = false);
+
+	/// Writes the first n_cells values as time step index, can be called
+	/// concurrently and in any order of time steps.
+	bool writeTimeStep(std::size_t index, double const* values);
+
+	/// Writes the XDMF file with the time steps 0 to the largest index written.
+	bool finalize();
+
+private:
+	XdmfTimeSeries(std::string const& xdmf_file, std::string const& array_name, std::size_t n_cells,
+		std::size_t value_size);
+
+	/// XML of a static array stored in the mesh file.
+	struct StaticArray
+	{
+		std::string name;
+		std::string center;
+		std::string type;
+		unsigned n_components;
+		std::size_t n_items;
+		unsigned precision;
+		std::size_t offset;
+	};
+
+	/// Appends the property to the mesh file if it is of value type T.
+	template <typename T>
+	static bool writeProperty(MeshLib::Properties const& properties, std::string const& name,
+		std::string const& number_type, std::size_t n_nodes, std::size_t n_cells,
+		std::ofstream &out, StaticArray &array);
+
+	std::string const _xdmf_file;
+	std::string const _array_name;
+	std::size_t const _n_cells;
+	std::size_t const _value_size;
+	std::size_t _n_nodes;
+	std::size_t _topology_size;
+	std::size_t _topology_offset;
+	std::vector<StaticArray> _static_arrays;
+
+	std::mutex _mutex;
+	std::ofstream _values;
+	std::size_t _n_steps;
+};
+
+} // end namespace ToolsLib
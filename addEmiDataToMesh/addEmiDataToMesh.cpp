@@ -12,6 +12,22 @@
  */
 
 #include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#ifdef USE_MPI
+#include <mpi.h>
+#endif
 
 // TCLAP
 #include "tclap/CmdLine.h"
@@ -20,15 +36,16 @@
 #include "logog/include/logog.hpp"
 
 // BaseLib
+#include "BaseLib/FileTools.h"
 #include "BaseLib/LogogSimpleFormatter.h"
+#include "BaseLib/StringTools.h"
 
 // FileIO
+#include "GeoLib/IO/AsciiRasterInterface.h"
 #include "MeshLib/IO/VtkIO/VtuInterface.h"
-#include "FileIO/CsvInterface.h"
 
 // GeoLib
-#include "GeoLib/Grid.h"
-#include "GeoLib/AnalyticalGeometry.h"
+#include "GeoLib/Raster.h"
 
 // MeshLib
 #include "MeshLib/Mesh.h"
@@ -36,154 +53,1214 @@
 #include "MeshLib/Properties.h"
 #include "MeshLib/PropertyVector.h"
 #include "MeshLib/Elements/Element.h"
-#include "MeshLib/MeshEditing/projectMeshOntoPlane.h"
+#include "MeshLib/MeshEditing/RemoveMeshComponents.h"
+
+#include "ToolsLib/BoundedQueue.h"
+#include "ToolsLib/CellAggregation.h"
+#include "ToolsLib/ElementGrid.h"
+#include "ToolsLib/ParallelFor.h"
+#include "ToolsLib/PhaseTimer.h"
+#include "ToolsLib/PointBinning.h"
+#include "ToolsLib/PointSamples.h"
+#include "ToolsLib/RasterSampling.h"
+#include "ToolsLib/RegularGrid.h"
+#include "ToolsLib/StructuredQuadMesh.h"
+#include "ToolsLib/ThreadPool.h"
+#include "ToolsLib/VtuWriter.h"
 
-std::vector<double> getDataFromCSV(MeshLib::Mesh const& mesh, std::vector<GeoLib::Point*> data_points)
+/// Name of the array holding the given statistic of a channel, the mean is
+/// stored under the name of the channel itself.
+std::string getArrayName(std::string const& channel_name, ToolsLib::Statistic statistic)
 {
-	GeoLib::Point const origin(0, 0, 0);
-	MathLib::Vector3 const normal(0,0,-1);
-	MeshLib::Mesh* flat_mesh (MeshLib::projectMeshOntoPlane(mesh, origin, normal));
-	std::size_t n_elems (flat_mesh->getNElements());
-	std::vector<double> data(n_elems, 0.0);
-	std::vector<std::size_t> counter(n_elems, 0);
+	if (statistic == ToolsLib::Statistic::Mean)
+		return channel_name;
+	return channel_name + "_" + ToolsLib::getStatisticName(statistic);
+}
 
-	std::vector<MeshLib::Node*> const& nodes (flat_mesh->getNodes());
-	GeoLib::Grid<MeshLib::Node> grid(nodes.cbegin(), nodes.cend());
+/**
+ * A data channel, i.e. one value column of the EMI files of all regions.
+ * The files of a region are called <csv>_<region><file suffix>.txt, all
+ * channels with the same suffix are read from the same files.
+ */
+struct EmiChannel
+{
+	std::string array_name;
+	std::string file_suffix;
+	std::size_t column;
+};
 
-	std::size_t const n_points (data_points.size());
-	for (std::size_t i=0; i<n_points; ++i)
+/**
+ * Parses a channel given either as specifier (e.g. 'H', read from column 3
+ * of the files <csv>_<region>_H.txt into array TM_DD_H) or as
+ * '<name>:<column>' for files <csv>_<region>.txt containing several channels.
+ */
+bool parseChannel(std::string const& str, EmiChannel &channel)
+{
+	std::size_t const separator (str.rfind(':'));
+	if (separator == std::string::npos)
 	{
-		MeshLib::Node const pnt((*data_points[i])[0], (*data_points[i])[1], 0.0);
-		MeshLib::Node const*const node = grid.getNearestPoint(pnt);
-		std::vector<MeshLib::Element*> const& conn_elems (node->getElements());
-		std::size_t const n_conn_elems (conn_elems.size());
-		for (std::size_t j=0; j<n_conn_elems; ++j)
+		channel.array_name = "TM_DD_" + str;
+		channel.file_suffix = "_" + str;
+		channel.column = 3;
+		return !str.empty();
+	}
+
+	channel.array_name = str.substr(0, separator);
+	channel.file_suffix.clear();
+	char* end (nullptr);
+	std::string const column (str.substr(separator + 1));
+	channel.column = std::strtoul(column.c_str(), &end, 10);
+	if (channel.array_name.empty() || column.empty() || *end != '\0')
+	{
+		ERR ("Invalid channel \'%s\', expected <name>:<column>.", str.c_str());
+		return false;
+	}
+	return true;
+}
+
+/**
+ * Streaming variant of addFilesAsArrays() for surveys that do not fit into
+ * memory. The files are read in chunks of chunk_size points on a separate
+ * thread while the previous chunk is binned. Each chunk is added to the
+ * running statistics and dropped afterwards, hence at most three chunks are
+ * kept in memory at any time.
+ */
+std::vector<std::vector<double>> streamFilesAsArrays(std::string const& csv_base_name,
+	std::vector<std::string> const& regions, std::string const& file_suffix,
+	std::vector<std::size_t> const& columns, std::size_t chunk_size,
+	ToolsLib::BinningContext const& context, ToolsLib::PhaseTimer &timer)
+{
+	// one chunk is binned, one is queued and one is read at a time
+	ToolsLib::BoundedQueue<std::unique_ptr<ToolsLib::PointSamples>> queue(1);
+	bool read_error (false);
+	std::thread reader([&]()
+	{
+		for (std::string const& region : regions)
 		{
-			if (GeoLib::gaussPointInTriangle(pnt, *conn_elems[j]->getNode(0), *conn_elems[j]->getNode(1), *conn_elems[j]->getNode(2)))
+			std::string const file_name (csv_base_name + "_" + region + file_suffix + ".txt");
+			INFO ("Reading file %s in chunks of %d points.", file_name.c_str(), chunk_size);
+			ToolsLib::PointSampleReader in(file_name, '\t', 1, 2, columns);
+			if (!in.isOpen())
 			{
-				std::size_t const idx (conn_elems[j]->getID());
-				data[idx] += ((*data_points[i])[2]);
-				counter[idx]++;
+				ERR ("Could not open file %s.", file_name.c_str());
+				read_error = true;
 				break;
 			}
+			for (;;)
+			{
+				std::unique_ptr<ToolsLib::PointSamples> chunk (new ToolsLib::PointSamples(columns.size()));
+				{
+					ToolsLib::ScopedPhase phase(timer, "parse");
+					std::size_t const n_bytes (in.getBytesRead());
+					if (!in.read(chunk_size, *chunk))
+						break;
+					phase.addBytesRead(in.getBytesRead() - n_bytes);
+					phase.addItems(chunk->size());
+				}
+				queue.push(std::move(chunk));
+			}
 		}
+		queue.close();
+	});
+
+	ToolsLib::CellAggregator aggregator(context.n_elements, columns.size(), context.settings);
+	std::size_t n_points (0);
+	std::unique_ptr<ToolsLib::PointSamples> chunk;
+	while (queue.pop(chunk))
+	{
+		ToolsLib::ScopedPhase phase(timer, "bin");
+		phase.addItems(chunk->size());
+		ToolsLib::binPoints(context, *chunk, aggregator);
+		n_points += chunk->size();
+		chunk.reset();
 	}
+	reader.join();
 
-	for (std::size_t i=0; i<n_elems; ++i)
-		if (counter[i] > 0)
-			data[i] /= static_cast<double>(counter[i]);
+	if (read_error || n_points == 0)
+	{
+		ERR ("Error reading CSV-file.");
+		return std::vector<std::vector<double>>();
+	}
+	INFO ("Binned %d points.", n_points);
+	ToolsLib::ScopedPhase phase(timer, "bin");
+	return aggregator.getResults(context.n_threads);
+}
+
+/**
+ * Reads the given channels, which share the same file suffix, from the files
+ * of all regions and bins them in a single pass. If chunk_size is not 0 the
+ * files are streamed (see streamFilesAsArrays()).
+ * @return one array per channel and statistic, nothing in case of an error.
+ */
+std::vector<std::vector<double>> addFilesAsArrays(std::string const& csv_base_name,
+	std::vector<std::string> const& regions, std::vector<EmiChannel> const& channels,
+	std::size_t chunk_size, ToolsLib::BinningContext const& context, ToolsLib::PhaseTimer &timer)
+{
+	std::vector<std::size_t> columns;
+	for (EmiChannel const& channel : channels)
+		columns.push_back(channel.column);
+	if (chunk_size > 0)
+		return streamFilesAsArrays(csv_base_name, regions, channels[0].file_suffix, columns, chunk_size, context, timer);
+
+	ToolsLib::PointSamples points(channels.size());
+	{
+		ToolsLib::ScopedPhase parse_phase(timer, "parse");
+		for (std::string const& region : regions)
+		{
+			std::string const file_name (csv_base_name + "_" + region + channels[0].file_suffix + ".txt");
+			INFO ("Reading file %s.", file_name.c_str());
+			if (ToolsLib::readPointSamples(file_name, '\t', 1, 2, columns, points) < 0)
+			{
+				ERR ("Error reading CSV-file.");
+				return std::vector<std::vector<double>>();
+			}
+			parse_phase.addBytesRead(ToolsLib::getFileSize(file_name));
+		}
+		parse_phase.addItems(points.size());
+	}
+
+	if (points.size() == 0)
+	{
+		ERR ("Error reading CSV-file.");
+		return std::vector<std::vector<double>>();
+	}
+
+	ToolsLib::ScopedPhase bin_phase(timer, "bin");
+	bin_phase.addItems(points.size());
+	return ToolsLib::binPoints(context, points);
+}
+
+/// Format and precision of the output files.
+struct OutputSettings
+{
+	ToolsLib::VtuFormat format;
+	bool float32; ///< Float32 data arrays
+	bool compact_material_ids; ///< UInt8 MaterialIDs if their range allows it
+	bool asc;     ///< additional ASCII raster per array for regular grids
+};
+
+/// One mesh together with its search structure, shared by all jobs using it.
+struct CachedMesh
+{
+	std::mutex load_mutex;
+	bool is_loaded = false;
+	int error = 0;
+	std::unique_ptr<MeshLib::Mesh> mesh;
+	std::unique_ptr<ToolsLib::BinningContext> context;
+
+	/// arrays are added, written and removed by one job at a time
+	std::mutex write_mutex;
+	std::size_t n_pending_jobs = 0;
+};
+
+/// Input and output of one run of the tool.
+struct EmiJob
+{
+	std::string mesh_file;
+	std::string csv_base_name;
+	std::vector<EmiChannel> channels;
+	std::vector<std::string> regions;
+	std::string output_file;
+};
+
+/// Sets the channels and regions of the job, empty lists select the default.
+bool setChannels(std::vector<std::string> const& specifiers, std::vector<std::string> const& regions, EmiJob &job)
+{
+	std::vector<std::string> const channel_names (specifiers.empty() ? std::vector<std::string>{ "H", "V" } : specifiers);
+	job.channels.clear();
+	for (std::string const& name : channel_names)
+	{
+		EmiChannel channel;
+		if (!parseChannel(name, channel))
+			return false;
+		job.channels.push_back(channel);
+	}
+	job.regions = regions.empty() ? std::vector<std::string>{ "A", "B", "C" } : regions;
+	return true;
+}
+
+/**
+ * Reads the mesh the data is binned onto, either a 2d mesh (*.vtu) or a
+ * raster (*.asc, *.grd), which is converted into a flat quad mesh with one
+ * element per pixel, numbered row by row from the lower left corner.
+ */
+MeshLib::Mesh* readTargetMesh(std::string const& file_name)
+{
+	if (!BaseLib::hasFileExtension("asc", file_name) && !BaseLib::hasFileExtension("grd", file_name))
+		return MeshLib::IO::VtuInterface::readVTUFile(file_name);
+
+	std::unique_ptr<GeoLib::Raster> const raster (GeoLib::IO::AsciiRasterInterface::readRaster(file_name));
+	if (raster == nullptr)
+		return nullptr;
+	ToolsLib::RasterView const view (ToolsLib::makeRasterView(*raster));
+	auto const node_coords = [&view](std::size_t r, std::size_t c)
+	{
+		return std::array<double, 3> {{ view.x0 + c * view.cell_size, view.y0 + r * view.cell_size, 0.0 }};
+	};
+	std::unique_ptr<MeshLib::Mesh> mesh (ToolsLib::createStructuredQuadMesh(
+		BaseLib::extractBaseName(BaseLib::dropFileExtension(file_name)),
+		view.n_rows + 1, view.n_cols + 1, view.n_rows, node_coords));
+	// the material IDs of the structured mesh are row numbers, which are meaningless here
+	if (mesh != nullptr)
+		mesh->getProperties().removePropertyVector("MaterialIDs");
+	return mesh.release();
+}
+
+/// Writes each array as ASCII raster <output>_<array>.asc.
+bool writeAscRasters(ToolsLib::RegularGrid const& grid, std::string const& output_file,
+                     std::vector<std::string> const& prop_names, std::vector<std::vector<double>> const& data)
+{
+	std::string const base_name (BaseLib::dropFileExtension(output_file));
+	for (std::size_t i=0; i<data.size(); ++i)
+	{
+		std::string const file_name (base_name + "_" + prop_names[i] + ".asc");
+		INFO ("Writing %s...", file_name.c_str());
+		if (!ToolsLib::writeAscRaster(grid, data[i], file_name))
+			return false;
+	}
+	return true;
+}
+
+/// Reads the mesh and creates its search structure unless this has been done before.
+int loadMesh(std::string const& file_name, unsigned n_threads,
+             ToolsLib::AggregationSettings const& settings, CachedMesh &cached,
+             ToolsLib::PhaseTimer &timer)
+{
+	std::lock_guard<std::mutex> lock(cached.load_mutex);
+	if (cached.is_loaded)
+		return cached.error;
+	cached.is_loaded = true;
+
+	INFO ("Reading mesh %s.", file_name.c_str());
+	{
+		ToolsLib::ScopedPhase phase(timer, "load_mesh");
+		cached.mesh.reset(readTargetMesh(file_name));
+		phase.addBytesRead(ToolsLib::getFileSize(file_name));
+		phase.addItems(cached.mesh ? cached.mesh->getNElements() : 0);
+	}
+	if (cached.mesh == nullptr)
+	{
+		ERR ("Error reading mesh file.");
+		return cached.error = -2;
+	}
+
+	if (cached.mesh->getDimension() != 2)
+	{
+		ERR ("This utility can handle only 2d meshes at this point.");
+		cached.mesh.reset();
+		return cached.error = -3;
+	}
+	INFO("Mesh read: %d nodes, %d elements.", cached.mesh->getNNodes(), cached.mesh->getNElements());
+
+	// projection and search structure are shared by all data sets
+	ToolsLib::ScopedPhase phase(timer, "project");
+	phase.addItems(cached.mesh->getNElements());
+	cached.context.reset(new ToolsLib::BinningContext(*cached.mesh, n_threads, settings));
+	return 0;
+}
+
+/// Adds the values as cell property of value type T.
+template <typename T>
+bool addCellProperty(MeshLib::Properties &properties, std::string const& name, std::vector<double> const& values)
+{
+	boost::optional< MeshLib::PropertyVector<T>&> prop_vector = properties.createNewPropertyVector<T>(name, MeshLib::MeshItemType::Cell);
+	if (!prop_vector)
+		return false;
+	prop_vector->assign(values.cbegin(), values.cend());
+	return true;
+}
+
+/// Groups the channels by file, channels stored in the same files are read
+/// and binned together.
+std::vector<std::vector<std::size_t>> getChannelGroups(std::vector<EmiChannel> const& channels)
+{
+	std::vector<std::vector<std::size_t>> groups;
+	std::vector<bool> is_done(channels.size(), false);
+	for (std::size_t i=0; i<channels.size(); ++i)
+	{
+		if (is_done[i])
+			continue;
+		groups.emplace_back();
+		for (std::size_t j=i; j<channels.size(); ++j)
+			if (!is_done[j] && channels[j].file_suffix == channels[i].file_suffix)
+			{
+				groups.back().push_back(j);
+				is_done[j] = true;
+			}
+	}
+	return groups;
+}
+
+/**
+ * Adds one cell array per channel and statistic of the job to the properties.
+ * The names of the arrays created are added to prop_names, also if an error
+ * occurs, such that they can be removed again.
+ */
+int addArrays(EmiJob const& job, ToolsLib::AggregationSettings const& settings, OutputSettings const& output,
+              std::vector<std::vector<double>> const& data, MeshLib::Properties &properties,
+              std::vector<std::string> &prop_names)
+{
+	std::size_t const n_stats (settings.statistics.size());
+	for (std::size_t i=0; i<data.size(); ++i)
+	{
+		std::string const prop_name(getArrayName(job.channels[i / n_stats].array_name, settings.statistics[i % n_stats]));
+		bool const is_created (output.float32 ?
+			addCellProperty<float>(properties, prop_name, data[i]) :
+			addCellProperty<double>(properties, prop_name, data[i]));
+		if (!is_created)
+			return -1;
+		prop_names.push_back(prop_name);
+	}
+	return 0;
+}
+
+/**
+ * Bins all data sets of the job and writes the mesh with one array per data
+ * set. The arrays are removed again afterwards such that the cached mesh can
+ * be used by other jobs. A chunk_size other than 0 streams the EMI files.
+ */
+int processJob(EmiJob const& job, CachedMesh &cached, unsigned n_threads, std::size_t chunk_size,
+               ToolsLib::AggregationSettings const& settings, OutputSettings const& output,
+               ToolsLib::PhaseTimer &timer)
+{
+	int const e = loadMesh(job.mesh_file, n_threads, settings, cached, timer);
+	if (e != 0)
+		return e;
+
+	std::size_t const n_stats (settings.statistics.size());
+	std::vector<std::vector<double>> data(job.channels.size() * n_stats);
+	for (std::vector<std::size_t> const& group : getChannelGroups(job.channels))
+	{
+		std::vector<EmiChannel> group_channels;
+		for (std::size_t channel : group)
+			group_channels.push_back(job.channels[channel]);
+		std::vector<std::vector<double>> group_data (
+			addFilesAsArrays(job.csv_base_name, job.regions, group_channels, chunk_size, *cached.context, timer));
+		if (group_data.empty())
+			return -1;
+		for (std::size_t k=0; k<group.size(); ++k)
+			for (std::size_t stat=0; stat<n_stats; ++stat)
+				data[group[k] * n_stats + stat] = std::move(group_data[k * n_stats + stat]);
+	}
+
+	std::lock_guard<std::mutex> lock(cached.write_mutex);
+	MeshLib::Properties &properties (cached.mesh->getProperties());
+	std::vector<std::string> prop_names;
+	int result (addArrays(job, settings, output, data, properties, prop_names));
+	if (result == 0)
+	{
+		INFO ("Writing %s...", job.output_file.c_str());
+		ToolsLib::ScopedPhase phase(timer, "write");
+		if (ToolsLib::writeVtu(*cached.mesh, job.output_file, output.format, n_threads, output.compact_material_ids))
+		{
+			phase.addBytesWritten(ToolsLib::getFileSize(job.output_file));
+			phase.addItems(cached.mesh->getNElements());
+		}
+		else
+		{
+			ERR ("Error writing file %s.", job.output_file.c_str());
+			result = -1;
+		}
+	}
+	if (result == 0 && output.asc)
+	{
+		ToolsLib::ScopedPhase phase(timer, "write");
+		if (cached.context->regular_grid == nullptr)
+			WARN ("Mesh %s is not a regular grid, no raster files are written.", job.mesh_file.c_str());
+		else if (!writeAscRasters(*cached.context->regular_grid, job.output_file, prop_names, data))
+			result = -1;
+	}
+
+	for (std::string const& prop_name : prop_names)
+		properties.removePropertyVector(prop_name);
+	return result;
+}
+
+/**
+ * Reads a manifest with one job per line, given as comma separated mesh file,
+ * csv base name, channels (separated by blanks, empty for the default),
+ * output file and optionally regions (separated by blanks). Empty lines and
+ * lines starting with '#' are skipped, as is the first line if it is the
+ * header "mesh,csv,specifiers,output[,regions]".
+ */
+bool readManifest(std::string const& file_name, std::vector<EmiJob> &jobs)
+{
+	std::array<std::string, 5> const manifest_header = {{ "mesh", "csv", "specifiers", "output", "regions" }};
+	std::ifstream in(file_name.c_str());
+	if (!in.is_open())
+	{
+		ERR ("Could not open manifest %s.", file_name.c_str());
+		return false;
+	}
+
+	std::string line;
+	std::size_t line_count (0);
+	while (std::getline(in, line))
+	{
+		line_count++;
+		if (!line.empty() && line.back() == '\r')
+			line.pop_back();
+		if (line.empty() || line[0] == '#')
+			continue;
+
+		std::vector<std::string> fields;
+		for (std::string field : BaseLib::splitString(line, ','))
+		{
+			BaseLib::trim(field);
+			fields.push_back(field);
+		}
+		if (line_count == 1 && fields.size() >= 4 && fields.size() <= manifest_header.size() &&
+		    std::equal(fields.cbegin(), fields.cend(), manifest_header.cbegin()))
+			continue;
+		if (fields.size() < 4 || fields.size() > 5 || fields[0].empty() || fields[1].empty() || fields[3].empty())
+		{
+			ERR ("Error in line %d of manifest %s.", line_count, file_name.c_str());
+			return false;
+		}
+
+		auto const splitList = [](std::string const& field)
+		{
+			std::vector<std::string> list;
+			for (std::string const& item : BaseLib::splitString(field, ' '))
+				if (!item.empty())
+					list.push_back(item);
+			return list;
+		};
+		EmiJob job;
+		job.mesh_file = fields[0];
+		job.csv_base_name = fields[1];
+		job.output_file = fields[3];
+		if (!setChannels(splitList(fields[2]), (fields.size() == 5) ? splitList(fields[4]) : std::vector<std::string>(), job))
+		{
+			ERR ("Error in line %d of manifest %s.", line_count, file_name.c_str());
+			return false;
+		}
+		jobs.push_back(std::move(job));
+	}
+	return true;
+}
+
+/**
+ * Runs all jobs concurrently on n_jobs threads. Each mesh is read once and
+ * kept until the last job using it has finished.
+ * @return 0 if all jobs succeeded, the error of the first failing job otherwise.
+ */
+int processJobs(std::vector<EmiJob> const& jobs, unsigned n_jobs, unsigned n_threads, std::size_t chunk_size,
+                ToolsLib::AggregationSettings const& settings, OutputSettings const& output,
+                ToolsLib::PhaseTimer &timer)
+{
+	std::map<std::string, CachedMesh> cache;
+	for (EmiJob const& job : jobs)
+		cache[job.mesh_file].n_pending_jobs++;
+
+	std::mutex error_mutex;
+	std::size_t error_job (jobs.size());
+	int error_code (0);
+	{
+		ToolsLib::ThreadPool pool(n_jobs);
+		for (std::size_t i=0; i<jobs.size(); ++i)
+		{
+			CachedMesh* const cached (&cache[jobs[i].mesh_file]);
+			pool.submit([&, i, cached]()
+			{
+				int const result (processJob(jobs[i], *cached, n_threads, chunk_size, settings, output, timer));
+				if (result != 0)
+				{
+					ERR ("Job %d (%s) failed.", i, jobs[i].output_file.c_str());
+					std::lock_guard<std::mutex> lock(error_mutex);
+					if (i < error_job)
+					{
+						error_job = i;
+						error_code = result;
+					}
+				}
 
-	delete flat_mesh;
-	return data;
+				std::unique_lock<std::mutex> write_lock(cached->write_mutex);
+				if (--cached->n_pending_jobs == 0)
+				{
+					write_lock.unlock();
+					std::lock_guard<std::mutex> load_lock(cached->load_mutex);
+					cached->context.reset();
+					cached->mesh.reset();
+				}
+			});
+		}
+	}
+	return error_code;
 }
 
-std::vector<double> addFilesAsArrays(std::string csv_base_name, MeshLib::Mesh *mesh, std::string const& name_specifier)
+#ifdef USE_MPI
+/// Initialises MPI for the lifetime of the object.
+struct MpiSetup
 {
-	std::vector<GeoLib::Point*> points;
-	std::vector<GeoLib::Point*> points2;
-	std::vector<GeoLib::Point*> points3;
+	MpiSetup(int &argc, char** &argv) { MPI_Init(&argc, &argv); }
+	~MpiSetup() { MPI_Finalize(); }
+};
 
-	std::string file_name = csv_base_name + "_A_" + name_specifier + ".txt";
-	INFO ("Reading file %s.", file_name.c_str());
-	int e1 = FileIO::CsvInterface::readPoints(file_name, '\t', points,  1, 2, 3);
-	file_name = csv_base_name + "_B_" + name_specifier + ".txt";
-	INFO ("Reading file %s.", file_name.c_str());
-	int e2 = FileIO::CsvInterface::readPoints(file_name, '\t', points2, 1, 2, 3);
-	file_name = csv_base_name + "_C_" + name_specifier + ".txt";
-	INFO ("Reading file %s.", file_name.c_str());
-	int e3 = FileIO::CsvInterface::readPoints(file_name, '\t', points3, 1, 2, 3);
+/// Returns 0 if the step succeeded on all processes and the (negative) error
+/// of one of the failing processes otherwise, i.e. all processes return the
+/// same value.
+int getGlobalError(int error)
+{
+	int global_error (0);
+	MPI_Allreduce(&error, &global_error, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+	return global_error;
+}
 
-	points.insert(points.end(), points2.begin(), points2.end());
-	points.insert(points.end(), points3.begin(), points3.end());
+/**
+ * Decomposition of the mesh into slabs along the x-axis containing about the
+ * same number of element centers each. An element is owned by the slab
+ * containing its center, a data point belongs to the slab containing it.
+ */
+struct SlabPartition
+{
+	SlabPartition(std::vector<double> centers, std::size_t n_slabs)
+	{
+		if (centers.empty())
+			return;
+		std::sort(centers.begin(), centers.end());
+		for (std::size_t i=1; i<n_slabs; ++i)
+			bounds.push_back(centers[i * centers.size() / n_slabs]);
+	}
 
-	if (e1 < 0 || e2 < 0 || e3 < 0 || points.empty())
+	std::size_t getSlab(double x) const
+	{
+		return std::upper_bound(bounds.cbegin(), bounds.cend(), x) - bounds.cbegin();
+	}
+
+	double getLowerBound(std::size_t slab) const
+	{
+		return (slab == 0) ? std::numeric_limits<double>::lowest() : bounds[slab - 1];
+	}
+
+	double getUpperBound(std::size_t slab) const
+	{
+		return (slab >= bounds.size()) ? std::numeric_limits<double>::max() : bounds[slab];
+	}
+
+	std::vector<double> bounds; ///< upper bounds of all slabs but the last
+};
+
+/**
+ * The part of the mesh owned by this process. The halo context contains the
+ * owned elements and all elements overlapping the slab of the process, such
+ * that every point of the slab can be located and forwarded to the owner of
+ * its element.
+ */
+struct MeshPartition
+{
+	std::unique_ptr<SlabPartition> slabs;
+	std::unique_ptr<MeshLib::Mesh> owned_mesh;
+	std::unique_ptr<ToolsLib::BinningContext> owned;
+	std::unique_ptr<ToolsLib::BinningContext> halo;
+	std::vector<int> halo_owners; ///< process owning each element of the halo
+};
+
+/// Copies the cell property of value type T for the given elements unless
+/// the target has a property of that name already.
+/// @return false if the property is not of value type T.
+template <typename T>
+bool copyCellProperty(MeshLib::Properties const& source, std::string const& name,
+                      std::vector<std::size_t> const& elem_ids, MeshLib::Properties &target)
+{
+	boost::optional<MeshLib::PropertyVector<T> const&> const values (source.getPropertyVector<T>(name));
+	if (!values)
+		return false;
+	if (values->getMeshItemType() != MeshLib::MeshItemType::Cell || target.hasPropertyVector(name))
+		return true;
+	std::size_t const n_components (values->getNumberOfComponents());
+	boost::optional<MeshLib::PropertyVector<T>&> copy (
+		target.createNewPropertyVector<T>(name, MeshLib::MeshItemType::Cell, n_components));
+	if (!copy)
+		return true;
+	copy->reserve(elem_ids.size() * n_components);
+	for (std::size_t id : elem_ids)
+		for (std::size_t c=0; c<n_components; ++c)
+			copy->push_back((*values)[id * n_components + c]);
+	return true;
+}
+
+/**
+ * Reads the mesh, decomposes it into one slab per process and keeps the part
+ * owned by this process (including its cell properties) as well as the
+ * search structures of the owned and the halo elements.
+ */
+int createMeshPartition(std::string const& file_name, unsigned n_threads,
+                        ToolsLib::AggregationSettings const& settings, int rank, int n_ranks,
+                        MeshPartition &partition, ToolsLib::PhaseTimer &timer)
+{
+	INFO ("Reading mesh %s.", file_name.c_str());
+	std::unique_ptr<MeshLib::Mesh> mesh;
+	{
+		ToolsLib::ScopedPhase phase(timer, "load_mesh");
+		mesh.reset(readTargetMesh(file_name));
+		phase.addBytesRead(ToolsLib::getFileSize(file_name));
+		phase.addItems(mesh ? mesh->getNElements() : 0);
+	}
+	int error (0);
+	if (mesh == nullptr)
+	{
+		ERR ("Error reading mesh file.");
+		error = -2;
+	}
+	else if (mesh->getDimension() != 2)
 	{
+		ERR ("This utility can handle only 2d meshes at this point.");
+		error = -3;
+	}
+	error = getGlobalError(error);
+	if (error != 0)
+		return error;
+
+	ToolsLib::ScopedPhase phase(timer, "project");
+	std::vector<MeshLib::Element*> const& elements (mesh->getElements());
+	std::size_t const n_elems (elements.size());
+	std::vector<double> centers(n_elems);
+	std::vector<double> x_min(n_elems, std::numeric_limits<double>::max());
+	std::vector<double> x_max(n_elems, std::numeric_limits<double>::lowest());
+	for (std::size_t i=0; i<n_elems; ++i)
+	{
+		unsigned const n_base_nodes (elements[i]->getNBaseNodes());
+		double sum (0);
+		for (unsigned j=0; j<n_base_nodes; ++j)
+		{
+			double const x ((*elements[i]->getNode(j))[0]);
+			sum += x;
+			x_min[i] = std::min(x_min[i], x);
+			x_max[i] = std::max(x_max[i], x);
+		}
+		centers[i] = sum / n_base_nodes;
+	}
+	partition.slabs.reset(new SlabPartition(centers, n_ranks));
+	double const lower (partition.slabs->getLowerBound(rank));
+	double const upper (partition.slabs->getUpperBound(rank));
+
+	std::vector<std::size_t> owned_ids;
+	std::vector<std::size_t> not_owned_ids;
+	std::vector<std::size_t> not_in_halo_ids;
+	partition.halo_owners.clear();
+	for (std::size_t i=0; i<n_elems; ++i)
+	{
+		int const owner (static_cast<int>(partition.slabs->getSlab(centers[i])));
+		if (owner == rank)
+			owned_ids.push_back(i);
+		else
+			not_owned_ids.push_back(i);
+		if (owner == rank || (x_max[i] >= lower && x_min[i] <= upper))
+			partition.halo_owners.push_back(owner);
+		else
+			not_in_halo_ids.push_back(i);
+	}
+	phase.addItems(owned_ids.size());
+
+	error = 0;
+	if (owned_ids.empty())
+	{
+		ERR ("Process %d does not own any elements, use fewer processes.", rank);
+		error = -4;
+	}
+	error = getGlobalError(error);
+	if (error != 0)
+		return error;
+	INFO ("Process %d owns %d elements, %d elements in its halo.", rank, owned_ids.size(), partition.halo_owners.size());
+
+	// the remaining elements keep their order, removeElements() needs at least one element to remove
+	if (not_in_halo_ids.empty())
+		partition.halo.reset(new ToolsLib::BinningContext(*mesh, n_threads, settings));
+	else
+	{
+		std::unique_ptr<MeshLib::Mesh> const halo_mesh (MeshLib::removeElements(*mesh, not_in_halo_ids, mesh->getName()));
+		partition.halo.reset(new ToolsLib::BinningContext(*halo_mesh, n_threads, settings));
+	}
+
+	if (not_owned_ids.empty())
+	{
+		partition.owned_mesh = std::move(mesh);
+	}
+	else
+	{
+		partition.owned_mesh.reset(MeshLib::removeElements(*mesh, not_owned_ids, mesh->getName()));
+		MeshLib::Properties const& properties (mesh->getProperties());
+		MeshLib::Properties &owned_properties (partition.owned_mesh->getProperties());
+		for (std::string const& name : properties.getPropertyVectorNames())
+		{
+			// all value types supported by the writer
+			bool const is_copied (
+				copyCellProperty<double>(properties, name, owned_ids, owned_properties) ||
+				copyCellProperty<float>(properties, name, owned_ids, owned_properties) ||
+				copyCellProperty<int>(properties, name, owned_ids, owned_properties) ||
+				copyCellProperty<unsigned>(properties, name, owned_ids, owned_properties) ||
+				copyCellProperty<long>(properties, name, owned_ids, owned_properties) ||
+				copyCellProperty<unsigned long>(properties, name, owned_ids, owned_properties) ||
+				copyCellProperty<long long>(properties, name, owned_ids, owned_properties) ||
+				copyCellProperty<unsigned long long>(properties, name, owned_ids, owned_properties) ||
+				copyCellProperty<char>(properties, name, owned_ids, owned_properties) ||
+				copyCellProperty<unsigned char>(properties, name, owned_ids, owned_properties));
+			if (!is_copied)
+				WARN ("createMeshPartition(): Skipping property \"%s\" of unsupported type.", name.c_str());
+		}
+		mesh.reset();
+	}
+	partition.owned.reset(new ToolsLib::BinningContext(*partition.owned_mesh, n_threads, settings));
+	return 0;
+}
+
+/// Data points together with their position in the input files, which
+/// allows restoring the input order after the points have been exchanged.
+struct DistributedPoints
+{
+	explicit DistributedPoints(std::size_t n_channels) : points(n_channels) {}
+
+	ToolsLib::PointSamples points;
+	std::vector<unsigned long long> ids;
+};
+
+/**
+ * Reads the part of this process of the files of all regions. The points are
+ * numbered in the order of the files and lines, independent of the number of
+ * processes.
+ */
+int readDistributedPoints(std::string const& csv_base_name, std::vector<std::string> const& regions,
+                          std::string const& file_suffix, std::vector<std::size_t> const& columns,
+                          int rank, int n_ranks, DistributedPoints &local, ToolsLib::PhaseTimer &timer)
+{
+	ToolsLib::ScopedPhase phase(timer, "parse");
+	unsigned long long n_previous (0);
+	int error (0);
+	for (std::string const& region : regions)
+	{
+		std::string const file_name (csv_base_name + "_" + region + file_suffix + ".txt");
+		INFO ("Reading part %d of file %s.", rank, file_name.c_str());
+		std::size_t const n_before (local.points.size());
+		if (ToolsLib::readPointSamples(file_name, '\t', 1, 2, columns, rank, n_ranks, local.points) < 0)
+			error = -1;
+		else
+			phase.addBytesRead(ToolsLib::getFileSize(file_name) / n_ranks);
+
+		// collective calls are made even after an error to keep all processes in step
+		unsigned long long const n_local (local.points.size() - n_before);
+		unsigned long long offset (0);
+		unsigned long long n_total (0);
+		MPI_Exscan(&n_local, &offset, 1, MPI_UNSIGNED_LONG_LONG, MPI_SUM, MPI_COMM_WORLD);
+		MPI_Allreduce(&n_local, &n_total, 1, MPI_UNSIGNED_LONG_LONG, MPI_SUM, MPI_COMM_WORLD);
+		if (rank == 0)
+			offset = 0;
+		for (unsigned long long k=0; k<n_local; ++k)
+			local.ids.push_back(n_previous + offset + k);
+		n_previous += n_total;
+	}
+	phase.addItems(local.points.size());
+
+	if (error == 0 && n_previous == 0)
+		error = -1;
+	error = getGlobalError(error);
+	if (error != 0)
 		ERR ("Error reading CSV-file.");
-		delete mesh;
-		std::vector<double> no_data;
-		return no_data;
+	return error;
+}
+
+/**
+ * Sends each point to the process given by its destination, points with a
+ * negative destination are dropped. Received points are ordered by source
+ * process. Coordinates and values of a point are sent as one block.
+ */
+DistributedPoints exchangePoints(DistributedPoints const& local, std::vector<int> const& destinations, int n_ranks)
+{
+	std::size_t const n_channels (local.points.n_channels);
+	std::size_t const stride (2 + n_channels);
+	std::vector<int> send_counts(n_ranks, 0);
+	for (int destination : destinations)
+		if (destination >= 0)
+			send_counts[destination]++;
+
+	// MPI counts are limited to int
+	auto const getOffsets = [n_ranks](std::vector<int> const& counts)
+	{
+		std::vector<int> offsets(n_ranks, 0);
+		long long total (0);
+		for (int r=0; r<n_ranks; ++r)
+		{
+			offsets[r] = static_cast<int>(total);
+			total += counts[r];
+		}
+		return std::make_pair(offsets, total);
+	};
+	auto const checkSize = [stride](long long n_points)
+	{
+		if (n_points * static_cast<long long>(stride) > std::numeric_limits<int>::max())
+		{
+			ERR ("Too many points per process for the exchange, use more processes.");
+			MPI_Abort(MPI_COMM_WORLD, -5);
+		}
+	};
+	std::pair<std::vector<int>, long long> send (getOffsets(send_counts));
+	checkSize(send.second);
+
+	std::vector<unsigned long long> send_ids(send.second);
+	std::vector<double> send_values(send.second * stride);
+	std::vector<int> pos (send.first);
+	for (std::size_t i=0; i<destinations.size(); ++i)
+	{
+		if (destinations[i] < 0)
+			continue;
+		std::size_t const k (pos[destinations[i]]++);
+		send_ids[k] = local.ids[i];
+		double* const values (&send_values[k * stride]);
+		values[0] = local.points.x[i];
+		values[1] = local.points.y[i];
+		for (std::size_t c=0; c<n_channels; ++c)
+			values[2 + c] = local.points.getValue(i, c);
 	}
 
-	std::vector<double> data = getDataFromCSV(*mesh, points);
-	std::for_each(points.begin(), points.end(), std::default_delete<GeoLib::Point>());
+	std::vector<int> recv_counts(n_ranks, 0);
+	MPI_Alltoall(send_counts.data(), 1, MPI_INT, recv_counts.data(), 1, MPI_INT, MPI_COMM_WORLD);
+	std::pair<std::vector<int>, long long> recv (getOffsets(recv_counts));
+	checkSize(recv.second);
+
+	DistributedPoints received(n_channels);
+	received.ids.resize(recv.second);
+	MPI_Alltoallv(send_ids.data(), send_counts.data(), send.first.data(), MPI_UNSIGNED_LONG_LONG,
+	              received.ids.data(), recv_counts.data(), recv.first.data(), MPI_UNSIGNED_LONG_LONG,
+	              MPI_COMM_WORLD);
+
+	auto const scale = [stride](std::vector<int> values)
+	{
+		for (int &value : values)
+			value *= static_cast<int>(stride);
+		return values;
+	};
+	std::vector<int> send_value_counts (scale(send_counts));
+	std::vector<int> send_value_offsets (scale(send.first));
+	std::vector<int> recv_value_counts (scale(recv_counts));
+	std::vector<int> recv_value_offsets (scale(recv.first));
+	std::vector<double> recv_values(recv.second * stride);
+	MPI_Alltoallv(send_values.data(), send_value_counts.data(), send_value_offsets.data(), MPI_DOUBLE,
+	              recv_values.data(), recv_value_counts.data(), recv_value_offsets.data(), MPI_DOUBLE,
+	              MPI_COMM_WORLD);
 
-	return data;
+	received.points.reserve(recv.second);
+	for (long long k=0; k<recv.second; ++k)
+	{
+		double const* const values (&recv_values[k * stride]);
+		received.points.push_back(values[0], values[1], values + 2);
+	}
+	return received;
+}
+
+/// Restores the input order of the points, such that binning gives the same
+/// results as with a single process.
+void sortPoints(DistributedPoints &dp)
+{
+	std::size_t const n_points (dp.points.size());
+	std::vector<std::size_t> order(n_points);
+	for (std::size_t i=0; i<n_points; ++i)
+		order[i] = i;
+	std::sort(order.begin(), order.end(),
+		[&dp](std::size_t a, std::size_t b) { return dp.ids[a] < dp.ids[b]; });
+
+	DistributedPoints sorted(dp.points.n_channels);
+	sorted.points.reserve(n_points);
+	sorted.ids.reserve(n_points);
+	for (std::size_t i : order)
+	{
+		sorted.points.push_back(dp.points.x[i], dp.points.y[i], &dp.points.values[i * dp.points.n_channels]);
+		sorted.ids.push_back(dp.ids[i]);
+	}
+	dp = std::move(sorted);
 }
 
+/**
+ * Distributed version of processJob(). Every process reads a part of the EMI
+ * files and sends the points to the process owning their slab, which locates
+ * them and forwards points within elements owned by another process. Each
+ * process bins the points of its own elements in input order, hence the
+ * results are the same as with a single process. Each process writes its
+ * part of the mesh as <output>_<rank>.vtu, the first process writes
+ * <output>.pvtu referencing all parts.
+ */
+int processJobDistributed(EmiJob const& job, unsigned n_threads,
+                          ToolsLib::AggregationSettings const& settings, OutputSettings const& output,
+                          int rank, int n_ranks, ToolsLib::PhaseTimer &timer)
+{
+	MeshPartition partition;
+	int const e (createMeshPartition(job.mesh_file, n_threads, settings, rank, n_ranks, partition, timer));
+	if (e != 0)
+		return e;
+
+	std::size_t const n_stats (settings.statistics.size());
+	std::vector<std::vector<double>> data(job.channels.size() * n_stats);
+	for (std::vector<std::size_t> const& group : getChannelGroups(job.channels))
+	{
+		std::vector<std::size_t> columns;
+		for (std::size_t channel : group)
+			columns.push_back(job.channels[channel].column);
+		DistributedPoints local(columns.size());
+		int const read_error (readDistributedPoints(job.csv_base_name, job.regions,
+			job.channels[group[0]].file_suffix, columns, rank, n_ranks, local, timer));
+		if (read_error != 0)
+			return read_error;
+
+		DistributedPoints owned_points(columns.size());
+		{
+			ToolsLib::ScopedPhase phase(timer, "exchange");
+			std::vector<int> destinations(local.points.size());
+			for (std::size_t i=0; i<destinations.size(); ++i)
+				destinations[i] = static_cast<int>(partition.slabs->getSlab(local.points.x[i]));
+			DistributedPoints slab_points (exchangePoints(local, destinations, n_ranks));
+			local = DistributedPoints(columns.size());
+
+			// points outside of the mesh are dropped
+			std::size_t const n_slab_points (slab_points.points.size());
+			std::vector<std::size_t> elem_ids(n_slab_points);
+			destinations.resize(n_slab_points);
+			ToolsLib::parallelFor(n_slab_points, n_threads,
+				[&](std::size_t begin, std::size_t end, unsigned)
+				{
+					partition.halo->findElements(end - begin, slab_points.points.x.data() + begin,
+						slab_points.points.y.data() + begin, elem_ids.data() + begin);
+					for (std::size_t i=begin; i<end; ++i)
+						destinations[i] = (elem_ids[i] == ToolsLib::ElementGrid::not_found) ?
+							-1 : partition.halo_owners[elem_ids[i]];
+				});
+			owned_points = exchangePoints(slab_points, destinations, n_ranks);
+			phase.addItems(slab_points.points.size());
+		}
+
+		ToolsLib::ScopedPhase phase(timer, "bin");
+		phase.addItems(owned_points.points.size());
+		sortPoints(owned_points);
+		std::vector<std::vector<double>> group_data (ToolsLib::binPoints(*partition.owned, owned_points.points));
+		for (std::size_t k=0; k<group.size(); ++k)
+			for (std::size_t stat=0; stat<n_stats; ++stat)
+				data[group[k] * n_stats + stat] = std::move(group_data[k * n_stats + stat]);
+	}
+
+	std::vector<std::string> prop_names;
+	int error (addArrays(job, settings, output, data, partition.owned_mesh->getProperties(), prop_names));
+	data.clear();
+
+	// pieces use the appended formats, which are combined in the pvtu file
+	std::string const base_name (BaseLib::dropFileExtension(job.output_file));
+	std::string const piece_file (base_name + "_" + std::to_string(rank) + ".vtu");
+	ToolsLib::VtuFormat const format ((output.format == ToolsLib::VtuFormat::Zlib) ?
+		ToolsLib::VtuFormat::Zlib : ToolsLib::VtuFormat::Raw);
+	if (error == 0)
+	{
+		INFO ("Writing %s...", piece_file.c_str());
+		ToolsLib::ScopedPhase phase(timer, "write");
+		if (!ToolsLib::writeVtu(*partition.owned_mesh, piece_file, format, n_threads))
+			error = -1;
+		phase.addBytesWritten(ToolsLib::getFileSize(piece_file));
+		phase.addItems(partition.owned_mesh->getNElements());
+	}
+	error = getGlobalError(error);
+	if (error != 0)
+		return error;
+
+	// the result of the first process is shared, i.e. all processes continue
+	// with the next job or stop together
+	if (rank == 0)
+	{
+		std::vector<std::string> pieces;
+		for (int r=0; r<n_ranks; ++r)
+			pieces.push_back(BaseLib::extractBaseName(base_name + "_" + std::to_string(r) + ".vtu"));
+		std::string const pvtu_file (base_name + ".pvtu");
+		INFO ("Writing %s...", pvtu_file.c_str());
+		if (!ToolsLib::writePvtu(*partition.owned_mesh, pvtu_file, pieces))
+		{
+			ERR ("Error writing file %s.", pvtu_file.c_str());
+			error = -1;
+		}
+	}
+	return getGlobalError(error);
+}
+
+/**
+ * Runs the jobs one after another, each distributed over all processes.
+ * @return 0 if all jobs succeeded, the error of the first failing job otherwise.
+ */
+int processJobsDistributed(std::vector<EmiJob> const& jobs, unsigned n_threads,
+                           ToolsLib::AggregationSettings const& settings, OutputSettings const& output,
+                           ToolsLib::PhaseTimer &timer)
+{
+	int rank (0);
+	int n_ranks (1);
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+	MPI_Comm_size(MPI_COMM_WORLD, &n_ranks);
+	for (std::size_t i=0; i<jobs.size(); ++i)
+	{
+		int const result (processJobDistributed(jobs[i], n_threads, settings, output, rank, n_ranks, timer));
+		if (result != 0)
+		{
+			ERR ("Job %d (%s) failed.", i, jobs[i].output_file.c_str());
+			return result;
+		}
+	}
+	return 0;
+}
+#endif
 
 int main (int argc, char* argv[])
 {
+#ifdef USE_MPI
+	MpiSetup mpi_setup(argc, argv);
+#endif
 	LOGOG_INITIALIZE();
 	logog::Cout* logog_cout (new logog::Cout);
 	BaseLib::LogogSimpleFormatter *custom_format (new BaseLib::LogogSimpleFormatter);
 	logog_cout->SetFormatter(*custom_format);
+	ToolsLib::PhaseTimer timer;
 
 	TCLAP::CmdLine cmd("Add EMI data as a scalar cell array to a 2d mesh.", ' ', "0.1");
 
 	// I/O params
 	TCLAP::ValueArg<std::string> mesh_out("o", "mesh-output-file",
-	                                      "the name of the file the mesh will be written to", true,
+	                                      "the name of the file the mesh will be written to; MPI builds write one piece <name>_<rank>.vtu per process and <name>.pvtu", false,
 	                                      "", "file name of output mesh");
 	cmd.add(mesh_out);
 	TCLAP::ValueArg<std::string> mesh_in("i", "mesh-input-file",
-	                                     "the name of the file containing the input mesh", true,
+	                                     "the name of the file containing the input mesh, either a 2d mesh (*.vtu) or a raster (*.asc, *.grd) whose pixels become the cells", false,
 	                                     "", "file name of input mesh");
 	cmd.add(mesh_in);
 
 	TCLAP::ValueArg<std::string> csv_in("", "csv",
 	                                    "csv-file containing EMI data to be added as a scalar array.",
-	                                    true, "", "name of the csv input file");
+	                                    false, "", "name of the csv input file");
 	cmd.add(csv_in);
+	TCLAP::MultiArg<std::string> specifier_arg("s", "specifier",
+	                                           "Name specifier of the EMI data set, column 3 of the files called <csv>_<region>_<specifier>.txt is added as array TM_DD_<specifier>. Data sets given as <name>:<column> are read from that column of the files <csv>_<region>.txt and added as array <name>; all data sets of a file are read and binned in one pass. Can be given multiple times, default is \'H\' and \'V\'.",
+	                                           false, "specifier of EMI data set");
+	cmd.add(specifier_arg);
+	TCLAP::MultiArg<std::string> region_arg("r", "region",
+	                                        "Region of the survey, the data of all regions is combined. Can be given multiple times, default is \'A\', \'B\' and \'C\'.",
+	                                        false, "region specifier");
+	cmd.add(region_arg);
+	TCLAP::ValueArg<unsigned> threads_arg("p", "threads",
+	                                      "Number of threads used for binning and compressing the data, 0 uses all available cores.",
+	                                      false, 1, "number of threads");
+	cmd.add(threads_arg);
+	std::vector<std::string> vtu_formats (ToolsLib::getVtuFormatNames());
+	TCLAP::ValuesConstraint<std::string> vtu_format_values(vtu_formats);
+	TCLAP::ValueArg<std::string> vtu_format_arg("", "vtu-format",
+	                                            "Format of the output file: 'binary' uses VTK's writer, 'raw' writes uncompressed and 'zlib' compressed appended binary data. MPI builds write 'binary' as 'raw'.",
+	                                            false, "binary", &vtu_format_values);
+	cmd.add(vtu_format_arg);
+	TCLAP::SwitchArg float32_arg("", "float32",
+	                             "Store and write the binned arrays as 32 bit floats.");
+	cmd.add(float32_arg);
+	TCLAP::SwitchArg compact_ids_arg("", "compact-material-ids",
+	                                 "Write integer MaterialIDs within [0, 255] as 8 bit integers (except for \'binary\' output and MPI builds).");
+	cmd.add(compact_ids_arg);
+	TCLAP::SwitchArg asc_arg("", "asc",
+	                         "Also write each array as ASCII raster <output>_<array>.asc if the mesh is a regular grid with square cells (e.g. created from a raster). Not supported in MPI builds.");
+	cmd.add(asc_arg);
+	TCLAP::ValueArg<std::string> batch_arg("b", "batch",
+	                                       "Manifest file listing one job per line as \'mesh,csv,specifiers,output[,regions]\' with blank separated specifiers and regions. Jobs are processed within one process, meshes and their search structures are read only once. Replaces -i, -o, --csv, -s and -r.",
+	                                       false, "", "name of the manifest file");
+	cmd.add(batch_arg);
+	TCLAP::ValueArg<unsigned> jobs_arg("j", "jobs",
+	                                   "Number of jobs of a batch processed concurrently, each using the given number of threads. Jobs are processed one after another in MPI builds.",
+	                                   false, 1, "number of jobs");
+	cmd.add(jobs_arg);
+	std::vector<std::string> statistic_names (ToolsLib::getStatisticNames());
+	TCLAP::ValuesConstraint<std::string> statistic_values(statistic_names);
+	TCLAP::MultiArg<std::string> statistic_arg("", "statistic",
+	                                           "Statistic of the values within each cell written for each data set. The mean is added as the array of the data set, any other statistic as <array>_<statistic>. All statistics are computed in one pass. Can be given multiple times, default is \'mean\'. Cells without data are set to NaN (0 for \'count\').",
+	                                           false, &statistic_values);
+	cmd.add(statistic_arg);
+	TCLAP::ValueArg<double> trim_arg("", "trim",
+	                                 "Fraction of the values dropped at each end for the trimmed mean, within [0, 0.5).",
+	                                 false, 0.1, "fraction");
+	cmd.add(trim_arg);
+	TCLAP::ValueArg<double> idw_power_arg("", "idw-power",
+	                                      "Exponent of the inverse distance weights (distance of the data point to the cell center).",
+	                                      false, 2.0, "exponent");
+	cmd.add(idw_power_arg);
+	TCLAP::ValueArg<std::size_t> sample_size_arg("", "sample-size",
+	                                             "Maximum number of values per cell kept for median and trimmed mean, the result is exact for cells with fewer values.",
+	                                             false, 1024, "number of values");
+	cmd.add(sample_size_arg);
+	TCLAP::ValueArg<std::size_t> chunk_size_arg("", "chunk-size",
+	                                            "Stream the EMI files in chunks of the given number of points instead of reading all points at once. Each chunk is binned into running statistics while the next one is read, such that memory depends on the size of the mesh rather than the number of points. Results are the same as without streaming. 0 reads the complete files.",
+	                                            false, 0, "number of points");
+	cmd.add(chunk_size_arg);
+	TCLAP::ValueArg<std::string> profile_arg("", "profile",
+	                                         "Write wall time, peak memory, I/O volume and throughput of the phases load_mesh, project, parse, bin and write (and exchange in MPI builds) to the given JSON file at the end of a successful run. Times of concurrent jobs are summed up. In MPI builds each process writes its own profile <file>_<rank>.json.",
+	                                         false, "", "file name of profile");
+	cmd.add(profile_arg);
 	cmd.parse(argc, argv);
+	unsigned const n_threads (ToolsLib::getNumberOfThreads(threads_arg.getValue()));
+	OutputSettings const output { ToolsLib::getVtuFormat(vtu_format_arg.getValue()), float32_arg.getValue(),
+		compact_ids_arg.getValue(), asc_arg.getValue() };
 
-	INFO ("Reading mesh %s.", mesh_in.getValue().c_str());
-	MeshLib::Mesh* mesh (MeshLib::IO::VtuInterface::readVTUFile(mesh_in.getValue()));
-	if (mesh == nullptr)
+	ToolsLib::AggregationSettings settings;
+	if (!statistic_arg.getValue().empty())
 	{
-		ERR ("Error reading mesh file.");
-		return -2;
+		settings.statistics.clear();
+		for (std::string const& name : statistic_arg.getValue())
+		{
+			ToolsLib::Statistic statistic;
+			ToolsLib::parseStatistic(name, statistic);
+			if (std::find(settings.statistics.cbegin(), settings.statistics.cend(), statistic) == settings.statistics.cend())
+				settings.statistics.push_back(statistic);
+		}
 	}
-
-	if (mesh->getDimension() != 2)
+	if (!(trim_arg.getValue() >= 0 && trim_arg.getValue() < 0.5))
 	{
-		ERR ("This utility can handle only 2d meshes at this point.");
-		delete mesh;
-		return -3;
+		ERR ("The trimmed fraction has to be within [0, 0.5).");
+		return -1;
 	}
-	INFO("Mesh read: %d nodes, %d elements.", mesh->getNNodes(), mesh->getNElements());
+	settings.trim_fraction = trim_arg.getValue();
+	settings.idw_power = idw_power_arg.getValue();
+	settings.sample_size = std::max<std::size_t>(sample_size_arg.getValue(), 1);
 
-	/*
-	std::vector<GeoLib::Point*> points;
-	int e = FileIO::CsvInterface::readPoints(csv_in.getValue(), '\t', points);
-	if (e < 0 || points.empty())
+	std::vector<EmiJob> jobs;
+	if (batch_arg.isSet())
 	{
-		ERR ("Error reading CSV-file.");
-		delete mesh;
-		return 0;
+		if (!readManifest(batch_arg.getValue(), jobs))
+			return -1;
+	}
+	else
+	{
+		if (!mesh_in.isSet() || !mesh_out.isSet() || !csv_in.isSet())
+		{
+			ERR ("Input mesh, output mesh and csv-file are required unless a batch manifest is given.");
+			return -1;
+		}
+		EmiJob job;
+		job.mesh_file = mesh_in.getValue();
+		job.csv_base_name = csv_in.getValue();
+		job.output_file = mesh_out.getValue();
+		if (!setChannels(specifier_arg.getValue(), region_arg.getValue(), job))
+			return -1;
+		jobs.push_back(std::move(job));
 	}
-	data = getDataFromCSV(*mesh, points);
-	std::for_each(points.begin(), points.end(), std::default_delete<MathLib::Point3d>());
-	*/
 
-	std::vector<double> data = addFilesAsArrays(csv_in.getValue(), mesh, "H");
-	if (data.empty())
-		return -1;
-	std::string const h_prop_name("TM_DD_H");
-	boost::optional< MeshLib::PropertyVector<double>&> h_vector = mesh->getProperties().createNewPropertyVector<double>(h_prop_name, MeshLib::MeshItemType::Cell);
-	std::copy(data.cbegin(), data.cend(), std::back_inserter(*h_vector));
+#ifdef USE_MPI
+	// each process owns a slab of every mesh, streaming is not needed then
+	if (chunk_size_arg.getValue() > 0)
+		WARN ("Chunked reading is not supported in MPI builds, each process reads its part of the files at once.");
+	if (output.asc)
+		WARN ("Raster output is not supported in MPI builds.");
+	int const result (processJobsDistributed(jobs, n_threads, settings, output, timer));
+	if (result != 0)
+		return result;
 
-	data = addFilesAsArrays(csv_in.getValue(), mesh, "V");
-	if (data.empty())
-		return -1;
-	std::string const v_prop_name("TM_DD_V");
-	boost::optional< MeshLib::PropertyVector<double>&> v_vector = mesh->getProperties().createNewPropertyVector<double>(v_prop_name, MeshLib::MeshItemType::Cell);
-	std::copy(data.cbegin(), data.cend(), std::back_inserter(*v_vector));
+	int rank (0);
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+	if (profile_arg.isSet())
+		ToolsLib::writeProfile(BaseLib::dropFileExtension(profile_arg.getValue()) + "_" + std::to_string(rank) + ".json",
+		                       "addEmiDataToMesh", timer);
+#else
+	int const result (processJobs(jobs, std::max(jobs_arg.getValue(), 1u), n_threads, chunk_size_arg.getValue(),
+	                               settings, output, timer));
+	if (result != 0)
+		return result;
 
-	INFO ("Writing result...");
-	MeshLib::IO::VtuInterface vtu(mesh);
-	vtu.writeToFile(mesh_out.getValue());
+	if (profile_arg.isSet())
+		ToolsLib::writeProfile(profile_arg.getValue(), "addEmiDataToMesh", timer);
+#endif
 
-	delete mesh;
 	delete custom_format;
 	delete logog_cout;
 	LOGOG_SHUTDOWN();
@@ -11,8 +11,16 @@
  *              http://www.opengeosys.org/LICENSE.txt
  */
 
-#include <vector>
 #include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
 
 // TCLAP
 #include "tclap/CmdLine.h"
@@ -39,9 +47,16 @@
 #include "MeshLib/Properties.h"
 #include "MeshLib/PropertyVector.h"
 #include "MeshLib/Elements/Element.h"
-#include "MeshLib/Elements/Quad.h"
 
-MeshLib::Mesh*  createMesh()
+#include "ToolsLib/BoundedQueue.h"
+#include "ToolsLib/ParallelFor.h"
+#include "ToolsLib/PhaseTimer.h"
+#include "ToolsLib/StructuredGrid.h"
+#include "ToolsLib/TimeStepReader.h"
+#include "ToolsLib/VtuWriter.h"
+#include "ToolsLib/XdmfTimeSeries.h"
+
+std::unique_ptr<ToolsLib::StructuredGrid> createGrid()
 {
 	std::string const x_file ("utm_x.csv");
 	std::string const y_file ("utm_y.csv");
@@ -61,36 +76,15 @@ MeshLib::Mesh*  createMesh()
 
 	std::size_t const n_cols (x.size());
 	std::size_t const n_rows (z.size());
-	std::vector<MeshLib::Node*> nodes;
-	nodes.reserve(n_rows*n_cols);
-	for (std::size_t r=0; r<n_rows; ++r)
-		for (std::size_t c=0; c<n_cols; ++c)
-			nodes.push_back(new MeshLib::Node(x[c], y[c], z[r], nodes.size()));
-
-	std::vector<MeshLib::Element*> elems;
-	elems.reserve((n_rows-1)*(n_cols-1));
-	std::vector<std::size_t> mats;
-	mats.reserve((n_rows-1)*(n_cols-1));
-	for (std::size_t r=0; r<n_rows-2; ++r)
-	{
-		std::size_t base_idx = r*n_cols;
-		for (std::size_t c=0; c<n_cols-1; ++c)
-		{
-			std::array<MeshLib::Node*, 4> quad_nodes;
-			quad_nodes[0] = nodes[base_idx + c];
-			quad_nodes[1] = nodes[base_idx + c + n_cols];
-			quad_nodes[2] = nodes[base_idx + c + n_cols + 1];
-			quad_nodes[3] = nodes[base_idx + c + 1];
-			elems.push_back(new MeshLib::Quad(quad_nodes));
-			mats.push_back(r);
-		}
-	}
-
-	MeshLib::Mesh* mesh = new MeshLib::Mesh("Mesh", nodes, elems);
-	boost::optional<std::vector<int>&> mat_prop (mesh->getProperties().createNewPropertyVector<int>("MaterialIDs", MeshLib::MeshItemType::Cell));
-	mat_prop->insert(mat_prop->end(), mats.begin(), mats.end());
+	return ToolsLib::StructuredGrid::create(n_rows, n_cols, std::move(x), std::move(y), std::move(z));
+}
 
-	return mesh;
+MeshLib::Mesh*  createMesh()
+{
+	std::unique_ptr<ToolsLib::StructuredGrid> const grid (createGrid());
+	if (grid == nullptr)
+		return nullptr;
+	return grid->toMesh("Mesh").release();
 }
 
 std::string number2str(std::size_t n)
@@ -108,6 +102,146 @@ std::string output_question(std::string const& output_name)
 	return input;
 }
 
+/// Adds the cell array for the time step values to the mesh, stored as float
+/// if single precision output is requested.
+bool addTimeStepProperty(MeshLib::Mesh &mesh, std::string const& prop_name, bool float32)
+{
+	if (float32)
+		return static_cast<bool>(mesh.getProperties().createNewPropertyVector<float>(prop_name, MeshLib::MeshItemType::Cell));
+	return static_cast<bool>(mesh.getProperties().createNewPropertyVector<double>(prop_name, MeshLib::MeshItemType::Cell));
+}
+
+/**
+ * Fills the time step array of the mesh with the values of the given time
+ * step and writes the mesh to the output file. Values are always parsed in
+ * double precision, float arrays are converted afterwards.
+ * @return 0 on success, the error code of the tool otherwise.
+ */
+int writeTimeStep(ToolsLib::TimeStep const& step, MeshLib::Mesh &mesh, std::string const& prop_name,
+                  int n_rows, double nan_value, std::string const& output_name,
+                  ToolsLib::VtuFormat format, unsigned n_writer_threads, bool float32,
+                  bool compact_material_ids, ToolsLib::PhaseTimer &timer)
+{
+	int const n_values_per_row (mesh.getNElements() / n_rows);
+	if (float32)
+	{
+		std::vector<double> values (mesh.getNNodes(), 0);
+		int const result (ToolsLib::parseTimeStep(step, n_rows, n_values_per_row, nan_value, values, timer));
+		if (result != 0)
+			return result;
+		boost::optional<MeshLib::PropertyVector<float>&> prop (mesh.getProperties().getPropertyVector<float>(prop_name));
+		prop->assign(values.cbegin(), values.cend());
+	}
+	else
+	{
+		boost::optional<MeshLib::PropertyVector<double>&> prop (mesh.getProperties().getPropertyVector<double>(prop_name));
+		prop->assign(mesh.getNNodes(), 0);
+		int const result (ToolsLib::parseTimeStep(step, n_rows, n_values_per_row, nan_value, *prop, timer));
+		if (result != 0)
+			return result;
+	}
+
+	INFO ("Writing result #%d...", step.index);
+	ToolsLib::ScopedPhase phase(timer, "write");
+	if (!ToolsLib::writeVtu(mesh, output_name, format, n_writer_threads, compact_material_ids))
+	{
+		ERR ("Error writing file %s.", output_name.c_str());
+		return -8;
+	}
+	phase.addBytesWritten(ToolsLib::getFileSize(output_name));
+	phase.addItems(mesh.getNElements());
+	return 0;
+}
+
+/**
+ * Adds the values of the given time step to the XDMF time series.
+ * @return 0 on success, the error code of the tool otherwise.
+ */
+int writeTimeStep(ToolsLib::TimeStep const& step, MeshLib::Mesh const& mesh, int n_rows, double nan_value,
+                  ToolsLib::XdmfTimeSeries &series, bool float32, ToolsLib::PhaseTimer &timer)
+{
+	std::vector<double> values (mesh.getNNodes(), 0);
+	int const n_values_per_row (mesh.getNElements() / n_rows);
+	int const result (ToolsLib::parseTimeStep(step, n_rows, n_values_per_row, nan_value, values, timer));
+	if (result != 0)
+		return result;
+
+	INFO ("Writing time step #%d...", step.index);
+	ToolsLib::ScopedPhase phase(timer, "write");
+	if (!series.writeTimeStep(step.index, values.data()))
+		return -8;
+	phase.addBytesWritten(mesh.getNElements() * (float32 ? sizeof(float) : sizeof(double)));
+	phase.addItems(mesh.getNElements());
+	return 0;
+}
+
+/**
+ * Adds the values of the given time step as a new array to the existing
+ * output file without reading the mesh.
+ * @return 0 on success, 1 if the file needs to be rewritten and the error
+ * code of the tool otherwise, including if the array already exists.
+ */
+int appendTimeStep(ToolsLib::TimeStep const& step, std::size_t n_nodes, std::size_t n_cells,
+                   std::string const& prop_name, int n_rows, double nan_value,
+                   std::string const& output_name, unsigned n_writer_threads, bool float32,
+                   ToolsLib::PhaseTimer &timer)
+{
+	std::vector<double> values (n_nodes, 0);
+	int const n_values_per_row (n_cells / n_rows);
+	int const result (ToolsLib::parseTimeStep(step, n_rows, n_values_per_row, nan_value, values, timer));
+	if (result != 0)
+		return result;
+
+	INFO ("Adding array to result #%d...", step.index);
+	ToolsLib::ScopedPhase phase(timer, "write");
+	std::size_t const file_size (ToolsLib::getFileSize(output_name));
+	ToolsLib::AppendStatus const status (float32 ?
+		ToolsLib::appendCellArray(output_name, prop_name, std::vector<float>(values.cbegin(), values.cend()).data(),
+		                          n_cells, n_writer_threads) :
+		ToolsLib::appendCellArray(output_name, prop_name, values.data(), n_cells, n_writer_threads));
+	if (status == ToolsLib::AppendStatus::ArrayExists)
+	{
+		ERR ("Array \"%s\" already exists in %s.", prop_name.c_str(), output_name.c_str());
+		return -6;
+	}
+	if (status == ToolsLib::AppendStatus::Appended)
+	{
+		// only the growth of the file is counted, the array is appended in place
+		std::size_t const new_size (ToolsLib::getFileSize(output_name));
+		phase.addBytesWritten(new_size > file_size ? new_size - file_size : 0);
+		phase.addItems(n_cells);
+		return 0;
+	}
+	INFO ("Could not add array in place, rewriting %s.", output_name.c_str());
+	return 1;
+}
+
+/// Returns the largest material ID plus one if the mesh has MaterialIDs of
+/// value type T and 0 otherwise.
+template <typename T>
+int getNumberOfMaterials(MeshLib::Mesh const& mesh)
+{
+	boost::optional<MeshLib::PropertyVector<T> const&> materials (mesh.getProperties().getPropertyVector<T>("MaterialIDs"));
+	if (!materials || materials->empty())
+		return 0;
+	return static_cast<int>(*std::max_element(materials->cbegin(), materials->cend())) + 1;
+}
+
+/// Returns the number of grid rows, i.e. the number of material groups of the
+/// mesh. MaterialIDs are either int or, if written compactly, unsigned char.
+int getNumberOfRows(MeshLib::Mesh const& mesh)
+{
+	int n_rows (getNumberOfMaterials<int>(mesh));
+	if (n_rows == 0)
+		n_rows = getNumberOfMaterials<unsigned char>(mesh);
+	if (n_rows == 0)
+	{
+		ERR ("Mesh contains no material IDs.");
+		return -1;
+	}
+	return n_rows;
+}
+
 bool overwriteFiles(std::string const& output_name)
 {
 	if (!BaseLib::IsFileExisting(output_name))
@@ -128,6 +262,7 @@ int main (int argc, char* argv[])
 	logog::Cout* logog_cout (new logog::Cout);
 	BaseLib::LogogSimpleFormatter *custom_format (new BaseLib::LogogSimpleFormatter);
 	logog_cout->SetFormatter(*custom_format);
+	ToolsLib::PhaseTimer timer;
 
 	TCLAP::CmdLine cmd("Adds a scalar array time series from a csv-file to an existing mesh or a time series of meshes.", ' ', "0.1");
 
@@ -137,13 +272,42 @@ int main (int argc, char* argv[])
 	                                       false, "", "base mesh input");
 	cmd.add(mesh_new);
 	TCLAP::ValueArg<std::string> mesh_add("t", "output",
-	                                      "This is the base name of the output files, e.g. \'output\' will result in files called \'output0.vtu\', \'output1.vtu\', etc. If a time series is already existing, a new array will simply be added to each time step.",
+	                                      "This is the base name of the output files, e.g. \'output\' will result in files called \'output0.vtu\', \'output1.vtu\', etc. If a time series is already existing, a new array will simply be added to each time step. Files written with \'--vtu-format raw\' or \'zlib\' are extended in place without reading the meshes, other files are read and rewritten.",
 	                                       true, "", "name of mesh output");
 	cmd.add(mesh_add);
 	TCLAP::ValueArg<std::string> csv_in("i", "csv",
 	                                    "CSV-file containing the input information for the scalar arrays. It is assumed that all timesteps are in one file with an empty line between timesteps and with one value per grid cell per time step.",
 	                                    true, "", "csv input file");
 	cmd.add(csv_in);
+	TCLAP::SwitchArg mmap_arg("m", "mmap",
+	                          "Memory-map the csv-file instead of reading it line by line. Recommended for very large files.");
+	cmd.add(mmap_arg);
+	TCLAP::SwitchArg force_arg("f", "force",
+	                           "Overwrite existing output files without asking.");
+	cmd.add(force_arg);
+	TCLAP::ValueArg<unsigned> threads_arg("p", "threads",
+	                                      "Number of time steps that are processed and written in parallel.",
+	                                      false, 1, "number of threads");
+	cmd.add(threads_arg);
+	std::vector<std::string> vtu_formats (ToolsLib::getVtuFormatNames());
+	TCLAP::ValuesConstraint<std::string> vtu_format_values(vtu_formats);
+	TCLAP::ValueArg<std::string> vtu_format_arg("", "vtu-format",
+	                                            "Format of the output files: 'binary' uses VTK's writer, 'raw' writes uncompressed and 'zlib' compressed appended binary data. Compression uses the cores not occupied by parallel time steps.",
+	                                            false, "binary", &vtu_format_values);
+	cmd.add(vtu_format_arg);
+	TCLAP::SwitchArg xdmf_arg("x", "xdmf",
+	                          "Write the time series as '<output>.xdmf' instead of one vtu-file per time step. Geometry and existing arrays are written only once, the values of all time steps are stored in a single binary file. Requires a base mesh.");
+	cmd.add(xdmf_arg);
+	TCLAP::SwitchArg float32_arg("", "float32",
+	                             "Store the time series values in single precision, halving the size of the output.");
+	cmd.add(float32_arg);
+	TCLAP::SwitchArg compact_ids_arg("", "compact-material-ids",
+	                                 "Write MaterialIDs as UInt8 if their range allows it (raw and zlib vtu-files only).");
+	cmd.add(compact_ids_arg);
+	TCLAP::ValueArg<std::string> profile_arg("", "profile",
+	                                         "Write wall time, peak memory, I/O volume and throughput of the phases load_mesh, parse and write to the given JSON file at the end of a successful run. Times of parallel time steps are summed up.",
+	                                         false, "", "file name of profile");
+	cmd.add(profile_arg);
 	cmd.parse(argc, argv);
 
 	//MeshLib::Mesh* mesh = createMesh();
@@ -160,88 +324,189 @@ int main (int argc, char* argv[])
 		return -4;
 	}
 
+	std::unique_ptr<ToolsLib::CsvLineSource> in;
+	if (mmap_arg.getValue())
+		in.reset(new ToolsLib::MappedLineSource(csv_in.getValue()));
+	else
+		in.reset(new ToolsLib::StreamLineSource(csv_in.getValue()));
+	if (!in->isOpen())
+	{
+		ERR ("Could not open CSV file.");
+		return -2;
+	}
+
+	double const nan_value = 0.0;
+	unsigned const n_threads (std::max(threads_arg.getValue(), 1u));
+	unsigned const n_writer_threads (std::max(ToolsLib::getNumberOfThreads(0) / n_threads, 1u));
+	ToolsLib::VtuFormat const vtu_format (ToolsLib::getVtuFormat(vtu_format_arg.getValue()));
+	bool const float32 (float32_arg.getValue());
+	bool const compact_material_ids (compact_ids_arg.getValue());
+	std::string const prop_name(BaseLib::extractBaseNameWithoutExtension(csv_in.getValue()));
+
+	// Geometry is identical for all time steps. If a base mesh is given it is
+	// read only once, each worker thread gets its own copy and swaps in the
+	// array of its current time step. Otherwise every time step carries its own
+	// arrays, the new array is appended to the existing file in place and only
+	// files that cannot be extended are read and rewritten.
 	int n_rows = -1;
-	MeshLib::Mesh* mesh = nullptr;
+	std::size_t n_series_nodes (0);
+	std::size_t n_series_cells (0);
+	std::vector<std::unique_ptr<MeshLib::Mesh>> base_meshes;
 	if (mesh_new.isSet())
 	{
-		mesh = MeshLib::IO::VtuInterface::readVTUFile(mesh_new.getValue());
+		timer.start("load_mesh");
+		std::unique_ptr<MeshLib::Mesh> mesh (MeshLib::IO::VtuInterface::readVTUFile(mesh_new.getValue()));
 		if (mesh == nullptr)
 		{
 
 			return -1;
 		}
-		boost::optional<MeshLib::PropertyVector<int>&> materials (mesh->getProperties().getPropertyVector<int>("MaterialIDs"));
-		n_rows = (*std::max_element(materials->cbegin(), materials->cend())) + 1;
+		timer.addBytesRead(ToolsLib::getFileSize(mesh_new.getValue()));
+		timer.stop(mesh->getNElements());
+		n_rows = getNumberOfRows(*mesh);
+		if (n_rows < 1)
+			return -1;
+		if (mesh->getProperties().hasPropertyVector(prop_name))
+		{
+			ERR ("Array \"%s\" already exists in %s.", prop_name.c_str(), mesh_new.getValue().c_str());
+			return -1;
+		}
+		if (!addTimeStepProperty(*mesh, prop_name, float32))
+			return -1;
+		base_meshes.push_back(std::move(mesh));
+		// XDMF output only reads the shared base mesh
+		for (unsigned t=1; t<n_threads && !xdmf_arg.getValue(); ++t)
+			base_meshes.emplace_back(new MeshLib::Mesh(*base_meshes[0]));
+	}
+	else
+	{
+		// the first time step is only needed to determine the grid layout
+		// required for splitting the csv-file into time steps
+		std::string const first_step (mesh_add.getValue() + number2str(0) + ".vtu");
+		timer.start("load_mesh");
+		std::unique_ptr<MeshLib::Mesh> mesh (MeshLib::IO::VtuInterface::readVTUFile(first_step));
+		if (mesh==nullptr)
+		{
+			ERR("No base mesh given and no mesh for time step %d found.", 0);
+			return -6;
+		}
+		timer.addBytesRead(ToolsLib::getFileSize(first_step));
+		timer.stop(mesh->getNElements());
+		n_rows = getNumberOfRows(*mesh);
+		if (n_rows < 1)
+			return -6;
+		if (mesh->getProperties().hasPropertyVector(prop_name))
+		{
+			ERR ("Array \"%s\" already exists in %s, rename the csv-file to add it again.",
+			     prop_name.c_str(), first_step.c_str());
+			return -6;
+		}
+		n_series_nodes = mesh->getNNodes();
+		n_series_cells = mesh->getNElements();
 	}
 
-	std::ifstream in( csv_in.getValue().c_str() );
-	if (!in.is_open())
+	if (xdmf_arg.getValue() && base_meshes.empty())
 	{
-		ERR ("Could not open CSV file.");
-		return -2;
+		ERR ("XDMF output requires a base mesh.");
+		return -1;
 	}
 
-	double const nan_value = 0.0;
+	// Only the first output file is checked interactively, this happens before
+	// any worker is started.
+	std::string const first_output (mesh_add.getValue() + (xdmf_arg.getValue() ? ".xdmf" : number2str(0) + ".vtu"));
+	if (!force_arg.getValue() && !overwriteFiles(first_output))
+		return -7;
 
-	std::string line;
-	std::size_t file_counter(0);
-	bool overwrite (false);
-	while (getline(in, line))
+	std::unique_ptr<ToolsLib::XdmfTimeSeries> series;
+	if (xdmf_arg.getValue())
 	{
-		if (!mesh_new.isSet())
-		{
-			mesh = MeshLib::IO::VtuInterface::readVTUFile(mesh_add.getValue() + number2str(file_counter) + ".vtu");
-			if (mesh==nullptr)
-			{
-				ERR("No base mesh given and no mesh for time step %d found.", file_counter);
-				return -6;
-			}
-			boost::optional<MeshLib::PropertyVector<int>&> materials (mesh->getProperties().getPropertyVector<int>("MaterialIDs"));
-			n_rows = (*std::max_element(materials->cbegin(), materials->cend())) + 1;
-		}
-		std::string const prop_name(BaseLib::extractBaseNameWithoutExtension(csv_in.getValue()));
-		boost::optional<MeshLib::PropertyVector<double>&> prop (mesh->getProperties().createNewPropertyVector<double>(prop_name, MeshLib::MeshItemType::Cell));
-		prop->resize(mesh->getNNodes(), 0);
+		series = ToolsLib::XdmfTimeSeries::create(*base_meshes[0], first_output, prop_name, float32);
+		if (series == nullptr)
+			return -8;
+	}
 
-		for (int i=0; i<=n_rows; ++i)
+	ToolsLib::BoundedQueue<std::unique_ptr<ToolsLib::TimeStep>> queue(2 * n_threads);
+	std::thread reader(ToolsLib::readTimeSteps, std::ref(*in), n_rows, std::ref(queue));
+
+	// the error of the earliest failing time step is reported
+	std::mutex error_mutex;
+	std::size_t error_step (std::numeric_limits<std::size_t>::max());
+	int error_code (0);
+	std::atomic<bool> is_aborted (false);
+
+	std::vector<std::thread> workers;
+	for (unsigned t=0; t<n_threads; ++t)
+	{
+		workers.emplace_back([&, t]()
 		{
-			std::list<std::string> fields = BaseLib::splitString(line, ',');
-			int const n_cols (fields.size());
-			if (n_cols != (mesh->getNElements() / n_rows) + 1)
-				return -3;
-
-			int idx_cnt(i * (n_cols-1));
-			auto it = fields.cbegin();
-			it++;
-			for (; it != fields.cend(); ++it)
+			std::unique_ptr<ToolsLib::TimeStep> step;
+			while (!is_aborted && queue.pop(step))
 			{
-				if ((*it).compare("NaN") == 0)
-					(*prop)[idx_cnt++] = nan_value;
-				else 
-					(*prop)[idx_cnt++] = std::stod(*it);
+				std::string const output_name (mesh_add.getValue() + number2str(step->index) + ".vtu");
+				int result (0);
+				if (series != nullptr)
+				{
+					result = writeTimeStep(*step, *base_meshes[0], n_rows, nan_value, *series, float32, timer);
+				}
+				else if (!base_meshes.empty())
+				{
+					result = writeTimeStep(*step, *base_meshes[t], prop_name, n_rows, nan_value, output_name,
+					                       vtu_format, n_writer_threads, float32, compact_material_ids, timer);
+				}
+				else
+				{
+					// arrays are appended in place if possible, otherwise the mesh is rewritten
+					result = appendTimeStep(*step, n_series_nodes, n_series_cells, prop_name,
+					                        n_rows, nan_value, output_name, n_writer_threads, float32, timer);
+					if (result == 1)
+					{
+						std::unique_ptr<MeshLib::Mesh> mesh;
+						{
+							ToolsLib::ScopedPhase phase(timer, "load_mesh");
+							mesh.reset(MeshLib::IO::VtuInterface::readVTUFile(output_name));
+							phase.addBytesRead(ToolsLib::getFileSize(output_name));
+						}
+						if (mesh==nullptr)
+						{
+							ERR("No base mesh given and no mesh for time step %d found.", step->index);
+							result = -6;
+						}
+						else if (!addTimeStepProperty(*mesh, prop_name, float32))
+							result = -6;
+						else
+							result = writeTimeStep(*step, *mesh, prop_name, n_rows, nan_value, output_name,
+							                       vtu_format, n_writer_threads, float32, compact_material_ids, timer);
+					}
+				}
+
+				if (result != 0)
+				{
+					std::lock_guard<std::mutex> lock(error_mutex);
+					if (step->index < error_step)
+					{
+						error_step = step->index;
+						error_code = result;
+					}
+					is_aborted = true;
+					queue.close();
+				}
 			}
-			getline(in, line);
-		}
+		});
+	}
 
-		INFO ("Writing result #%d...", file_counter);
-		std::string output_name (mesh_add.getValue() + number2str(file_counter) + ".vtu");
-		if (overwrite == false)
-		{
-			overwrite = overwriteFiles(output_name);
+	for (std::thread &worker : workers)
+		worker.join();
+	reader.join();
+
+	if (error_code != 0)
+		return error_code;
+
+	if (series != nullptr && !series->finalize())
+		return -8;
+
+	if (profile_arg.isSet())
+		ToolsLib::writeProfile(profile_arg.getValue(), "addScalarArrayTimeSeries", timer);
 
-			if (overwrite == false)
-				return -7;
-		}
-		MeshLib::IO::VtuInterface vtu(mesh);
-		vtu.writeToFile(output_name);
-		file_counter++;
-	
-		getline(in, line);
-		if (!line.empty())
-			ERR("something is wrong here.");
-	}
-	
-	//delete mesh;
 	delete custom_format;
 	delete logog_cout;
 	LOGOG_SHUTDOWN();
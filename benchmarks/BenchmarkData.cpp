@@ -0,0 +1,282 @@
+/**
+ * @file   BenchmarkData.cpp
+ * @author Karsten Rink
+ * @date   2026/10/14
+ * @brief  Implementation of the benchmark data generators
+ *
+ * @copyright
+ * Copyright (c) 2012-2026, OpenGeoSys Community (http://www.opengeosys.org)
+ *            Distributed under a Modified BSD License.
+ *              See accompanying file LICENSE.txt or
+ *              http://www.opengeosys.org/LICENSE.txt
+ */
+
+#include "BenchmarkData.h"
+
+#include <cmath>
+#include <fstream>
+#include <random>
+
+#include "logog/include/logog.hpp"
+
+#include "MeshLib/Mesh.h"
+
+#include "ToolsLib/GmlStream.h"
+#include "ToolsLib/StructuredGrid.h"
+#include "ToolsLib/VtuWriter.h"
+
+namespace
+{
+double const pi (3.14159265358979323846);
+
+// the ERT profile runs diagonally, i.e. neither easting nor northing are
+// constant along it as ErtData2Mesh requires
+double const ert_dir_x (0.8);
+double const ert_dir_y (0.6);
+double const ert_x0 (4500000.0);
+double const ert_y0 (5700000.0);
+
+/// Opens a text file for writing large amounts of numbers.
+bool openOutput(std::string const& file_name, std::ofstream &out)
+{
+	out.open(file_name.c_str());
+	if (!out.is_open())
+	{
+		ERR ("Could not open file %s.", file_name.c_str());
+		return false;
+	}
+	out.precision(10);
+	return true;
+}
+
+/// Elevation of the ERT topography at the given profile position.
+double getTopography(double distance)
+{
+	return 100.0 + 5.0 * std::sin(0.05 * distance);
+}
+
+/// Smooth field sampled by the EMI surveys.
+double getEmiField(double x, double y, double extent)
+{
+	return 20.0 + 10.0 * std::sin(6.0 * x / extent) * std::cos(4.0 * y / extent);
+}
+} // end anonymous namespace
+
+bool writeErtCsv(std::string const& file_name, std::size_t n_layers, std::size_t n_cols, unsigned seed)
+{
+	if (n_layers < 1 || n_cols < 3)
+	{
+		ERR ("writeErtCsv(): At least one layer and three columns are required.");
+		return false;
+	}
+
+	std::ofstream out;
+	if (!openOutput(file_name, out))
+		return false;
+
+	double const layer_thickness (1.0);
+	std::mt19937 rng(seed);
+	std::lognormal_distribution<double> resistance(4.0, 0.5);
+	std::uniform_real_distribution<double> coverage(0.0, 1.0);
+
+	out << "x2/m\tz1/m\tz2/m\tE1\tN1\tH1\tE2\tN2\tH2\trho/Ohmm \tcoverage\n";
+	for (std::size_t l=0; l<n_layers; ++l)
+		for (std::size_t c=0; c<n_cols; ++c)
+		{
+			// x2/m is the index of the quad within its layer
+			double const d1 (static_cast<double>(c));
+			double const d2 (d1 + 1.0);
+			out << c << "\t" << l * layer_thickness << "\t" << (l + 1) * layer_thickness << "\t"
+			    << ert_x0 + ert_dir_x * d1 << "\t" << ert_y0 + ert_dir_y * d1 << "\t" << getTopography(d1) << "\t"
+			    << ert_x0 + ert_dir_x * d2 << "\t" << ert_y0 + ert_dir_y * d2 << "\t" << getTopography(d2) << "\t"
+			    << resistance(rng) << "\t" << coverage(rng) << "\n";
+		}
+	return out.good();
+}
+
+bool writeErtDem(std::string const& file_name, std::size_t n_cols)
+{
+	std::ofstream out;
+	if (!openOutput(file_name, out))
+		return false;
+
+	// the elevation of a cell is the topography at its projection onto the profile
+	double const cell_size (1.0);
+	std::size_t const margin (5);
+	std::size_t const n_raster_cols (static_cast<std::size_t>(std::ceil(ert_dir_x * n_cols / cell_size)) + 2 * margin);
+	std::size_t const n_raster_rows (static_cast<std::size_t>(std::ceil(ert_dir_y * n_cols / cell_size)) + 2 * margin);
+	double const x_ll (ert_x0 - margin * cell_size);
+	double const y_ll (ert_y0 - margin * cell_size);
+	out << "ncols " << n_raster_cols << "\n"
+	    << "nrows " << n_raster_rows << "\n"
+	    << "xllcorner " << x_ll << "\n"
+	    << "yllcorner " << y_ll << "\n"
+	    << "cellsize " << cell_size << "\n"
+	    << "NODATA_value -9999\n";
+	for (std::size_t r=n_raster_rows; r>0; --r)
+	{
+		double const y (y_ll + (r - 0.5) * cell_size - ert_y0);
+		for (std::size_t c=0; c<n_raster_cols; ++c)
+		{
+			double const x (x_ll + (c + 0.5) * cell_size - ert_x0);
+			out << ((c == 0) ? "" : " ") << getTopography(ert_dir_x * x + ert_dir_y * y);
+		}
+		out << "\n";
+	}
+	return out.good();
+}
+
+bool writeEmiFiles(std::string const& base_name, std::vector<std::string> const& regions,
+                   std::vector<std::string> const& specifiers, std::size_t n_points, double extent,
+                   unsigned seed)
+{
+	if (regions.empty())
+		return false;
+
+	std::mt19937 rng(seed);
+	std::normal_distribution<double> noise(0.0, 1.0);
+	double const strip_width (extent / regions.size());
+	for (std::size_t r=0; r<regions.size(); ++r)
+	{
+		std::uniform_real_distribution<double> x_dist(r * strip_width, (r + 1) * strip_width);
+		std::uniform_real_distribution<double> y_dist(0.0, extent);
+		for (std::string const& specifier : specifiers)
+		{
+			std::ofstream out;
+			if (!openOutput(base_name + "_" + regions[r] + "_" + specifier + ".txt", out))
+				return false;
+			out << "ID\tx\ty\tTM_DD_" << specifier << "\n";
+			for (std::size_t i=0; i<n_points; ++i)
+			{
+				double const x (x_dist(rng));
+				double const y (y_dist(rng));
+				out << i << "\t" << x << "\t" << y << "\t" << getEmiField(x, y, extent) + noise(rng) << "\n";
+			}
+			if (!out.good())
+				return false;
+		}
+	}
+	return true;
+}
+
+std::unique_ptr<ToolsLib::StructuredGrid> createEmiGrid(std::size_t n_cells, double extent)
+{
+	std::size_t const n_nodes (n_cells + 1);
+	double const spacing (extent / n_cells);
+	std::vector<double> x, y;
+	x.reserve(n_nodes * n_nodes);
+	y.reserve(n_nodes * n_nodes);
+	for (std::size_t r=0; r<n_nodes; ++r)
+		for (std::size_t c=0; c<n_nodes; ++c)
+		{
+			x.push_back(c * spacing);
+			y.push_back(r * spacing);
+		}
+	std::vector<double> z (n_nodes, 0.0);
+	return ToolsLib::StructuredGrid::create(n_nodes, n_nodes, std::move(x), std::move(y), std::move(z));
+}
+
+bool writeTimeSeriesCsv(std::string const& file_name, std::size_t n_rows, std::size_t n_cols,
+                        std::size_t n_steps, unsigned seed)
+{
+	std::ofstream out;
+	if (!openOutput(file_name, out))
+		return false;
+
+	std::mt19937 rng(seed);
+	std::uniform_real_distribution<double> noise(-0.01, 0.01);
+	for (std::size_t t=0; t<n_steps; ++t)
+	{
+		for (std::size_t r=0; r<=n_rows; ++r)
+		{
+			out << "row" << r;
+			for (std::size_t c=0; c<n_cols; ++c)
+			{
+				// a front moving through the grid, rows beyond it are not yet reached
+				double const front (static_cast<double>(t + 1) / n_steps * n_cols);
+				if (c > front)
+					out << ",NaN";
+				else
+					out << "," << std::exp(-0.1 * (front - c)) + noise(rng);
+			}
+			out << "\n";
+		}
+		out << "step" << t << "\n\n";
+	}
+	return out.good();
+}
+
+std::unique_ptr<ToolsLib::StructuredGrid> createTimeSeriesGrid(std::size_t n_rows, std::size_t n_cols)
+{
+	std::vector<double> x, y, z;
+	for (std::size_t c=0; c<=n_cols; ++c)
+	{
+		x.push_back(static_cast<double>(c));
+		y.push_back(0.0);
+	}
+	for (std::size_t r=0; r<=n_rows; ++r)
+		z.push_back(-static_cast<double>(r));
+	return ToolsLib::StructuredGrid::create(n_rows + 1, n_cols + 1, std::move(x), std::move(y), std::move(z));
+}
+
+bool writeBenchmarkMesh(ToolsLib::StructuredGrid const& grid, std::string const& file_name)
+{
+	std::unique_ptr<MeshLib::Mesh> const mesh (grid.toMesh("Benchmark Mesh"));
+	if (mesh == nullptr || !ToolsLib::writeVtu(*mesh, file_name, ToolsLib::VtuFormat::Raw))
+	{
+		ERR ("Error writing mesh %s.", file_name.c_str());
+		return false;
+	}
+	INFO ("Mesh written to %s.", file_name.c_str());
+	return true;
+}
+
+bool writeBuildingsGml(std::string const& file_name, std::string const& heights_file,
+                       std::size_t n_buildings, std::size_t n_corners, unsigned seed)
+{
+	if (n_corners < 3)
+	{
+		ERR ("writeBuildingsGml(): Footprints need at least three corners.");
+		return false;
+	}
+
+	std::ofstream heights;
+	if (!heights_file.empty() && !openOutput(heights_file, heights))
+		return false;
+
+	ToolsLib::GmlWriter gml(file_name, "buildings");
+	if (!gml.isOpen())
+		return false;
+
+	std::size_t const n_lots_per_row (static_cast<std::size_t>(std::ceil(std::sqrt(static_cast<double>(n_buildings)))));
+	double const lot_size (30.0);
+	std::mt19937 rng(seed);
+	std::uniform_real_distribution<double> radius(5.0, 12.0);
+	std::uniform_real_distribution<double> rotation(0.0, 2 * pi);
+	std::uniform_real_distribution<double> height(3.0, 40.0);
+	for (std::size_t b=0; b<n_buildings; ++b)
+	{
+		double const cx ((b % n_lots_per_row + 0.5) * lot_size);
+		double const cy ((b / n_lots_per_row + 0.5) * lot_size);
+		double const r (radius(rng));
+		double const phi (rotation(rng));
+		for (std::size_t i=0; i<n_corners; ++i)
+		{
+			double const angle (phi + 2 * pi * i / n_corners);
+			gml.addPoint(cx + r * std::cos(angle), cy + r * std::sin(angle), 0.0);
+		}
+	}
+
+	std::vector<std::size_t> ids (n_corners + 1);
+	for (std::size_t b=0; b<n_buildings; ++b)
+	{
+		for (std::size_t i=0; i<n_corners; ++i)
+			ids[i] = b * n_corners + i;
+		ids[n_corners] = ids[0];
+		std::string const name ("building_" + std::to_string(b));
+		gml.addPolyline(name, ids);
+		if (heights.is_open())
+			heights << name << "," << height(rng) << "\n";
+	}
+	return gml.close() && (!heights.is_open() || heights.good());
+}
@@ -0,0 +1,76 @@
+/**
+ * @file   BenchmarkData.h
+ * @author Karsten Rink
+ * @date   2026/10/14
+ * @brief  Generators for synthetic input data of the tools
+ *
+ * @copyright
+ * Copyright (c) 2012-2026, OpenGeoSys Community (http://www.opengeosys.org)
+ *            Distributed under a Modified BSD License.
+ *              See accompanying file LICENSE.txt or
+ *              http://www.opengeosys.org/LICENSE.txt
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ToolsLib
+{
+	class StructuredGrid;
+}
+
+/**
+ * Writes an ERT profile of n_layers x n_cols quads in the format read by
+ * ErtData2Mesh (tab separated, one quad per row, layer by layer). The
+ * profile runs diagonally in the xy-plane over a smooth topography,
+ * resistance and coverage are pseudo-random. Requires n_cols >= 3.
+ */
+bool writeErtCsv(std::string const& file_name, std::size_t n_layers, std::size_t n_cols, unsigned seed);
+
+/// Writes an ASCII raster (*.asc) of the topography of the ERT profile
+/// written by writeErtCsv(), covering the profile with a margin of a few
+/// cells, as DEM for ErtData2Mesh.
+bool writeErtDem(std::string const& file_name, std::size_t n_cols);
+
+/**
+ * Writes the EMI survey files <base_name>_<region>_<specifier>.txt read by
+ * addEmiDataToMesh and EmiData2PolyData, n_points per file. The regions
+ * split the square [0, extent]^2 into strips parallel to the y-axis.
+ */
+bool writeEmiFiles(std::string const& base_name, std::vector<std::string> const& regions,
+                   std::vector<std::string> const& specifiers, std::size_t n_points, double extent,
+                   unsigned seed);
+
+/// Creates a flat grid of n_cells x n_cells quads covering [0, extent]^2 as
+/// target of the EMI binning.
+std::unique_ptr<ToolsLib::StructuredGrid> createEmiGrid(std::size_t n_cells, double extent);
+
+/**
+ * Writes n_steps time steps in the format read by addScalarArrayTimeSeries
+ * for a grid of n_rows x n_cols cells. Each time step consists of n_rows+1
+ * rows of a label followed by n_cols comma separated values, a trailing line
+ * and an empty separator line.
+ */
+bool writeTimeSeriesCsv(std::string const& file_name, std::size_t n_rows, std::size_t n_cols,
+                        std::size_t n_steps, unsigned seed);
+
+/// Creates the vertical base grid of n_rows x n_cols cells matching
+/// writeTimeSeriesCsv().
+std::unique_ptr<ToolsLib::StructuredGrid> createTimeSeriesGrid(std::size_t n_rows, std::size_t n_cols);
+
+/// Writes the grid as mesh file, the format is readable by all tools.
+bool writeBenchmarkMesh(ToolsLib::StructuredGrid const& grid, std::string const& file_name);
+
+/**
+ * Writes a geometry file with n_buildings footprints, each a closed polyline
+ * named building_<i> around a regular polygon with n_corners corners, placed
+ * on a square grid of building lots with pseudo-random size and rotation.
+ * If heights_file is not empty the building heights are written to it as
+ * '<name>,<height>' lines as read by makeBuildings --heights.
+ */
+bool writeBuildingsGml(std::string const& file_name, std::string const& heights_file,
+                       std::size_t n_buildings, std::size_t n_corners, unsigned seed);
@@ -0,0 +1,120 @@
+/**
+ * @file   generateBenchmarkData.cpp
+ * @author Karsten Rink
+ * @date   2026/10/14
+ * @brief  Writes synthetic input data for the tools at configurable sizes
+ *
+ * @copyright
+ * Copyright (c) 2012-2026, OpenGeoSys Community (http://www.opengeosys.org)
+ *            Distributed under a Modified BSD License.
+ *              See accompanying file LICENSE.txt or
+ *              http://www.opengeosys.org/LICENSE.txt
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+
+// TCLAP
+#include "tclap/CmdLine.h"
+
+// ThirdParty/logog
+#include "logog/include/logog.hpp"
+
+// BaseLib
+#include "BaseLib/LogogSimpleFormatter.h"
+
+#include "ToolsLib/StructuredGrid.h"
+
+#include "BenchmarkData.h"
+
+int main (int argc, char* argv[])
+{
+	LOGOG_INITIALIZE();
+	logog::Cout* logog_cout (new logog::Cout);
+	BaseLib::LogogSimpleFormatter *custom_format (new BaseLib::LogogSimpleFormatter);
+	logog_cout->SetFormatter(*custom_format);
+
+	TCLAP::CmdLine cmd("Writes synthetic input data for benchmarking ErtData2Mesh, addEmiDataToMesh, EmiData2PolyData, addScalarArrayTimeSeries and makeBuildings.", ' ', "0.1");
+
+	std::vector<std::string> types { "ert", "emi", "timeseries", "buildings" };
+	TCLAP::ValuesConstraint<std::string> type_values(types);
+	TCLAP::ValueArg<std::string> type_arg("t", "type",
+	                                      "Type of data: \'ert\' writes <output>.csv and the DEM <output>_dem.asc, \'emi\' the survey files <output>_<A|B|C>_<H|V>.txt and the target mesh <output>_mesh.vtu, \'timeseries\' writes <output>.csv and the base mesh <output>_base.vtu, \'buildings\' writes <output>.gml and the building heights <output>_heights.csv.",
+	                                      true, "", &type_values);
+	cmd.add(type_arg);
+	TCLAP::ValueArg<std::string> output_arg("o", "output",
+	                                        "Base name of the output files.",
+	                                        true, "", "base name");
+	cmd.add(output_arg);
+	TCLAP::ValueArg<std::size_t> rows_arg("r", "rows",
+	                                      "Number of layers of the ERT profile or rows of cells of the time series grid.",
+	                                      false, 100, "number of rows");
+	cmd.add(rows_arg);
+	TCLAP::ValueArg<std::size_t> cols_arg("c", "columns",
+	                                      "Number of quads per layer of the ERT profile or columns of cells of the time series grid.",
+	                                      false, 1000, "number of columns");
+	cmd.add(cols_arg);
+	TCLAP::ValueArg<std::size_t> points_arg("n", "points",
+	                                        "Number of EMI points per region and specifier.",
+	                                        false, 100000, "number of points");
+	cmd.add(points_arg);
+	TCLAP::ValueArg<std::size_t> cells_arg("", "cells",
+	                                       "Number of cells along each side of the EMI target mesh.",
+	                                       false, 500, "number of cells");
+	cmd.add(cells_arg);
+	TCLAP::ValueArg<std::size_t> steps_arg("s", "steps",
+	                                       "Number of time steps.",
+	                                       false, 10, "number of time steps");
+	cmd.add(steps_arg);
+	TCLAP::ValueArg<std::size_t> buildings_arg("b", "buildings",
+	                                           "Number of buildings.",
+	                                           false, 10000, "number of buildings");
+	cmd.add(buildings_arg);
+	TCLAP::ValueArg<std::size_t> corners_arg("", "corners",
+	                                         "Number of corners of each building footprint.",
+	                                         false, 8, "number of corners");
+	cmd.add(corners_arg);
+	TCLAP::ValueArg<unsigned> seed_arg("", "seed",
+	                                   "Seed of the pseudo-random values, equal seeds produce identical files.",
+	                                   false, 0, "seed");
+	cmd.add(seed_arg);
+	cmd.parse(argc, argv);
+
+	std::string const& type (type_arg.getValue());
+	std::string const& output (output_arg.getValue());
+	unsigned const seed (seed_arg.getValue());
+	bool success (false);
+	if (type == "ert")
+	{
+		success = writeErtCsv(output + ".csv", rows_arg.getValue(), cols_arg.getValue(), seed) &&
+		          writeErtDem(output + "_dem.asc", cols_arg.getValue());
+	}
+	else if (type == "emi")
+	{
+		double const extent (1000.0);
+		std::unique_ptr<ToolsLib::StructuredGrid> const grid (createEmiGrid(cells_arg.getValue(), extent));
+		success = writeEmiFiles(output, { "A", "B", "C" }, { "H", "V" }, points_arg.getValue(), extent, seed) &&
+		          grid != nullptr && writeBenchmarkMesh(*grid, output + "_mesh.vtu");
+	}
+	else if (type == "timeseries")
+	{
+		std::unique_ptr<ToolsLib::StructuredGrid> const grid (createTimeSeriesGrid(rows_arg.getValue(), cols_arg.getValue()));
+		success = writeTimeSeriesCsv(output + ".csv", rows_arg.getValue(), cols_arg.getValue(), steps_arg.getValue(), seed) &&
+		          grid != nullptr && writeBenchmarkMesh(*grid, output + "_base.vtu");
+	}
+	else if (type == "buildings")
+	{
+		success = writeBuildingsGml(output + ".gml", output + "_heights.csv",
+		                            buildings_arg.getValue(), corners_arg.getValue(), seed);
+	}
+
+	if (!success)
+		ERR ("Error writing %s data.", type.c_str());
+
+	delete custom_format;
+	delete logog_cout;
+	LOGOG_SHUTDOWN();
+
+	return success ? 0 : 1;
+}
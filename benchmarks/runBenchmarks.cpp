@@ -0,0 +1,405 @@
+/**
+ * @file   runBenchmarks.cpp
+ * @author Karsten Rink
+ * @date   2026/10/14
+ * @brief  Runs the processing pipelines of the tools on synthetic data
+ *
+ * @copyright
+ * Copyright (c) 2012-2026, OpenGeoSys Community (http://www.opengeosys.org)
+ *            Distributed under a Modified BSD License.
+ *              See accompanying file LICENSE.txt or
+ *              http://www.opengeosys.org/LICENSE.txt
+ */
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+// TCLAP
+#include "tclap/CmdLine.h"
+
+// ThirdParty/logog
+#include "logog/include/logog.hpp"
+
+// BaseLib
+#include "BaseLib/LogogSimpleFormatter.h"
+
+#include "ToolsLib/ParallelFor.h"
+#include "ToolsLib/PhaseTimer.h"
+#include "ToolsLib/StructuredGrid.h"
+#include "ToolsLib/VtuWriter.h"
+
+#include "BenchmarkData.h"
+
+/// Settings shared by all benchmarks.
+struct BenchmarkSettings
+{
+	std::string work_dir;
+	std::string tools_dir;
+	std::size_t scale;
+	unsigned n_threads;
+	unsigned seed;
+	std::string vtu_format;
+};
+
+/// Sizes and timings of one run of a benchmark.
+struct BenchmarkResult
+{
+	std::string name;
+	std::size_t repetition;
+	bool success;
+	std::vector<std::pair<std::string, std::size_t>> parameters;
+	std::string command;
+	double seconds;
+	std::string profile; ///< JSON profile written by the tool, empty if the run failed
+};
+
+/// Returns the command line calling the given tool of the build.
+std::string getCommandLine(BenchmarkSettings const& settings, std::string const& tool,
+                           std::vector<std::string> const& args)
+{
+	std::string command ("\"" + settings.tools_dir + "/" + tool + "\"");
+	for (std::string const& arg : args)
+		command += " \"" + arg + "\"";
+	return command;
+}
+
+/// Runs a tool of the build, its output is written to the log file.
+bool runTool(BenchmarkSettings const& settings, std::string const& tool,
+             std::vector<std::string> const& args, std::string const& log_file)
+{
+	std::string command (getCommandLine(settings, tool, args) + " > \"" + log_file + "\" 2>&1");
+#ifdef _WIN32
+	// cmd.exe removes the outer quotes of the command
+	command = "\"" + command + "\"";
+#endif
+	if (std::system(command.c_str()) != 0)
+	{
+		ERR ("%s failed, see %s.", tool.c_str(), log_file.c_str());
+		return false;
+	}
+	return true;
+}
+
+/// Reads the profile of a tool and indents it for the results file.
+bool readProfile(std::string const& file_name, std::string &profile)
+{
+	std::ifstream in(file_name.c_str());
+	if (!in.is_open())
+		return false;
+	std::string const content ((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+	profile.clear();
+	for (char const c : content)
+		profile += (c == '\n') ? std::string("\n      ") : std::string(1, c);
+	while (!profile.empty() && std::isspace(static_cast<unsigned char>(profile.back())))
+		profile.pop_back();
+	return !profile.empty();
+}
+
+/**
+ * Runs a tool of the build on the generated data, measures the wall time of
+ * the process and adds the profile of the tool, i.e. the timings of its
+ * phases (e.g. parse, build, bin, write), to the result. The output of the
+ * tool is written to <work-dir>/<benchmark>.log.
+ */
+bool runTimedTool(BenchmarkSettings const& settings, std::string const& tool,
+                  std::vector<std::string> args, BenchmarkResult &result)
+{
+	std::string const profile_base (settings.work_dir + "/" + result.name + "_profile");
+	// MPI builds of addEmiDataToMesh write one profile per process
+	std::vector<std::string> const profile_files { profile_base + ".json", profile_base + "_0.json" };
+	for (std::string const& file_name : profile_files)
+		std::remove(file_name.c_str());
+	args.insert(args.end(), { "--profile", profile_files[0] });
+	result.command = getCommandLine(settings, tool, args);
+
+	std::chrono::steady_clock::time_point const start (std::chrono::steady_clock::now());
+	bool const is_run (runTool(settings, tool, args, settings.work_dir + "/" + result.name + ".log"));
+	result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	if (!is_run)
+		return false;
+
+	for (std::string const& file_name : profile_files)
+		if (readProfile(file_name, result.profile))
+			return true;
+	ERR ("%s wrote no profile.", tool.c_str());
+	return false;
+}
+
+/// ErtData2Mesh: a profile over a DEM, i.e. including the elevation correction.
+bool runErtBenchmark(BenchmarkSettings const& settings, BenchmarkResult &result)
+{
+	std::size_t const n_layers (100 * settings.scale);
+	std::size_t const n_cols (1000);
+	result.parameters = { { "layers", n_layers }, { "columns", n_cols } };
+	std::string const csv_file (settings.work_dir + "/ert.csv");
+	std::string const dem_file (settings.work_dir + "/ert_dem.asc");
+	if (!writeErtCsv(csv_file, n_layers, n_cols, settings.seed) || !writeErtDem(dem_file, n_cols))
+		return false;
+
+	return runTimedTool(settings, "ErtData2Mesh",
+		{ "-i", csv_file, "-s", dem_file, "-o", settings.work_dir + "/ert.vtu",
+		  "--vtu-format", settings.vtu_format, "-p", std::to_string(settings.n_threads) }, result);
+}
+
+/// Writes the EMI surveys of the regions A, B and C for the given specifiers
+/// and the target mesh <work-dir>/emi_mesh.vtu.
+bool writeEmiData(BenchmarkSettings const& settings, std::vector<std::string> const& specifiers,
+                  BenchmarkResult &result)
+{
+	std::size_t const n_points (100000 * settings.scale);
+	std::size_t const n_cells (500);
+	double const extent (1000.0);
+	std::vector<std::string> const regions { "A", "B", "C" };
+	result.parameters = { { "points_per_region", n_points }, { "regions", regions.size() },
+	                      { "data_sets", specifiers.size() }, { "cells", n_cells * n_cells } };
+	std::unique_ptr<ToolsLib::StructuredGrid> const grid (createEmiGrid(n_cells, extent));
+	return writeEmiFiles(settings.work_dir + "/emi", regions, specifiers, n_points, extent, settings.seed) &&
+	       grid != nullptr && writeBenchmarkMesh(*grid, settings.work_dir + "/emi_mesh.vtu");
+}
+
+/**
+ * addEmiDataToMesh: binning the surveys into the cells of the target mesh.
+ * The points are either read at once or streamed in chunks of the given
+ * size (if not zero).
+ */
+bool runEmiBenchmark(BenchmarkSettings const& settings, std::size_t chunk_size, BenchmarkResult &result)
+{
+	if (!writeEmiData(settings, { "H" }, result))
+		return false;
+	result.parameters.emplace_back("chunk_size", chunk_size);
+
+	return runTimedTool(settings, "addEmiDataToMesh",
+		{ "-i", settings.work_dir + "/emi_mesh.vtu", "--csv", settings.work_dir + "/emi", "-s", "H",
+		  "-o", settings.work_dir + "/emi.vtu", "--chunk-size", std::to_string(chunk_size),
+		  "--vtu-format", settings.vtu_format, "-p", std::to_string(settings.n_threads) }, result);
+}
+
+/// addEmiDataToMesh: a batch of two jobs on the same mesh processed
+/// concurrently, sharing the threads.
+bool runEmiBatchBenchmark(BenchmarkSettings const& settings, BenchmarkResult &result)
+{
+	std::vector<std::string> const specifiers { "H", "V" };
+	if (!writeEmiData(settings, specifiers, result))
+		return false;
+
+	std::string const manifest_file (settings.work_dir + "/emi_batch.csv");
+	std::ofstream manifest(manifest_file.c_str());
+	manifest << "mesh,csv,specifiers,output\n";
+	for (std::string const& specifier : specifiers)
+		manifest << settings.work_dir << "/emi_mesh.vtu," << settings.work_dir << "/emi," << specifier << ","
+		         << settings.work_dir << "/emi_" << specifier << ".vtu\n";
+	manifest.close();
+	if (!manifest.good())
+	{
+		ERR ("Error writing manifest %s.", manifest_file.c_str());
+		return false;
+	}
+
+	unsigned const n_jobs (specifiers.size());
+	return runTimedTool(settings, "addEmiDataToMesh",
+		{ "-b", manifest_file, "-j", std::to_string(n_jobs), "--vtu-format", settings.vtu_format,
+		  "-p", std::to_string(std::max(settings.n_threads / n_jobs, 1u)) }, result);
+}
+
+/// Writes the csv-file <work-dir>/<name>.csv of the time series benchmarks
+/// and the base mesh <work-dir>/timeseries_base.vtu.
+bool writeTimeSeriesData(BenchmarkSettings const& settings, std::string const& name, unsigned seed,
+                         BenchmarkResult &result)
+{
+	std::size_t const n_rows (100);
+	std::size_t const n_cols (1000);
+	std::size_t const n_steps (10 * settings.scale);
+	result.parameters = { { "rows", n_rows }, { "columns", n_cols }, { "steps", n_steps } };
+	std::unique_ptr<ToolsLib::StructuredGrid> const grid (createTimeSeriesGrid(n_rows, n_cols));
+	return writeTimeSeriesCsv(settings.work_dir + "/" + name + ".csv", n_rows, n_cols, n_steps, seed) &&
+	       grid != nullptr && writeBenchmarkMesh(*grid, settings.work_dir + "/timeseries_base.vtu");
+}
+
+/**
+ * addScalarArrayTimeSeries: with add_array false a new time series is created
+ * from the base mesh. Otherwise a second array is added to an existing time
+ * series, which is created beforehand and not part of the timings.
+ */
+bool runTimeSeriesBenchmark(BenchmarkSettings const& settings, bool add_array, BenchmarkResult &result)
+{
+	if (!writeTimeSeriesData(settings, "timeseries", settings.seed, result))
+		return false;
+	std::string const output (settings.work_dir + "/timeseries");
+	std::vector<std::string> const output_args { "-t", output, "-f", "--vtu-format", settings.vtu_format,
+		"-p", std::to_string(settings.n_threads) };
+	std::vector<std::string> args { "-b", settings.work_dir + "/timeseries_base.vtu",
+		"-i", settings.work_dir + "/timeseries.csv" };
+	args.insert(args.end(), output_args.cbegin(), output_args.cend());
+	if (!add_array)
+		return runTimedTool(settings, "addScalarArrayTimeSeries", args, result);
+
+	if (!runTool(settings, "addScalarArrayTimeSeries", args, settings.work_dir + "/" + result.name + "_setup.log") ||
+	    !writeTimeSeriesData(settings, "timeseries_added", settings.seed + 1, result))
+		return false;
+	args = { "-i", settings.work_dir + "/timeseries_added.csv" };
+	args.insert(args.end(), output_args.cbegin(), output_args.cend());
+	return runTimedTool(settings, "addScalarArrayTimeSeries", args, result);
+}
+
+/// makeBuildings: extruding the footprints to their individual heights into
+/// a compact triangle mesh written as binary PLY file.
+bool runBuildingsBenchmark(BenchmarkSettings const& settings, BenchmarkResult &result)
+{
+	std::size_t const n_buildings (10000 * settings.scale);
+	std::size_t const n_corners (8);
+	result.parameters = { { "buildings", n_buildings }, { "corners", n_corners } };
+	std::string const gml_file (settings.work_dir + "/buildings.gml");
+	std::string const heights_file (settings.work_dir + "/buildings_heights.csv");
+	if (!writeBuildingsGml(gml_file, heights_file, n_buildings, n_corners, settings.seed))
+		return false;
+
+	return runTimedTool(settings, "makeBuildings",
+		{ "-i", gml_file, "--heights", heights_file, "-s", "10", "-o", settings.work_dir + "/buildings.ply",
+		  "-p", std::to_string(settings.n_threads) }, result);
+}
+
+/// Writes all results as JSON document.
+bool writeResults(std::string const& file_name, BenchmarkSettings const& settings,
+                  std::vector<BenchmarkResult> const& results)
+{
+	std::ofstream out(file_name.c_str());
+	if (!out.is_open())
+	{
+		ERR ("Could not open file %s.", file_name.c_str());
+		return false;
+	}
+	out << "{\n"
+	    << "  \"scale\": " << settings.scale << ",\n"
+	    << "  \"threads\": " << settings.n_threads << ",\n"
+	    << "  \"seed\": " << settings.seed << ",\n"
+	    << "  \"benchmarks\": [";
+	for (auto it = results.cbegin(); it != results.cend(); ++it)
+	{
+		BenchmarkResult const& result (*it);
+		out << ((it == results.cbegin()) ? "\n" : ",\n")
+		    << "    {\n"
+		    << "      \"name\": " << ToolsLib::toJsonString(result.name) << ",\n"
+		    << "      \"repetition\": " << result.repetition << ",\n"
+		    << "      \"success\": " << (result.success ? "true" : "false") << ",\n"
+		    << "      \"parameters\": {";
+		for (std::size_t j=0; j<result.parameters.size(); ++j)
+			out << ((j == 0) ? " " : ", ") << ToolsLib::toJsonString(result.parameters[j].first)
+			    << ": " << result.parameters[j].second;
+		out << " },\n"
+		    << "      \"command\": " << ToolsLib::toJsonString(result.command) << ",\n"
+		    << "      \"total_seconds\": " << result.seconds << ",\n"
+		    << "      \"profile\": " << (result.profile.empty() ? std::string("null") : result.profile)
+		    << "\n    }";
+	}
+	out << "\n  ]\n}\n";
+	return out.good();
+}
+
+int main (int argc, char* argv[])
+{
+	LOGOG_INITIALIZE();
+	logog::Cout* logog_cout (new logog::Cout);
+	BaseLib::LogogSimpleFormatter *custom_format (new BaseLib::LogogSimpleFormatter);
+	logog_cout->SetFormatter(*custom_format);
+
+	TCLAP::CmdLine cmd("Runs the tools on synthetic data and reports the wall time of each run together with the profile of the tool, i.e. the wall time of each phase (e.g. parse, build, bin, write), as JSON. Input data is generated in the working directory before each run and is not part of the timings.", ' ', "0.1");
+
+	TCLAP::ValueArg<std::string> output_arg("o", "output",
+	                                        "JSON file the results are written to.",
+	                                        false, "benchmark_results.json", "file name");
+	cmd.add(output_arg);
+	TCLAP::ValueArg<std::string> work_dir_arg("d", "work-dir",
+	                                          "Existing directory for the generated input and output files.",
+	                                          false, ".", "directory");
+	cmd.add(work_dir_arg);
+	TCLAP::ValueArg<std::string> tools_dir_arg("t", "tools-dir",
+	                                           "Directory containing the executables of the tools.",
+	                                           false, ".", "directory");
+	cmd.add(tools_dir_arg);
+	std::vector<std::string> benchmark_names { "ert", "emi", "emi_chunked", "emi_batch", "timeseries",
+		"timeseries_append", "buildings" };
+	TCLAP::ValuesConstraint<std::string> benchmark_values(benchmark_names);
+	TCLAP::MultiArg<std::string> benchmark_arg("b", "benchmark",
+	                                           "Benchmark to run, can be given multiple times. \'emi_chunked\' streams the EMI files in chunks, \'emi_batch\' bins two data sets as concurrent jobs of a batch, \'timeseries_append\' adds an array to an existing time series. Default is all benchmarks.",
+	                                           false, &benchmark_values);
+	cmd.add(benchmark_arg);
+	TCLAP::ValueArg<std::size_t> scale_arg("s", "scale",
+	                                       "Scales the number of ERT layers, EMI points, time steps and buildings. Scale 1 corresponds to 100k ERT rows, 300k EMI points, 10 time steps of 100k cells and 10k buildings.",
+	                                       false, 1, "scale factor");
+	cmd.add(scale_arg);
+	TCLAP::ValueArg<std::size_t> repetitions_arg("r", "repetitions",
+	                                             "Number of runs of each benchmark.",
+	                                             false, 1, "number of runs");
+	cmd.add(repetitions_arg);
+	TCLAP::ValueArg<unsigned> threads_arg("p", "threads",
+	                                      "Number of threads passed to the tools, 0 uses all available cores.",
+	                                      false, 1, "number of threads");
+	cmd.add(threads_arg);
+	std::vector<std::string> vtu_formats (ToolsLib::getVtuFormatNames());
+	TCLAP::ValuesConstraint<std::string> vtu_format_values(vtu_formats);
+	TCLAP::ValueArg<std::string> vtu_format_arg("", "vtu-format",
+	                                            "Format of the mesh files written by the tools.",
+	                                            false, "raw", &vtu_format_values);
+	cmd.add(vtu_format_arg);
+	TCLAP::ValueArg<unsigned> seed_arg("", "seed",
+	                                   "Seed of the pseudo-random input data.",
+	                                   false, 0, "seed");
+	cmd.add(seed_arg);
+	cmd.parse(argc, argv);
+
+	BenchmarkSettings const settings { work_dir_arg.getValue(), tools_dir_arg.getValue(),
+		std::max<std::size_t>(scale_arg.getValue(), 1), ToolsLib::getNumberOfThreads(threads_arg.getValue()),
+		seed_arg.getValue(), vtu_format_arg.getValue() };
+	std::vector<std::string> const selected (benchmark_arg.getValue().empty() ? benchmark_names : benchmark_arg.getValue());
+
+	std::vector<BenchmarkResult> results;
+	for (std::string const& name : selected)
+		for (std::size_t r=0; r<repetitions_arg.getValue(); ++r)
+		{
+			INFO ("Running benchmark \'%s\' (%d/%d)...", name.c_str(), r+1, repetitions_arg.getValue());
+			results.emplace_back();
+			BenchmarkResult &result (results.back());
+			result.name = name;
+			result.repetition = r;
+			result.seconds = 0;
+			if (name == "ert")
+				result.success = runErtBenchmark(settings, result);
+			else if (name == "emi")
+				result.success = runEmiBenchmark(settings, 0, result);
+			else if (name == "emi_chunked")
+				result.success = runEmiBenchmark(settings, 10000 * settings.scale, result);
+			else if (name == "emi_batch")
+				result.success = runEmiBatchBenchmark(settings, result);
+			else if (name == "timeseries")
+				result.success = runTimeSeriesBenchmark(settings, false, result);
+			else if (name == "timeseries_append")
+				result.success = runTimeSeriesBenchmark(settings, true, result);
+			else
+				result.success = runBuildingsBenchmark(settings, result);
+
+			if (result.success)
+				INFO ("  %f s", result.seconds);
+			else
+				ERR ("Benchmark \'%s\' failed.", name.c_str());
+		}
+
+	bool const success (writeResults(output_arg.getValue(), settings, results) &&
+		std::all_of(results.cbegin(), results.cend(), [](BenchmarkResult const& r) { return r.success; }));
+	if (success)
+		INFO ("Results written to %s.", output_arg.getValue().c_str());
+
+	delete custom_format;
+	delete logog_cout;
+	LOGOG_SHUTDOWN();
+
+	return success ? 0 : 1;
+}
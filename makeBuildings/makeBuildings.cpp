@@ -12,66 +12,214 @@
  */
 
 #include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+#include <map>
 #include <memory>
+#include <set>
+#include <string>
 #include <vector>
 
 #include <tclap/CmdLine.h>
 #include "Applications/ApplicationsLib/LogogSetup.h"
 
+#include "BaseLib/FileTools.h"
+#include "BaseLib/StringTools.h"
+
 #include "GeoLib/GEOObjects.h"
 #include "GeoLib/Triangle.h"
 #include "GeoLib/IO/XmlIO/Qt/XmlGmlInterface.h"
 
+#include "ToolsLib/BuildingExtrusion.h"
+#include "ToolsLib/GmlStream.h"
+#include "ToolsLib/ParallelFor.h"
+#include "ToolsLib/PhaseTimer.h"
+#include "ToolsLib/TriangleMesh.h"
+
 #include <QCoreApplication>
 
 
 std::unique_ptr<std::vector<GeoLib::Polyline*>> copyPolylinesVector(
 	std::vector<GeoLib::Polyline*> const& polylines,
-	std::vector<GeoLib::Point*> const& points)
+	std::vector<GeoLib::Point*> const& points,
+	unsigned n_threads = 1)
 {
 	std::size_t n_plys = polylines.size();
 	std::unique_ptr<std::vector<GeoLib::Polyline*>> new_lines (new std::vector<GeoLib::Polyline*>(n_plys, nullptr));
 
-	for (std::size_t i=0; i<n_plys; ++i)
-	{
-		if (polylines[i] == nullptr)
-			continue;
-		(*new_lines)[i] = new GeoLib::Polyline(points);
-		std::size_t nLinePnts (polylines[i]->getNumberOfPoints());
-		for (std::size_t j=0; j<nLinePnts; ++j)
-			(*new_lines)[i]->addPoint(polylines[i]->getPointID(j));
-	}
+	ToolsLib::parallelFor(n_plys, n_threads,
+		[&](std::size_t begin, std::size_t end, unsigned)
+		{
+			for (std::size_t i=begin; i<end; ++i)
+			{
+				if (polylines[i] == nullptr)
+					continue;
+				(*new_lines)[i] = new GeoLib::Polyline(points);
+				std::size_t nLinePnts (polylines[i]->getNumberOfPoints());
+				for (std::size_t j=0; j<nLinePnts; ++j)
+					(*new_lines)[i]->addPoint(polylines[i]->getPointID(j));
+			}
+		});
 	return new_lines;
 }
 
 std::unique_ptr<std::vector<GeoLib::Surface*>> copySurfacesVector(
 	std::vector<GeoLib::Surface*> const& surfaces,
-	std::vector<GeoLib::Point*> const& points)
+	std::vector<GeoLib::Point*> const& points,
+	unsigned n_threads = 1)
 {
 	std::size_t n_sfc = surfaces.size();
 	std::unique_ptr<std::vector<GeoLib::Surface*>> new_surfaces (new std::vector<GeoLib::Surface*>(n_sfc, nullptr));
 
-	for (std::size_t i=0; i<n_sfc; ++i)
+	ToolsLib::parallelFor(n_sfc, n_threads,
+		[&](std::size_t begin, std::size_t end, unsigned)
+		{
+			for (std::size_t i=begin; i<end; ++i)
+			{
+				if (surfaces[i] == nullptr)
+					continue;
+				(*new_surfaces)[i] = new GeoLib::Surface(points);
+
+				std::size_t n_tris (surfaces[i]->getNTriangles());
+				for (std::size_t j=0; j<n_tris; ++j)
+				{
+					GeoLib::Triangle const* t = (*surfaces[i])[j];
+					(*new_surfaces)[i]->addTriangle(t->getPoint(0)->getID(), t->getPoint(1)->getID(), t->getPoint(2)->getID());
+				}
+			}
+		});
+	return new_surfaces;
+}
+
+/// Returns the polylines of the geometry, an empty vector if it has none.
+std::vector<GeoLib::Polyline*> const& getPolylines(GeoLib::GEOObjects const& geo_objects, std::string const& geo_name)
+{
+	static std::vector<GeoLib::Polyline*> const no_polylines;
+	std::vector<GeoLib::Polyline*> const* plys (geo_objects.getPolylineVec(geo_name));
+	return (plys == nullptr) ? no_polylines : *plys;
+}
+
+/// Returns the surfaces of the geometry, an empty vector if it has none.
+std::vector<GeoLib::Surface*> const& getSurfaces(GeoLib::GEOObjects const& geo_objects, std::string const& geo_name)
+{
+	static std::vector<GeoLib::Surface*> const no_surfaces;
+	std::vector<GeoLib::Surface*> const* sfcs (geo_objects.getSurfaceVec(geo_name));
+	return (sfcs == nullptr) ? no_surfaces : *sfcs;
+}
+
+/// Reads building heights from a CSV file with lines "<name>,<height>" where
+/// name refers to a polyline or surface. Lines without a valid height (e.g.
+/// a header) are skipped.
+bool readHeights(std::string const& file_name, std::map<std::string, double> &heights)
+{
+	std::ifstream in(file_name.c_str());
+	if (!in.is_open())
 	{
-		if (surfaces[i] == nullptr)
-			continue;
-		(*new_surfaces)[i] = new GeoLib::Surface(points);
+		ERR ("Could not open height file %s.", file_name.c_str());
+		return false;
+	}
 
-		std::size_t n_tris (surfaces[i]->getNTriangles());
-		for (std::size_t j=0; j<n_tris; ++j)
+	std::string line;
+	while (std::getline(in, line))
+	{
+		std::vector<std::string> fields;
+		for (std::string field : BaseLib::splitString(line, ','))
 		{
-			GeoLib::Triangle const* t = (*surfaces[i])[j];
-			(*new_surfaces)[i]->addTriangle(t->getPoint(0)->getID(), t->getPoint(1)->getID(), t->getPoint(2)->getID());
+			BaseLib::trim(field);
+			fields.push_back(field);
 		}
+		if (fields.size() < 2 || fields[0].empty() || fields[1].empty())
+			continue;
+		char* end (nullptr);
+		double const height (std::strtod(fields[1].c_str(), &end));
+		if (*end != '\0')
+			continue;
+		heights[fields[0]] = height;
 	}
-	return new_surfaces;
+	INFO ("Read %d building heights from %s.", heights.size(), file_name.c_str());
+	return true;
 }
 
-void makeBuildings(GeoLib::GEOObjects &geo_objects, std::string const& geo_name, std::string &output_name, double height)
+/// Extrusion heights of the polylines and surfaces of a geometry together
+/// with the extruded points they need.
+struct BuildingHeights
+{
+	std::vector<double> polylines;
+	std::vector<double> surfaces;
+	ToolsLib::ExtrudedPoints points;
+};
+
+/**
+ * Returns the extrusion heights of the geometry. Each polyline and surface
+ * has the height given for its name or the default height. A point gets an
+ * extruded copy at the maximum height of all objects it belongs to and an
+ * additional copy for each lower height, points not used by any object get
+ * the default height.
+ */
+BuildingHeights getBuildingHeights(GeoLib::GEOObjects const& geo_objects, std::string const& geo_name,
+                                   std::map<std::string, double> const& heights, double default_height)
+{
+	BuildingHeights building_heights;
+	building_heights.points = ToolsLib::ExtrudedPoints(geo_objects.getPointVec(geo_name)->size());
+	std::size_t n_named (0);
+	auto const getHeight = [&](bool has_name, std::string const& name)
+	{
+		if (!has_name)
+			return default_height;
+		auto const it (heights.find(name));
+		if (it == heights.end())
+			return default_height;
+		n_named++;
+		return it->second;
+	};
+
+	std::string name;
+	GeoLib::PolylineVec const* ply_vec (geo_objects.getPolylineVecObj(geo_name));
+	std::vector<GeoLib::Polyline*> const& plys (getPolylines(geo_objects, geo_name));
+	building_heights.polylines.resize(plys.size(), default_height);
+	for (std::size_t i=0; i<plys.size(); ++i)
+	{
+		if (plys[i] == nullptr)
+			continue;
+		double const height (getHeight(ply_vec->getNameOfElementByID(i, name), name));
+		building_heights.polylines[i] = height;
+		std::size_t const np (plys[i]->getNumberOfPoints());
+		for (std::size_t j=0; j<np; ++j)
+			building_heights.points.add(plys[i]->getPointID(j), height);
+	}
+
+	GeoLib::SurfaceVec const* sfc_vec (geo_objects.getSurfaceVecObj(geo_name));
+	std::vector<GeoLib::Surface*> const& sfcs (getSurfaces(geo_objects, geo_name));
+	building_heights.surfaces.resize(sfcs.size(), default_height);
+	for (std::size_t i=0; i<sfcs.size(); ++i)
+	{
+		if (sfcs[i] == nullptr)
+			continue;
+		double const height (getHeight(sfc_vec->getNameOfElementByID(i, name), name));
+		building_heights.surfaces[i] = height;
+		std::size_t const n_tris (sfcs[i]->getNTriangles());
+		for (std::size_t j=0; j<n_tris; ++j)
+			for (std::size_t k=0; k<3; ++k)
+				building_heights.points.add((*sfcs[i])[j]->getPoint(k)->getID(), height);
+	}
+
+	building_heights.points.finalize(default_height);
+	if (!heights.empty())
+		INFO ("%s: %d objects with individual height.", geo_name.c_str(), n_named);
+	if (!building_heights.points.getAdditionalCopies().empty())
+		INFO ("%s: %d additional extruded points for buildings sharing points with higher ones.",
+		      geo_name.c_str(), building_heights.points.getAdditionalCopies().size());
+	return building_heights;
+}
+
+void makeBuildings(GeoLib::GEOObjects &geo_objects, std::string const& geo_name, std::string &output_name,
+                   BuildingHeights const& heights)
 {
 	std::vector<GeoLib::Point*> const* pnts (geo_objects.getPointVec(geo_name));
-	std::vector<GeoLib::Polyline*> const* plys (geo_objects.getPolylineVec(geo_name));
-	std::vector<GeoLib::Surface*> const* sfcs (geo_objects.getSurfaceVec(geo_name));
+	std::vector<GeoLib::Polyline*> const* plys (&getPolylines(geo_objects, geo_name));
+	std::vector<GeoLib::Surface*> const* sfcs (&getSurfaces(geo_objects, geo_name));
 	std::size_t const n_pnts (pnts->size());
 	std::size_t const n_plys (plys->size());
 	std::size_t const n_sfcs (sfcs->size());
@@ -84,24 +232,33 @@ void makeBuildings(GeoLib::GEOObjects &geo_objects, std::string const& geo_name,
 	std::unique_ptr< std::vector<GeoLib::Polyline*> > new_plys = copyPolylinesVector(*plys, *new_pnts);
 	std::unique_ptr< std::vector<GeoLib::Surface*> > new_sfcs = copySurfacesVector(*sfcs, *new_pnts);
 
-	for (GeoLib::Point* point : *pnts)
+	for (std::size_t i=0; i<n_pnts; ++i)
 	{
+		GeoLib::Point const* const point ((*pnts)[i]);
 		if (point)
-			new_pnts->push_back(new GeoLib::Point((*point)[0], (*point)[1], (*point)[2]+height, point->getID()+n_pnts));
+			new_pnts->push_back(new GeoLib::Point((*point)[0], (*point)[1], (*point)[2]+heights.points.getHeight(i), point->getID()+n_pnts));
 		else
 			new_pnts->push_back(nullptr);
 	}
+	std::vector<std::pair<std::size_t, double>> const& additional (heights.points.getAdditionalCopies());
+	for (std::size_t k=0; k<additional.size(); ++k)
+	{
+		GeoLib::Point const& point (*(*pnts)[additional[k].first]);
+		new_pnts->push_back(new GeoLib::Point(point[0], point[1], point[2]+additional[k].second, 2*n_pnts + k));
+	}
 
-	for (GeoLib::Polyline* p : *plys)
+	for (std::size_t j=0; j<n_plys; ++j)
 	{
+		GeoLib::Polyline const* p ((*plys)[j]);
 		if (p == nullptr)
 			continue;
+		auto const top = [&](std::size_t id) { return n_pnts + heights.points.getIndex(id, heights.polylines[j]); };
 		std::size_t const np (p->getNumberOfPoints());
 		GeoLib::Surface* s = new GeoLib::Surface(*new_pnts);
 		for (std::size_t i=1; i<np; ++i)
 		{
-			s->addTriangle(p->getPoint(i)->getID(), p->getPoint(i-1)->getID(), p->getPoint(i-1)->getID()+n_pnts);
-			s->addTriangle(p->getPoint(i)->getID(), p->getPoint(i-1)->getID()+n_pnts, p->getPoint(i)->getID()+n_pnts);
+			s->addTriangle(p->getPoint(i)->getID(), p->getPoint(i-1)->getID(), top(p->getPoint(i-1)->getID()));
+			s->addTriangle(p->getPoint(i)->getID(), top(p->getPoint(i-1)->getID()), top(p->getPoint(i)->getID()));
 		}
 		new_sfcs->push_back(s);
 	}
@@ -110,12 +267,13 @@ void makeBuildings(GeoLib::GEOObjects &geo_objects, std::string const& geo_name,
 	{
 		if ((*sfcs)[j] == nullptr)
 			continue;
+		auto const top = [&](std::size_t id) { return n_pnts + heights.points.getIndex(id, heights.surfaces[j]); };
 		std::size_t const n_tris ((*sfcs)[j]->getNTriangles());
 		GeoLib::Surface* s = new GeoLib::Surface(*new_pnts);
 		for (std::size_t i = 0; i<n_tris; i++)
 		{
 			GeoLib::Triangle const* t = (*(*sfcs)[j])[i];
-			s->addTriangle(t->getPoint(0)->getID()+n_pnts, t->getPoint(1)->getID()+n_pnts, t->getPoint(2)->getID()+n_pnts);
+			s->addTriangle(top(t->getPoint(0)->getID()), top(t->getPoint(1)->getID()), top(t->getPoint(2)->getID()));
 		}
 		new_sfcs->push_back(s);
 	}
@@ -125,45 +283,420 @@ void makeBuildings(GeoLib::GEOObjects &geo_objects, std::string const& geo_name,
 	geo_objects.addSurfaceVec(std::move(new_sfcs), output_name);
 }
 
+/**
+ * Parallel version of makeBuildings() creating the same geometry. The
+ * positions of all output points and triangles are computed up front by
+ * prefix sums over the input, afterwards the threads fill preallocated
+ * arrays and never share a container they insert into.
+ */
+void makeBuildingsParallel(GeoLib::GEOObjects &geo_objects, std::string const& geo_name, std::string &output_name,
+                           BuildingHeights const& heights, unsigned n_threads)
+{
+	std::vector<GeoLib::Point*> const& pnts (*geo_objects.getPointVec(geo_name));
+	std::vector<GeoLib::Polyline*> const& plys (getPolylines(geo_objects, geo_name));
+	std::vector<GeoLib::Surface*> const& sfcs (getSurfaces(geo_objects, geo_name));
+	std::size_t const n_pnts (pnts.size());
+	std::size_t const n_plys (plys.size());
+	std::size_t const n_sfcs (sfcs.size());
+
+	// copies of the input points are stored without gaps, followed by the
+	// extruded points at their input position shifted by n_pnts and the
+	// additional extruded points of lower buildings
+	std::vector<std::size_t> pnt_offsets (n_pnts + 1, 0);
+	for (std::size_t i=0; i<n_pnts; ++i)
+		pnt_offsets[i+1] = pnt_offsets[i] + ((pnts[i] != nullptr) ? 1 : 0);
+	std::size_t const n_copies (pnt_offsets[n_pnts]);
+
+	std::vector<std::pair<std::size_t, double>> const& additional (heights.points.getAdditionalCopies());
+	std::unique_ptr< std::vector<GeoLib::Point*> > new_pnts (
+		new std::vector<GeoLib::Point*>(n_copies + n_pnts + additional.size(), nullptr));
+	ToolsLib::parallelFor(n_pnts, n_threads,
+		[&](std::size_t begin, std::size_t end, unsigned)
+		{
+			for (std::size_t i=begin; i<end; ++i)
+			{
+				GeoLib::Point const* const point (pnts[i]);
+				if (point == nullptr)
+					continue;
+				(*new_pnts)[pnt_offsets[i]] = new GeoLib::Point(*point);
+				(*new_pnts)[n_copies + i] = new GeoLib::Point((*point)[0], (*point)[1], (*point)[2]+heights.points.getHeight(i), point->getID()+n_pnts);
+			}
+		});
+	for (std::size_t k=0; k<additional.size(); ++k)
+	{
+		GeoLib::Point const& point (*pnts[additional[k].first]);
+		(*new_pnts)[n_copies + n_pnts + k] = new GeoLib::Point(point[0], point[1], point[2]+additional[k].second, 2*n_pnts + k);
+	}
+
+	std::unique_ptr< std::vector<GeoLib::Polyline*> > new_plys = copyPolylinesVector(plys, *new_pnts, n_threads);
+	std::unique_ptr< std::vector<GeoLib::Surface*> > new_sfcs = copySurfacesVector(sfcs, *new_pnts, n_threads);
+
+	// one wall surface per polyline followed by one roof surface per input
+	// surface, the triangles of new surface k are stored in the range
+	// [tri_offsets[k], tri_offsets[k+1])
+	std::vector<std::size_t> walls;
+	std::vector<std::size_t> roofs;
+	std::vector<std::size_t> tri_offsets (1, 0);
+	for (std::size_t i=0; i<n_plys; ++i)
+	{
+		if (plys[i] == nullptr)
+			continue;
+		std::size_t const np (plys[i]->getNumberOfPoints());
+		walls.push_back(i);
+		tri_offsets.push_back(tri_offsets.back() + ((np > 1) ? 2 * (np - 1) : 0));
+	}
+	for (std::size_t j=0; j<n_sfcs; ++j)
+	{
+		if (sfcs[j] == nullptr)
+			continue;
+		roofs.push_back(j);
+		tri_offsets.push_back(tri_offsets.back() + sfcs[j]->getNTriangles());
+	}
+	std::size_t const n_walls (walls.size());
+	std::size_t const n_new_sfcs (n_walls + roofs.size());
+
+	std::vector<std::array<std::size_t, 3>> triangles (tri_offsets.back());
+	ToolsLib::parallelFor(n_new_sfcs, n_threads,
+		[&](std::size_t begin, std::size_t end, unsigned)
+		{
+			for (std::size_t k=begin; k<end; ++k)
+			{
+				std::array<std::size_t, 3>* tri (triangles.data() + tri_offsets[k]);
+				if (k < n_walls)
+				{
+					GeoLib::Polyline const& p (*plys[walls[k]]);
+					double const height (heights.polylines[walls[k]]);
+					std::size_t const np (p.getNumberOfPoints());
+					for (std::size_t i=1; i<np; ++i)
+					{
+						std::size_t const a (p.getPoint(i)->getID());
+						std::size_t const b (p.getPoint(i-1)->getID());
+						std::size_t const a_top (n_pnts + heights.points.getIndex(a, height));
+						std::size_t const b_top (n_pnts + heights.points.getIndex(b, height));
+						*tri++ = {{ a, b, b_top }};
+						*tri++ = {{ a, b_top, a_top }};
+					}
+				}
+				else
+				{
+					GeoLib::Surface const& sfc (*sfcs[roofs[k-n_walls]]);
+					double const height (heights.surfaces[roofs[k-n_walls]]);
+					auto const top = [&](std::size_t id) { return n_pnts + heights.points.getIndex(id, height); };
+					std::size_t const n_tris (sfc.getNTriangles());
+					for (std::size_t i=0; i<n_tris; ++i)
+					{
+						GeoLib::Triangle const* t = sfc[i];
+						*tri++ = {{ top(t->getPoint(0)->getID()), top(t->getPoint(1)->getID()), top(t->getPoint(2)->getID()) }};
+					}
+				}
+			}
+		});
+
+	new_sfcs->resize(n_sfcs + n_new_sfcs, nullptr);
+	ToolsLib::parallelFor(n_new_sfcs, n_threads,
+		[&](std::size_t begin, std::size_t end, unsigned)
+		{
+			for (std::size_t k=begin; k<end; ++k)
+			{
+				GeoLib::Surface* s = new GeoLib::Surface(*new_pnts);
+				for (std::size_t t=tri_offsets[k]; t<tri_offsets[k+1]; ++t)
+					s->addTriangle(triangles[t][0], triangles[t][1], triangles[t][2]);
+				(*new_sfcs)[n_sfcs + k] = s;
+			}
+		});
+
+	geo_objects.addPointVec(std::move(new_pnts), output_name);
+	geo_objects.addPolylineVec(std::move(new_plys), output_name);
+	geo_objects.addSurfaceVec(std::move(new_sfcs), output_name);
+}
+
+/**
+ * Returns the output file name <output>_<suffix>.<extension> used if more
+ * than one geometry is processed. Names already in use get a number
+ * appended, i.e. no output file is overwritten by a later one.
+ */
+std::string getOutputFileName(std::string const& geo_out, std::string const& suffix, std::set<std::string> &used_names)
+{
+	std::string const extension (BaseLib::getFileExtension(geo_out));
+	std::string const base_name (BaseLib::dropFileExtension(geo_out) + "_" + suffix);
+	std::string const file_extension ("." + (extension.empty() ? std::string("gml") : extension));
+	std::string file_name (base_name + file_extension);
+	for (std::size_t i=2; !used_names.insert(file_name).second; ++i)
+		file_name = base_name + "_" + std::to_string(i) + file_extension;
+	return file_name;
+}
+
+/**
+ * Streaming version of makeBuildings() working directly on the files. The
+ * input is read three times (points and heights, then the copies of all
+ * objects, then walls and roofs) and every object is written as soon as it
+ * has been read, so only the point coordinates are kept in memory. The
+ * output contains the same objects in the same order as written by the
+ * in-memory version, names of polylines and surfaces are kept.
+ */
+bool streamBuildings(std::string const& input_file, std::string const& file_name, bool single_geometry,
+                     std::map<std::string, double> const& heights, double default_height,
+                     ToolsLib::PhaseTimer &timer)
+{
+	timer.start("parse");
+	ToolsLib::GmlReader const reader(input_file);
+	ToolsLib::StreamedPoints pnts;
+	if (!ToolsLib::readStreamedPoints(reader, heights, default_height, pnts))
+		return false;
+	std::size_t const file_size (ToolsLib::getFileSize(input_file));
+	timer.addBytesRead(file_size);
+	timer.stop(pnts.coords.size());
+	std::vector<std::pair<std::size_t, double>> const& additional (pnts.extruded.getAdditionalCopies());
+	if (!additional.empty())
+		INFO ("%s: %d additional extruded points for buildings sharing points with higher ones.",
+		      pnts.geo_name.c_str(), additional.size());
+
+	// objects are written while they are read, i.e. extrusion includes writing
+	timer.start("extrude");
+	std::string const output_name (single_geometry ? "output" : pnts.geo_name + "_buildings");
+	INFO ("Writing geometry %s.", file_name.c_str());
+	ToolsLib::GmlWriter writer(file_name, output_name);
+	if (!writer.isOpen())
+		return false;
+
+	std::size_t const n_pnts (pnts.coords.size());
+	for (std::array<double, 3> const& pnt : pnts.coords)
+		writer.addPoint(pnt[0], pnt[1], pnt[2]);
+	for (std::size_t i=0; i<n_pnts; ++i)
+		writer.addPoint(pnts.coords[i][0], pnts.coords[i][1], pnts.coords[i][2] + pnts.extruded.getHeight(i));
+	for (std::pair<std::size_t, double> const& copy : additional)
+		writer.addPoint(pnts.coords[copy.first][0], pnts.coords[copy.first][1], pnts.coords[copy.first][2] + copy.second);
+	std::vector<std::array<double, 3>>().swap(pnts.coords);
+
+	auto const getHeight = [&](std::string const& name)
+	{
+		auto const it (heights.find(name));
+		return (it == heights.end()) ? default_height : it->second;
+	};
+
+	std::vector<std::size_t> ids;
+	ToolsLib::GmlHandler copy_objects;
+	copy_objects.polyline = [&](ToolsLib::GmlObject const& object)
+	{
+		pnts.mapIds(object.point_ids, ids);
+		writer.addPolyline(object.name, ids);
+	};
+	copy_objects.surface = [&](ToolsLib::GmlObject const& object)
+	{
+		pnts.mapIds(object.point_ids, ids);
+		writer.addSurface(object.name, ids);
+	};
+	if (!reader.read(copy_objects))
+		return false;
+
+	std::size_t n_objects (0);
+	std::vector<std::size_t> triangles;
+	ToolsLib::GmlHandler extrude_objects;
+	extrude_objects.polyline = [&](ToolsLib::GmlObject const& object)
+	{
+		n_objects++;
+		pnts.mapIds(object.point_ids, ids);
+		double const height (getHeight(object.name));
+		triangles.clear();
+		for (std::size_t i=1; i<ids.size(); ++i)
+		{
+			std::size_t const a_top (n_pnts + pnts.extruded.getIndex(ids[i], height));
+			std::size_t const b_top (n_pnts + pnts.extruded.getIndex(ids[i-1], height));
+			triangles.insert(triangles.end(), { ids[i], ids[i-1], b_top });
+			triangles.insert(triangles.end(), { ids[i], b_top, a_top });
+		}
+		writer.addSurface("", triangles);
+	};
+	extrude_objects.surface = [&](ToolsLib::GmlObject const& object)
+	{
+		n_objects++;
+		pnts.mapIds(object.point_ids, ids);
+		double const height (getHeight(object.name));
+		for (std::size_t &id : ids)
+			id = n_pnts + pnts.extruded.getIndex(id, height);
+		writer.addSurface("", ids);
+	};
+	if (!reader.read(extrude_objects))
+		return false;
+	bool const is_closed (writer.close());
+	timer.addBytesRead(2 * file_size);
+	timer.addBytesWritten(ToolsLib::getFileSize(file_name));
+	timer.stop(n_objects);
+	return is_closed;
+}
+
+/**
+ * Creates the buildings of a geometry file as compact triangle mesh (see
+ * ToolsLib::makeCompactBuildings()) and writes it as *.ply or *.vtu file.
+ */
+bool writeCompactBuildings(std::string const& input_file, std::string const& file_name,
+                           std::map<std::string, double> const& heights, double default_height,
+                           ToolsLib::VtkAppendedData::Encoding encoding, unsigned n_threads,
+                           ToolsLib::PhaseTimer &timer)
+{
+	ToolsLib::TriangleMesh mesh;
+	if (!ToolsLib::makeCompactBuildings(input_file, heights, default_height, mesh, timer))
+		return false;
+
+	INFO ("Writing mesh %s.", file_name.c_str());
+	timer.start("write");
+	bool const is_written (BaseLib::hasFileExtension("ply", file_name) ?
+		ToolsLib::writeTriangleMeshPly(mesh, file_name, "BuildingIDs") :
+		ToolsLib::writeTriangleMeshVtu(mesh, file_name, "BuildingIDs", encoding, n_threads));
+	timer.addBytesWritten(ToolsLib::getFileSize(file_name));
+	timer.stop(mesh.getNumberOfTriangles());
+	return is_written;
+}
+
 int main (int argc, char* argv[])
 {
 	QCoreApplication app(argc, argv);
 	ApplicationsLib::LogogSetup logog_setup;
+	ToolsLib::PhaseTimer timer;
 
 	TCLAP::CmdLine cmd("Uses polygons from building plans to create 3d objects.", ' ', "0.1");
 
-	TCLAP::ValueArg<double> height ("s", "size", "height of the 3d objects (buildings) in metres", true,
+	TCLAP::ValueArg<double> height ("s", "size", "default height of the 3d objects (buildings) in metres", false,
 	                                1.0, "height of objects");
 	cmd.add(height);
+	TCLAP::ValueArg<std::string> heights_arg("", "heights",
+	                                         "CSV-file with lines \'<name>,<height>\' giving the height of individual buildings by the name of their polyline or surface. Unnamed or unlisted buildings get the default height.",
+	                                         false, "", "file name of building heights");
+	cmd.add(heights_arg);
 	TCLAP::ValueArg<std::string> geo_out("o", "geo-output-file",
-	                                     "the name of the file the 3d geometry will be written to", true,
+	                                     "the name of the file the 3d geometry will be written to. For *.vtu and *.ply files a compact triangle mesh containing only the used vertices and a BuildingIDs array is written instead of a geometry. If more than one geometry is processed, each is written to <name>_<input>.<extension> named after its input file (followed by the geometry name if a file contains several geometries).", true,
 	                                     "", "file name of output geometry");
 	cmd.add(geo_out);
-	TCLAP::ValueArg<std::string> geo_in("i", "geo-input-file",
-	                                    "the name of the file containing the input geometry", true,
-	                                    "", "file name of input geometry");
+	TCLAP::MultiArg<std::string> geo_in("i", "geo-input-file",
+	                                    "the name of a file containing input geometry, can be given multiple times. All geometries are processed.", true,
+	                                    "file name of input geometry");
 	cmd.add(geo_in);
+	TCLAP::ValueArg<unsigned> threads_arg("p", "threads",
+	                                      "Number of threads used for extruding the buildings, 0 uses all available cores. The result does not depend on the number of threads.",
+	                                      false, 1, "number of threads");
+	cmd.add(threads_arg);
+	TCLAP::SwitchArg stream_arg("", "stream",
+	                            "Process the geometry while reading it instead of loading it completely. Uses far less memory for large inputs, polyline and surface names are kept in the output. The number of threads is ignored.");
+	cmd.add(stream_arg);
+	TCLAP::SwitchArg zlib_arg("z", "zlib",
+	                          "Compress the data of compact *.vtu output.");
+	cmd.add(zlib_arg);
+	TCLAP::ValueArg<std::string> profile_arg("", "profile",
+	                                         "Write wall time, peak memory, I/O volume and throughput of the phases parse, extrude and write to the given JSON file at the end of a successful run. With --stream writing is part of the extrusion.",
+	                                         false, "", "file name of profile");
+	cmd.add(profile_arg);
 
 	cmd.parse(argc, argv);
+	unsigned const n_threads (ToolsLib::getNumberOfThreads(threads_arg.getValue()));
+	auto const writeProfile = [&]()
+	{
+		if (profile_arg.isSet())
+			ToolsLib::writeProfile(profile_arg.getValue(), "makeBuildings", timer);
+	};
+
+	std::map<std::string, double> heights;
+	if (heights_arg.isSet() && !readHeights(heights_arg.getValue(), heights))
+		return 1;
+
+	std::vector<std::string> const& input_files (geo_in.getValue());
+	// outputs are named after the input files, numbered if names repeat
+	std::set<std::string> output_files;
+	auto const getOutputFile = [&](std::string const& input_file, std::string const& suffix) -> std::string
+	{
+		if (input_files.size() == 1 && suffix.empty())
+			return geo_out.getValue();
+		std::string const input_name (BaseLib::extractBaseNameWithoutExtension(input_file));
+		return getOutputFileName(geo_out.getValue(), suffix.empty() ? input_name : input_name + "_" + suffix, output_files);
+	};
+	if (BaseLib::hasFileExtension("vtu", geo_out.getValue()) || BaseLib::hasFileExtension("ply", geo_out.getValue()))
+	{
+		ToolsLib::VtkAppendedData::Encoding const encoding (zlib_arg.getValue() ?
+			ToolsLib::VtkAppendedData::Encoding::Zlib : ToolsLib::VtkAppendedData::Encoding::Raw);
+		for (std::string const& input_file : input_files)
+		{
+			INFO ("Reading geometry %s.", input_file.c_str());
+			if (!writeCompactBuildings(input_file, getOutputFile(input_file, ""), heights,
+			                           height.getValue(), encoding, n_threads, timer))
+			{
+				ERR ("Error processing geometry %s.", input_file.c_str());
+				return 1;
+			}
+		}
+		writeProfile();
+		return 0;
+	}
 
-	INFO ("Reading geometry %s.", geo_in.getValue().c_str());
+	if (stream_arg.getValue())
+	{
+		for (std::string const& input_file : input_files)
+		{
+			INFO ("Reading geometry %s.", input_file.c_str());
+			if (!streamBuildings(input_file, getOutputFile(input_file, ""), input_files.size() == 1, heights,
+			                     height.getValue(), timer))
+			{
+				ERR ("Error processing geometry %s.", input_file.c_str());
+				return 1;
+			}
+		}
+		writeProfile();
+		return 0;
+	}
 
 	GeoLib::GEOObjects geo_objects;
 	GeoLib::IO::XmlGmlInterface xml(geo_objects);
-	if (!xml.readFile(geo_in.getValue()))
+	for (std::string const& input_file : input_files)
 	{
-		ERR ("Error reading geometry.")
-		return 1;
-	}
-	std::vector<std::string> geo_names;
-	geo_objects.getGeometryNames(geo_names);
-	std::string output_name ("output");
+		INFO ("Reading geometry %s.", input_file.c_str());
+		timer.start("parse");
+		if (!xml.readFile(input_file))
+		{
+			ERR ("Error reading geometry.")
+			return 1;
+		}
+		timer.addBytesRead(ToolsLib::getFileSize(input_file));
+		timer.stop();
+
+		// geometries are removed once written, i.e. all names are from the current file
+		std::vector<std::string> geo_names;
+		geo_objects.getGeometryNames(geo_names);
+		bool const single_geometry (input_files.size() == 1 && geo_names.size() == 1);
+		for (std::string const& geo_name : geo_names)
+		{
+			if (geo_objects.getPointVec(geo_name) == nullptr ||
+			    (getPolylines(geo_objects, geo_name).empty() && getSurfaces(geo_objects, geo_name).empty()))
+			{
+				WARN ("Geometry %s contains no polylines or surfaces, skipping.", geo_name.c_str());
+				geo_objects.removeSurfaceVec(geo_name);
+				geo_objects.removePolylineVec(geo_name);
+				geo_objects.removePointVec(geo_name);
+				continue;
+			}
+			std::string output_name (single_geometry ? "output" : geo_name + "_buildings");
+			timer.start("extrude");
+			BuildingHeights const building_heights (getBuildingHeights(geo_objects, geo_name, heights, height.getValue()));
+			if (n_threads > 1)
+				makeBuildingsParallel(geo_objects, geo_name, output_name, building_heights, n_threads);
+			else
+				makeBuildings(geo_objects, geo_name, output_name, building_heights);
+			timer.stop(building_heights.points.size());
 
-	makeBuildings(geo_objects, geo_names[0], output_name, height.getValue());
+			std::string const file_name (getOutputFile(input_file, (geo_names.size() > 1) ? geo_name : ""));
+			INFO ("Writing geometry %s.", file_name.c_str());
+			timer.start("write");
+			xml.setNameForExport(output_name);
+			xml.writeToFile(file_name);
+			timer.addBytesWritten(ToolsLib::getFileSize(file_name));
+			timer.stop();
 
-	xml.setNameForExport(output_name);
-	xml.writeToFile(geo_out.getValue());
+			for (std::string const& name : { output_name, geo_name })
+			{
+				geo_objects.removeSurfaceVec(name);
+				geo_objects.removePolylineVec(name);
+				geo_objects.removePointVec(name);
+			}
+		}
+	}
 
+	writeProfile();
 	return 0;
 }
-